@@ -0,0 +1,160 @@
+/** spawning entities from compiled blueprints vs. parsing their JSON ********
+ *                                                                           *
+ * Copyright (c) 2016 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#include "benchmark.hpp"
+
+#include <core/asset/asset_manager.hpp>
+#include <core/ecs/ecs.hpp>
+#include <core/ecs/serializer.hpp>
+#include <core/utils/sf2_glm.hpp>
+#include <core/utils/thread_pool.hpp>
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include <sstream>
+
+using namespace lux;
+
+namespace {
+	// modeled after the components of the blood blueprints, but without any assets or GL resources
+	struct Position_comp : ecs::Component<Position_comp> {
+		static constexpr const char* name() {return "Bench_position";}
+		using Component::Component;
+
+		glm::vec3 position;
+		float rotation = 0.f;
+
+		friend void load_component(ecs::Deserializer& state, Position_comp& comp) {
+			state.read_virtual(sf2::vmember("position", comp.position),
+			                   sf2::vmember("rotation", comp.rotation));
+		}
+		friend void save_component(ecs::Serializer& state, const Position_comp& comp) {
+			state.write_virtual(sf2::vmember("position", comp.position),
+			                    sf2::vmember("rotation", comp.rotation));
+		}
+	};
+	struct Bounds_comp : ecs::Component<Bounds_comp> {
+		static constexpr const char* name() {return "Bench_bounds";}
+		using Component::Component;
+
+		glm::vec3 bounds;
+
+		friend void load_component(ecs::Deserializer& state, Bounds_comp& comp) {
+			state.read_virtual(sf2::vmember("bounds", comp.bounds));
+		}
+		friend void save_component(ecs::Serializer& state, const Bounds_comp& comp) {
+			state.write_virtual(sf2::vmember("bounds", comp.bounds));
+		}
+	};
+	struct Decal_comp : ecs::Component<Decal_comp> {
+		static constexpr const char* name() {return "Bench_decal";}
+		using Component::Component;
+
+		glm::vec2 size;
+		std::string texture;
+
+		friend void load_component(ecs::Deserializer& state, Decal_comp& comp) {
+			state.read_virtual(sf2::vmember("size", comp.size),
+			                   sf2::vmember("texture", comp.texture));
+		}
+		friend void save_component(ecs::Serializer& state, const Decal_comp& comp) {
+			state.write_virtual(sf2::vmember("size", comp.size),
+			                    sf2::vmember("texture", comp.texture));
+		}
+	};
+	struct Paint_comp : ecs::Component<Paint_comp> {
+		static constexpr const char* name() {return "Bench_paint";}
+		using Component::Component;
+
+		float radius = 0.f;
+		std::string color;
+
+		friend void load_component(ecs::Deserializer& state, Paint_comp& comp) {
+			state.read_virtual(sf2::vmember("radius", comp.radius),
+			                   sf2::vmember("color", comp.color));
+		}
+		friend void save_component(ecs::Serializer& state, const Paint_comp& comp) {
+			state.write_virtual(sf2::vmember("radius", comp.radius),
+			                    sf2::vmember("color", comp.color));
+		}
+	};
+
+	// same structure as blood.json and blood_red.json; written to the write dir
+	const auto base_name = std::string("bench_blood.json");
+	const auto base_content = std::string(R"({
+		"Bench_position": {},
+		"Bench_bounds": {"bounds": {"x":4, "y":4, "z":1}},
+		"Bench_decal": {"size": {"x":4.0, "y":4.0}, "texture": "tex:blood_stain_white"},
+		"Bench_paint": {"radius": 1.75, "color": "white"}
+	})");
+	const auto child_name = std::string("bench_blood_red.json");
+	const auto child_content = R"({
+		"$import": ")" + base_name + R"(",
+		"Bench_decal": {"texture": "tex:blood_stain_red"},
+		"Bench_paint": {"color": "red"}
+	})";
+
+	void create_blueprints(asset::Asset_manager& assets) {
+		for(auto& b : {std::make_pair(base_name, base_content), std::make_pair(child_name, child_content)}) {
+			auto out = asset::ostream{asset::AID{"blueprint"_strid, b.first}, assets, b.first};
+			out<<b.second;
+		}
+	}
+
+	struct Scene {
+		util::Thread_pool thread_pool {0};
+		ecs::Entity_manager manager;
+
+		Scene(asset::Asset_manager& assets) : manager(thread_pool, &assets) {
+			manager.register_component_type<Position_comp>();
+			manager.register_component_type<Bounds_comp>();
+			manager.register_component_type<Decal_comp>();
+			manager.register_component_type<Paint_comp>();
+		}
+	};
+
+	void run(asset::Asset_manager& assets, const std::string& name, int count) {
+		Scene scene{assets};
+		auto clear = [&]{scene.manager.clear();};
+
+		// the previous implementation: the JSON of the whole $import chain is parsed for every entity
+		bench::report(name+" JSON", bench::measure(clear, [&] {
+			for(auto i=0; i<count; i++) {
+				auto handle = scene.manager.emplace().handle();
+				for(auto& content : {base_content, child_content}) {
+					auto stream = std::istringstream{content};
+					auto deserializer = ecs::Deserializer{child_name, stream, scene.manager, assets};
+					deserializer.read_value(handle);
+				}
+			}
+			scene.manager.process_queued_actions();
+		}));
+
+		bench::report(name+" emplace(blueprint)", bench::measure(clear, [&] {
+			for(auto i=0; i<count; i++) {
+				scene.manager.emplace(child_name);
+			}
+			scene.manager.process_queued_actions();
+		}));
+
+		bench::report(name+" emplace_bulk(blueprint)", bench::measure(clear, [&] {
+			scene.manager.emplace_bulk(static_cast<std::size_t>(count), child_name);
+			scene.manager.process_queued_actions();
+		}));
+	}
+}
+
+int main(int argc, char** argv) {
+	// requires the archives.lst of the asset directory, i.e. has to be run from /assets
+	asset::Asset_manager assets{argc>0 ? argv[0] : "", "BanishedBlaze_bench"};
+	create_blueprints(assets);
+
+	run(assets, "100 entities:", 100);
+	run(assets, "1k entities:", 1000);
+	run(assets, "10k entities:", 10000);
+}
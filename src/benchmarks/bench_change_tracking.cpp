@@ -0,0 +1,120 @@
+/** finding the changed transforms: for_each_changed vs. full scan ************
+ *                                                                           *
+ * Copyright (c) 2016 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#include "benchmark.hpp"
+
+#include <game/sys/physics/transform_comp.hpp>
+
+#include <core/ecs/ecs.hpp>
+#include <core/utils/thread_pool.hpp>
+
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace lux;
+using namespace lux::sys::physics;
+using namespace lux::unit_literals;
+
+namespace {
+	constexpr auto entity_count = 10000;
+
+	struct Scene {
+		util::Thread_pool thread_pool {0};
+		ecs::Entity_manager ecs {thread_pool};
+		Transform_comp::Pool& transforms;
+		std::vector<ecs::Entity_facet> entities;
+		std::mt19937 rng {42};
+
+		// the last seen revision of each transform (the state kept by the systems for the scan)
+		std::unordered_map<ecs::Entity_id, uint_fast32_t> revisions;
+
+		Scene() : transforms(ecs.list<Transform_comp>()) {
+			for(auto i=0; i<entity_count; i++) {
+				entities.push_back(ecs.emplace());
+				entities.back().emplace<Transform_comp>();
+			}
+			ecs.process_queued_actions();
+
+			for(auto& transform : transforms) {
+				revisions[transform.owner_handle().id()] = transform.revision();
+			}
+			ecs.next_change_frame();
+		}
+
+		// starts a new frame and moves the given number of random entities
+		void change(int count) {
+			ecs.next_change_frame();
+
+			auto entity = std::uniform_int_distribution<std::size_t>(0, entities.size()-1);
+			for(auto i=0; i<count; i++) {
+				entities[entity(rng)].get<Transform_comp>().process([](auto& transform) {
+					transform.move(Position{1_m, 0_m, 0_m});
+				});
+			}
+		}
+
+		auto scan() {
+			auto found = 0;
+			for(auto& transform : transforms) {
+				auto& revision = revisions[transform.owner_handle().id()];
+				if(transform.changed_since(revision)) {
+					revision = transform.revision();
+					found++;
+				}
+			}
+			return found;
+		}
+
+		// scan of the revisions, ignoring the cost of the lookup of the last seen revision
+		auto scan_revisions_only(std::vector<uint_fast32_t>& last) {
+			auto found = 0;
+			auto i = std::size_t(0);
+			for(auto& transform : transforms) {
+				if(transform.changed_since(last[i])) {
+					last[i] = transform.revision();
+					found++;
+				}
+				i++;
+			}
+			return found;
+		}
+
+		auto changed() {
+			auto found = 0;
+			transforms.for_each_changed(ecs.change_frame(), [&](auto&) {found++;});
+			return found;
+		}
+	};
+
+	void run(const std::string& name, int changed_count) {
+		Scene scene;
+		auto change = [&]{scene.change(changed_count);};
+
+		bench::report(name+" full scan (changed_since)", bench::measure(change, [&] {
+			bench::do_not_optimize(scene.scan());
+		}));
+
+		auto last = std::vector<uint_fast32_t>();
+		for(auto& transform : scene.transforms) {
+			last.push_back(transform.revision());
+		}
+		bench::report(name+" full scan (changed_since, no lookup)", bench::measure(change, [&] {
+			bench::do_not_optimize(scene.scan_revisions_only(last));
+		}));
+
+		bench::report(name+" for_each_changed", bench::measure(change, [&] {
+			bench::do_not_optimize(scene.changed());
+		}));
+	}
+}
+
+int main() {
+	// 10k transforms
+	run("1% changed:", entity_count/100);
+	run("10% changed:", entity_count/10);
+}
@@ -0,0 +1,125 @@
+/** recording deferred ECS operations from multiple threads *****************
+ *                                                                           *
+ * Copyright (c) 2016 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#include "benchmark.hpp"
+
+#include <core/ecs/ecs.hpp>
+#include <core/utils/thread_pool.hpp>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace lux;
+
+namespace {
+	constexpr auto entity_count = 200000;
+
+	struct A_comp : ecs::Component<A_comp> {
+		static constexpr const char* name() {return "Bench_a";}
+		A_comp() = default;
+		A_comp(ecs::Entity_manager& manager, ecs::Entity_handle owner, int value=0)
+		    : Component(manager, owner), value(value) {}
+		int value = 0;
+	};
+	struct B_comp : ecs::Component<B_comp> {
+		static constexpr const char* name() {return "Bench_b";}
+		B_comp() = default;
+		B_comp(ecs::Entity_manager& manager, ecs::Entity_handle owner, float value=0.f)
+		    : Component(manager, owner), value(value) {}
+		float value = 0.f;
+	};
+
+	struct Scene {
+		util::Thread_pool thread_pool {0};
+		ecs::Entity_manager ecs {thread_pool};
+		std::vector<std::vector<ecs::Entity_handle>> entities; //< per thread
+
+		Scene(int threads) : entities(static_cast<std::size_t>(threads)) {
+			ecs.register_component_type<A_comp>();
+			ecs.register_component_type<B_comp>();
+
+			for(auto i=0; i<entity_count; i++) {
+				entities[static_cast<std::size_t>(i % threads)].push_back(ecs.emplace().handle());
+			}
+			ecs.process_queued_actions();
+		}
+
+		// calls f(entity) on one thread per entry of entities and waits for all of them
+		template<class F>
+		void record(F&& f) {
+			auto threads = std::vector<std::thread>();
+			for(auto& list : entities) {
+				threads.emplace_back([&] {
+					for(auto entity : list) {
+						f(entity);
+					}
+				});
+			}
+			for(auto& thread : threads) {
+				thread.join();
+			}
+		}
+
+		void record_emplace() {
+			record([&](auto entity) {
+				ecs.list<A_comp>().emplace([](auto&){}, entity, 1);
+				ecs.list<B_comp>().emplace([](auto&){}, entity, 2.f);
+			});
+		}
+		void record_erase() {
+			record([&](auto entity) {
+				ecs.list<A_comp>().erase(entity);
+				ecs.list<B_comp>().erase(entity);
+			});
+		}
+	};
+
+	void run(int threads) {
+		Scene scene{threads};
+		auto name = std::to_string(threads)+" threads:";
+
+		auto reset = [&] {
+			scene.ecs.process_queued_actions();
+			scene.record_erase();
+			scene.ecs.process_queued_actions();
+		};
+
+		bench::report(name+" emplace record", bench::measure(reset, [&] {
+			scene.record_emplace();
+		}));
+		bench::report(name+" emplace process", bench::measure([&] {
+			reset();
+			scene.record_emplace();
+		}, [&] {
+			scene.ecs.process_queued_actions();
+		}));
+		bench::report(name+" erase record", bench::measure([&] {
+			reset();
+			scene.record_emplace();
+			scene.ecs.process_queued_actions();
+		}, [&] {
+			scene.record_erase();
+		}));
+		bench::report(name+" erase process", bench::measure([&] {
+			reset();
+			scene.record_emplace();
+			scene.ecs.process_queued_actions();
+			scene.record_erase();
+		}, [&] {
+			scene.ecs.process_queued_actions();
+		}));
+	}
+}
+
+int main() {
+	// 2x200k component operations, recorded from 1 to N threads
+	auto max_threads = std::max(4, static_cast<int>(std::thread::hardware_concurrency()));
+	for(auto threads=1; threads<=max_threads; threads*=2) {
+		run(threads);
+	}
+}
@@ -0,0 +1,144 @@
+/** recording and flushing the Command_queue ********************************
+ *                                                                           *
+ * Copyright (c) 2016 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#include "benchmark.hpp"
+
+#include <core/asset/asset_manager.hpp>
+#include <core/renderer/command_queue.hpp>
+#include <core/renderer/graphics_ctx.hpp>
+#include <core/renderer/shader.hpp>
+#include <core/renderer/texture.hpp>
+#include <core/renderer/vertex_object.hpp>
+#include <core/utils/log.hpp>
+
+#include <SDL2/SDL.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace lux;
+using namespace lux::renderer;
+
+namespace {
+	constexpr auto shader_count = 8;
+	constexpr auto texture_count = 64;
+	constexpr auto object_count = 64;
+
+	struct Bench_vertex {
+		glm::vec2 position;
+	};
+	Vertex_layout bench_vertex_layout {
+		Vertex_layout::Mode::triangles,
+		vertex("position", &Bench_vertex::position)
+	};
+
+	// in place, because the attached shaders keep a pointer to the program
+	void build_program(Shader_program& program, int index) {
+		auto vert_source = std::string{
+			"#version 100\n"
+			"attribute vec2 position;\n"
+			"void main() {\n"
+			"	gl_Position = vec4(position, 0.0, 1.0);\n"
+			"}\n"};
+		auto frag_source = std::string{
+			"#version 100\n"
+			"precision mediump float;\n"
+			"uniform sampler2D albedo_tex;\n"
+			"void main() {\n"
+			"	gl_FragColor = texture2D(albedo_tex, vec2(0.5)) * "+std::to_string(index+1)+".0;\n"
+			"}\n"};
+
+		program.attach_shader(std::make_shared<Shader>(Shader_type::vertex, vert_source, "bench.vert"))
+		       .attach_shader(std::make_shared<Shader>(Shader_type::fragment, frag_source, "bench.frag"))
+		       .bind_all_attribute_locations(bench_vertex_layout)
+		       .build();
+	}
+
+	struct Resources {
+		std::vector<std::unique_ptr<Shader_program>> shaders;
+		std::vector<std::unique_ptr<Texture>> textures;
+		std::vector<Object> objects;
+
+		Resources() {
+			for(auto i=0; i<shader_count; i++) {
+				shaders.push_back(std::make_unique<Shader_program>());
+				build_program(*shaders.back(), i);
+			}
+
+			auto pixels = std::vector<uint8_t>(4*4*4, 255);
+			for(auto i=0; i<texture_count; i++) {
+				textures.push_back(std::make_unique<Texture>(4, 4, pixels.data(), RGBA));
+			}
+
+			auto quad = std::vector<Bench_vertex>{{{0,0}}, {{1,0}}, {{1,1}}, {{0,0}}, {{1,1}}, {{0,1}}};
+			for(auto i=0; i<object_count; i++) {
+				objects.emplace_back(bench_vertex_layout, create_buffer(quad));
+			}
+		}
+	};
+
+	// random state per command, a quarter of them translucent (i.e. without depth writes)
+	auto create_commands(Resources& resources, int count) -> std::vector<Command> {
+		auto rng = std::mt19937{42};
+		auto shader = std::uniform_int_distribution<std::size_t>(0, shader_count-1);
+		auto texture = std::uniform_int_distribution<std::size_t>(0, texture_count-1);
+		auto object = std::uniform_int_distribution<std::size_t>(0, object_count-1);
+		auto translucent = std::bernoulli_distribution(0.25);
+
+		auto commands = std::vector<Command>();
+		commands.reserve(static_cast<std::size_t>(count));
+		for(auto i=0; i<count; i++) {
+			auto cmd = create_command()
+			        .shader(*resources.shaders[shader(rng)])
+			        .texture(Texture_unit::color, *resources.textures[texture(rng)])
+			        .object(resources.objects[object(rng)]);
+			if(translucent(rng))
+				cmd.require_not(Gl_option::depth_write);
+
+			cmd.uniforms().emplace("albedo_tex", int(Texture_unit::color));
+			commands.push_back(cmd);
+		}
+		return commands;
+	}
+
+	void run(Resources& resources, const std::string& name, int count) {
+		auto commands = create_commands(resources, count);
+		Command_queue queue;
+
+		// includes the execution of the GL calls (state changes and draws into no framebuffer)
+		bench::report(name+" push_back+flush", bench::measure([&] {
+			for(auto& cmd : commands) {
+				queue.push_back(cmd);
+			}
+			queue.flush();
+		}));
+
+		// the step replaced by the radix sort of the keys
+		auto sorted = commands;
+		bench::report(name+" std::sort of the Commands", bench::measure([&]{sorted = commands;}, [&] {
+			std::sort(sorted.begin(), sorted.end());
+		}));
+	}
+}
+
+int main(int argc, char** argv) {
+	// requires the archives.lst of the asset directory, i.e. has to be run from /assets
+	asset::Asset_manager assets{argc>0 ? argv[0] : "", "BanishedBlaze_bench"};
+
+	INVARIANT(SDL_Init(SDL_INIT_VIDEO)==0, "Could not initialize SDL: "<<SDL_GetError());
+	{
+		Graphics_ctx graphics{"bench_command_queue", assets};
+		Resources resources;
+
+		run(resources, "500 commands:", 500);
+		run(resources, "5k commands:", 5000);
+		run(resources, "50k commands:", 50000);
+	}
+	SDL_Quit();
+}
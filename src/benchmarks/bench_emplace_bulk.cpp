@@ -0,0 +1,66 @@
+/** creating entities one by one vs. with Entity_manager::emplace_bulk *******
+ *                                                                           *
+ * Copyright (c) 2016 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#include "benchmark.hpp"
+
+#include <core/ecs/ecs.hpp>
+#include <core/utils/thread_pool.hpp>
+
+using namespace lux;
+
+namespace {
+	struct A_comp : ecs::Component<A_comp> {
+		static constexpr const char* name() {return "Bench_a";}
+		A_comp() = default;
+		A_comp(ecs::Entity_manager& manager, ecs::Entity_handle owner, int value=0)
+		    : Component(manager, owner), value(value) {}
+		int value = 0;
+	};
+	struct B_comp : ecs::Component<B_comp> {
+		static constexpr const char* name() {return "Bench_b";}
+		B_comp() = default;
+		B_comp(ecs::Entity_manager& manager, ecs::Entity_handle owner, float value=0.f)
+		    : Component(manager, owner), value(value) {}
+		float value = 0.f;
+	};
+
+	void run(const std::string& name, int count) {
+		util::Thread_pool thread_pool {0};
+		ecs::Entity_manager manager {thread_pool};
+		manager.register_component_type<A_comp>();
+		manager.register_component_type<B_comp>();
+
+		auto clear = [&]{manager.clear();};
+
+		bench::report(name+" emplace", bench::measure(clear, [&] {
+			for(auto i=0; i<count; i++) {
+				auto entity = manager.emplace();
+				entity.emplace<A_comp>(i);
+				entity.emplace<B_comp>(i*0.5f);
+			}
+			manager.process_queued_actions();
+		}));
+
+		bench::report(name+" emplace_bulk", bench::measure(clear, [&] {
+			auto batch = manager.emplace_bulk(static_cast<std::size_t>(count));
+			batch.emplace_init<A_comp>([](auto& comp, std::size_t i) {
+				comp.value = static_cast<int>(i);
+			});
+			batch.emplace_init<B_comp>([](auto& comp, std::size_t i) {
+				comp.value = i*0.5f;
+			});
+			manager.process_queued_actions();
+		}));
+	}
+}
+
+int main() {
+	// two components per entity, including the processing of the insertion queues
+	run("100 entities:", 100);
+	run("1k entities:", 1000);
+	run("10k entities:", 10000);
+}
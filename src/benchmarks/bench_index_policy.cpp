@@ -0,0 +1,92 @@
+/** lookup and modification costs of the component index policies ***********
+ *                                                                           *
+ * Copyright (c) 2016 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#include "benchmark.hpp"
+
+#include <core/ecs/component.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace lux;
+
+namespace {
+	// a component used by every fourth entity, i.e. the use case of the Flat_index_policy
+	constexpr auto id_range_factor = 4;
+
+	struct Workload {
+		std::vector<ecs::Entity_id> owners;  //< random subset of [0, id_range)
+		std::vector<ecs::Entity_id> lookups; //< all ids in random order (75% misses)
+
+		Workload(int count) {
+			auto rng = std::mt19937{42};
+			auto id_range = count * id_range_factor;
+
+			for(auto i=0; i<id_range; i++) {
+				lookups.push_back(static_cast<ecs::Entity_id>(i));
+			}
+			std::shuffle(lookups.begin(), lookups.end(), rng);
+			owners.assign(lookups.begin(), lookups.begin()+count);
+			std::shuffle(lookups.begin(), lookups.end(), rng);
+		}
+	};
+
+	template<class Index>
+	void run(const std::string& name, const Workload& workload) {
+		auto fill = [&](Index& index) {
+			auto comp = ecs::Component_index(0);
+			for(auto owner : workload.owners) {
+				index.attach(owner, comp++);
+			}
+		};
+
+		auto index = Index{};
+		bench::report(name+" attach", bench::measure([&]{index.clear();}, [&] {
+			fill(index);
+		}));
+
+		index.clear();
+		fill(index);
+		bench::report(name+" find", bench::measure([&] {
+			auto found = ecs::Component_index(0);
+			for(auto owner : workload.lookups) {
+				found += index.find(owner).get_or_other(0);
+			}
+			bench::do_not_optimize(found);
+		}));
+
+		// half of the components are removed and added again, e.g. by short lived effects
+		bench::report(name+" detach+attach", bench::measure([&] {
+			auto half = workload.owners.size()/2;
+			for(auto i=0ul; i<half; i++) {
+				index.detach(workload.owners[i]);
+			}
+			for(auto i=0ul; i<half; i++) {
+				index.attach(workload.owners[i], static_cast<ecs::Component_index>(i));
+			}
+		}));
+
+		std::cout<<std::left<<std::setw(48)<<(name+" memory")<<std::right
+		         <<std::setw(10)<<(index.memory_usage()/1024)<<" KiB"<<std::endl;
+	}
+
+	void run_all(const std::string& name, int count) {
+		auto workload = Workload{count};
+
+		run<ecs::Flat_index_policy>(name+" Flat", workload);
+		run<ecs::Sparse_index_policy>(name+" Sparse", workload);
+		run<ecs::Compact_index_policy>(name+" Compact", workload);
+		run<ecs::Paged_index_policy>(name+" Paged", workload);
+	}
+}
+
+int main() {
+	run_all("1k of 4k:", 1000);
+	run_all("10k of 40k:", 10000);
+	run_all("100k of 400k:", 100000);
+}
@@ -0,0 +1,108 @@
+/** scaling of Component_container::parallel_for_each over the worker count **
+ *                                                                           *
+ * Copyright (c) 2016 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#include "benchmark.hpp"
+
+#include <game/sys/physics/physics_system.hpp>
+
+#include <core/asset/asset_manager.hpp>
+#include <core/ecs/ecs.hpp>
+#include <core/utils/messagebus.hpp>
+#include <core/utils/thread_pool.hpp>
+
+#include <glm/gtx/norm.hpp>
+
+#include <algorithm>
+#include <sstream>
+#include <thread>
+
+using namespace lux;
+using namespace lux::sys::physics;
+using namespace lux::unit_literals;
+
+namespace {
+	constexpr auto entity_count = 10000;
+
+	// the state of the Ai_patrolling_comp of the Controller_system
+	struct Patrol_comp : ecs::Component<Patrol_comp> {
+		static constexpr const char* name() {return "Bench_patrol";}
+		Patrol_comp() = default;
+		Patrol_comp(ecs::Entity_manager& manager, ecs::Entity_handle owner)
+		    : Component(manager, owner) {}
+
+		glm::vec2 start_position;
+		bool start_position_set = false;
+		bool moving_left = false;
+		float velocity = 2.f;
+		float max_distance = 3.f;
+	};
+
+	struct Scene {
+		util::Thread_pool thread_pool;
+		util::Message_bus bus;
+		ecs::Entity_manager ecs;
+		Physics_system physics;
+
+		// circles in rows, so some of the raycasts hit a neighbour
+		Scene(asset::Asset_manager& assets, int workers)
+		    : thread_pool(workers), ecs(thread_pool, &assets), physics(bus, ecs) {
+			ecs.register_component_type<Transform_comp>();
+
+			for(auto i=0; i<entity_count; i++) {
+				auto json = std::stringstream{};
+				json<<"{\"Transform\": {\"position\": {\"x\": "<<(i%100)*1.5f<<", \"y\": "<<(i/100)*4<<", \"z\": 0}},"
+				    <<" \"Dynamic_body\": {\"shape\": \"circle\", \"size\": {\"x\": 1, \"y\": 1}}}";
+				ecs.read_one(json.str()).emplace<Patrol_comp>();
+			}
+			ecs.process_queued_actions();
+			physics.update(16_ms);
+		}
+
+		// the parallel part of Controller_system::_update_ai
+		void update_patrols(Time dt) {
+			ecs.list<Patrol_comp>().parallel_for_each([&](Patrol_comp& c) {
+				auto& transform = c.owner().get<Transform_comp>().get_or_throw();
+				auto& body = c.owner().get<Dynamic_body_comp>().get_or_throw();
+				auto position = glm::vec2(remove_units(transform.position()));
+
+				if(!c.start_position_set) {
+					c.start_position_set = true;
+					c.start_position = position;
+				}
+
+				auto dir = c.moving_left ? -1.f : 1.f;
+				auto next_pos = position + c.velocity * dir * dt.value()*4.f;
+				auto turn = glm::length2(c.start_position - next_pos) > c.max_distance*c.max_distance;
+				auto ray = physics.raycast(position, glm::vec2{dir, 0.f}, 1.f);
+				turn |= ray.is_some() && ray.get_or_throw().entity;
+
+				if(turn) {
+					c.moving_left = !c.moving_left;
+					dir *= -0.5f;
+				}
+
+				auto vel_diff = c.velocity * dir - body.velocity();
+				body.apply_force(vel_diff * body.mass() / dt.value());
+			});
+		}
+	};
+}
+
+int main(int argc, char** argv) {
+	// requires the archives.lst of the asset directory, i.e. has to be run from /assets
+	asset::Asset_manager assets{argc>0 ? argv[0] : "", "BanishedBlaze_bench"};
+
+	// the calling thread also processes chunks, so n workers use n+1 threads
+	auto max_workers = std::max(3, static_cast<int>(std::thread::hardware_concurrency())-1);
+	for(auto workers=0; workers<=max_workers; workers++) {
+		Scene scene{assets, workers};
+
+		bench::report("10k patrols, "+std::to_string(workers)+" workers:", bench::measure([&] {
+			scene.update_patrols(16_ms);
+		}));
+	}
+}
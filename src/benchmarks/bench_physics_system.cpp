@@ -0,0 +1,69 @@
+/** throughput of the Physics_system with many dynamic bodies ****************
+ *                                                                           *
+ * Copyright (c) 2016 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#include "benchmark.hpp"
+
+#include <game/sys/physics/physics_system.hpp>
+
+#include <core/asset/asset_manager.hpp>
+#include <core/ecs/ecs.hpp>
+#include <core/utils/messagebus.hpp>
+#include <core/utils/thread_pool.hpp>
+
+#include <sstream>
+
+using namespace lux;
+using namespace lux::sys::physics;
+using namespace lux::unit_literals;
+
+namespace {
+	struct Scene {
+		util::Thread_pool thread_pool {0};
+		util::Message_bus bus;
+		ecs::Entity_manager ecs;
+		Physics_system physics;
+
+		// circles on a grid, that are far enough apart to never collide
+		Scene(asset::Asset_manager& assets, int count) : ecs(thread_pool, &assets), physics(bus, ecs) {
+			ecs.register_component_type<Transform_comp>();
+
+			for(auto i=0; i<count; i++) {
+				auto json = std::stringstream{};
+				json<<"{\"Transform\": {\"position\": {\"x\": "<<(i%100)*4<<", \"y\": "<<(i/100)*4<<", \"z\": 0}},"
+				    <<" \"Dynamic_body\": {\"shape\": \"circle\", \"size\": {\"x\": 1, \"y\": 1}}}";
+				ecs.read_one(json.str());
+			}
+			update(16_ms);
+		}
+
+		void update(Time dt) {
+			ecs.next_change_frame();
+			ecs.process_queued_actions();
+			physics.update(dt);
+		}
+	};
+
+	void run(asset::Asset_manager& assets, const std::string& name, int count) {
+		Scene scene{assets, count};
+
+		// less than one time step: only the positions are synchronized with the bodies
+		bench::report(name+" sync", bench::measure([&] {
+			scene.update(0_s);
+		}));
+		bench::report(name+" step", bench::measure([&] {
+			scene.update(1_s / 60.f);
+		}));
+	}
+}
+
+int main(int argc, char** argv) {
+	// requires the archives.lst of the asset directory, i.e. has to be run from /assets
+	asset::Asset_manager assets{argc>0 ? argv[0] : "", "BanishedBlaze_bench"};
+
+	run(assets, "1k bodies:", 1000);
+	run(assets, "10k bodies:", 10000);
+}
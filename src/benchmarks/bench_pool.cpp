@@ -0,0 +1,102 @@
+/** iteration over pools with free slots at different fill ratios ************
+ *                                                                           *
+ * Copyright (c) 2016 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#include "benchmark.hpp"
+
+#include <core/utils/pool.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace lux;
+
+namespace {
+	constexpr auto slot_count = 100000;
+
+	// about the size of a small component (owner handle + payload)
+	struct Element {
+		int64_t marker = 0;
+		int32_t value[10] = {};
+
+		Element() = default;
+		Element(int32_t v) : marker(1) {value[0] = v;}
+	};
+
+	struct Element_traits {
+		static constexpr bool supports_empty_values = true;
+		static constexpr int_fast32_t max_free = 8;
+		using Marker_type = int64_t;
+		static constexpr Marker_type free_mark = -1;
+
+		static constexpr const Marker_type* marker_addr(const Element* inst) {
+			return &inst->marker;
+		}
+	};
+	constexpr bool Element_traits::supports_empty_values;
+	constexpr int_fast32_t Element_traits::max_free;
+	constexpr Element_traits::Marker_type Element_traits::free_mark;
+
+	using Pool = util::pool<Element, 256, int32_t, Element_traits>;
+
+	// slot_count slots, of which (1-fill) are free and randomly distributed
+	void fill(Pool& pool, float fill) {
+		for(auto i=0; i<slot_count; i++) {
+			pool.emplace_back(i);
+		}
+
+		// the last slot stays occupied, because erasing it would shrink the pool instead
+		auto indices = std::vector<int32_t>();
+		for(auto i=0; i<slot_count-1; i++) {
+			indices.push_back(i);
+		}
+		std::shuffle(indices.begin(), indices.end(), std::mt19937{42});
+		indices.resize(static_cast<std::size_t>((1.f-fill) * slot_count));
+		for(auto i : indices) {
+			pool.erase(i);
+		}
+	}
+
+	void run(const std::string& name, float fill_ratio) {
+		Pool pool;
+		fill(pool, fill_ratio);
+
+		bench::report(name+" iterator", bench::measure([&] {
+			auto sum = int64_t(0);
+			for(auto& e : pool) {
+				sum += e.value[0];
+			}
+			bench::do_not_optimize(sum);
+		}));
+
+		bench::report(name+" for_each_in_chunks", bench::measure([&] {
+			auto sum = int64_t(0);
+			pool.for_each_in_chunks(0, pool.chunk_count(), [&](auto& e) {
+				sum += e.value[0];
+			});
+			bench::do_not_optimize(sum);
+		}));
+
+		bench::report(name+" for_each_span", bench::measure([&] {
+			auto sum = int64_t(0);
+			pool.for_each_span([&](auto begin, auto end) {
+				for(auto e=begin; e!=end; ++e) {
+					sum += e->value[0];
+				}
+			});
+			bench::do_not_optimize(sum);
+		}));
+	}
+}
+
+int main() {
+	// 100k slots
+	run("10% occupied:", 0.1f);
+	run("50% occupied:", 0.5f);
+	run("90% occupied:", 0.9f);
+	run("100% occupied:", 1.f);
+}
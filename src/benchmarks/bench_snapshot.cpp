@@ -0,0 +1,128 @@
+/** Entity_manager::snapshot/restore vs. write_one/read_one ******************
+ *                                                                           *
+ * Copyright (c) 2016 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#include "benchmark.hpp"
+
+#include <core/asset/asset_manager.hpp>
+#include <core/ecs/ecs.hpp>
+#include <core/ecs/serializer.hpp>
+#include <core/utils/thread_pool.hpp>
+
+#include <glm/vec3.hpp>
+
+using namespace lux;
+
+namespace {
+	struct Binary_comp : ecs::Component<Binary_comp> {
+		static constexpr const char* name() {return "Bench_binary";}
+
+		Binary_comp() = default;
+		Binary_comp(ecs::Entity_manager& manager, ecs::Entity_handle owner, int32_t value=0)
+		    : Component(manager, owner), value(value), position(value, 1.f, 2.f), tag("entity") {}
+
+		int32_t value = 0;
+		glm::vec3 position;
+		std::string tag;
+
+		friend void load_component(ecs::Binary_reader& reader, Binary_comp& comp) {
+			reader.read(comp.value);
+			reader.read(comp.position);
+			reader.read(comp.tag);
+		}
+		friend void save_component(ecs::Binary_writer& writer, const Binary_comp& comp) {
+			writer.write(comp.value);
+			writer.write(comp.position);
+			writer.write(comp.tag);
+		}
+	};
+
+	struct Json_comp : ecs::Component<Json_comp> {
+		static constexpr const char* name() {return "Bench_json";}
+
+		Json_comp() = default;
+		Json_comp(ecs::Entity_manager& manager, ecs::Entity_handle owner, float value=0.f)
+		    : Component(manager, owner), value(value) {}
+
+		float value = 0.f;
+
+		friend void load_component(ecs::Deserializer& state, Json_comp& comp) {
+			state.read_virtual(sf2::vmember("value", comp.value));
+		}
+		friend void save_component(ecs::Serializer& state, const Json_comp& comp) {
+			state.write_virtual(sf2::vmember("value", comp.value));
+		}
+	};
+
+	struct Scene {
+		util::Thread_pool thread_pool {0};
+		ecs::Entity_manager source;
+		ecs::Entity_manager target;
+		std::vector<ecs::Entity_handle> entities;
+
+		// with_json: every entity also owns a component without binary serialization
+		Scene(asset::Asset_manager& assets, int count, bool with_json)
+		    : source(thread_pool, &assets), target(thread_pool, &assets) {
+			source.register_component_type<Binary_comp>();
+			source.register_component_type<Json_comp>();
+			target.register_component_type<Binary_comp>();
+			target.register_component_type<Json_comp>();
+
+			for(auto i=0; i<count; i++) {
+				auto entity = source.emplace();
+				entity.emplace<Binary_comp>(i);
+				if(with_json) {
+					entity.emplace<Json_comp>(i*0.5f);
+				}
+				entities.push_back(entity.handle());
+			}
+			source.process_queued_actions();
+		}
+
+		void clear_target() {
+			target.clear();
+		}
+	};
+
+	void run(asset::Asset_manager& assets, const std::string& name, int count, bool with_json) {
+		Scene scene{assets, count, with_json};
+
+		bench::report(name+" snapshot", bench::measure([&] {
+			bench::do_not_optimize(scene.source.snapshot(scene.entities));
+		}));
+		auto snapshot = scene.source.snapshot(scene.entities);
+		bench::report(name+" restore", bench::measure([&]{scene.clear_target();}, [&] {
+			scene.target.restore(snapshot);
+			scene.target.process_queued_actions();
+		}));
+
+		bench::report(name+" write_one", bench::measure([&] {
+			for(auto entity : scene.entities) {
+				bench::do_not_optimize(scene.source.write_one(entity));
+			}
+		}));
+		auto etos = std::vector<ecs::ETO>();
+		for(auto entity : scene.entities) {
+			etos.push_back(scene.source.write_one(entity));
+		}
+		bench::report(name+" read_one", bench::measure([&]{scene.clear_target();}, [&] {
+			for(auto& eto : etos) {
+				scene.target.read_one(eto);
+			}
+			scene.target.process_queued_actions();
+		}));
+	}
+}
+
+int main(int argc, char** argv) {
+	// requires the archives.lst of the asset directory, i.e. has to be run from /assets
+	asset::Asset_manager assets{argc>0 ? argv[0] : "", "BanishedBlaze_bench"};
+
+	run(assets, "1k binary:", 1000, false);
+	run(assets, "10k binary:", 10000, false);
+	run(assets, "1k binary+JSON:", 1000, true);
+	run(assets, "10k binary+JSON:", 10000, true);
+}
@@ -0,0 +1,122 @@
+/** Spatial_grid queries vs. a linear scan of all bounding boxes ************
+ *                                                                           *
+ * Copyright (c) 2016 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#include "benchmark.hpp"
+
+#include <game/sys/physics/spatial_index.hpp>
+
+#include <core/utils/log.hpp>
+
+#include <random>
+#include <vector>
+
+using namespace lux;
+using namespace lux::sys::physics;
+
+namespace {
+	constexpr auto world_size = 1000.f; //< in meters
+	constexpr auto query_count = 1000;
+	constexpr auto query_radius = 1.75f;  //< the radius of the lamps and paint
+	constexpr auto ray_length = 20.f;
+
+	struct Box {
+		ecs::Entity_handle entity;
+		Aabb bounds;
+	};
+
+	struct Query {
+		glm::vec2 point;
+		glm::vec2 dir;
+	};
+
+	struct Scene {
+		std::vector<Box> boxes;
+		std::vector<Query> queries;
+		Spatial_grid grid;
+
+		Scene(int count) {
+			auto rng = std::mt19937{42};
+			auto position = std::uniform_real_distribution<float>(0.f, world_size);
+			auto half_extent = std::uniform_real_distribution<float>(0.25f, 2.f);
+			auto angle = std::uniform_real_distribution<float>(0.f, 6.2831853f);
+
+			for(auto i=0; i<count; i++) {
+				auto entity = ecs::Entity_handle{i+1, 0};
+				auto bounds = Aabb::around({position(rng), position(rng)}, half_extent(rng));
+				boxes.push_back(Box{entity, bounds});
+				grid.update(entity, bounds);
+			}
+
+			for(auto i=0; i<query_count; i++) {
+				auto a = angle(rng);
+				queries.push_back(Query{{position(rng), position(rng)}, {std::cos(a), std::sin(a)}});
+			}
+		}
+
+		auto scan_radius(const Query& q) {
+			auto found = 0;
+			for(auto& box : boxes) {
+				if(box.bounds.distance2(q.point) <= query_radius*query_radius)
+					found++;
+			}
+			return found;
+		}
+		auto grid_radius(const Query& q) {
+			auto found = 0;
+			grid.for_each_in_radius(q.point, query_radius, [&](auto) {found++;});
+			return found;
+		}
+
+		auto scan_ray(const Query& q) {
+			auto found = 0;
+			auto inv_dir = 1.f / q.dir;
+			for(auto& box : boxes) {
+				if(box.bounds.intersect(q.point, inv_dir, ray_length) >= 0.f)
+					found++;
+			}
+			return found;
+		}
+		auto grid_ray(const Query& q) {
+			auto found = 0;
+			grid.for_each_on_ray(q.point, q.dir, ray_length, [&](auto, float) {found++;});
+			return found;
+		}
+	};
+
+	// reports the mean duration of a single query
+	template<class F>
+	void run_queries(const std::string& name, const Scene& scene, F&& query) {
+		bench::report(name, bench::measure([&] {
+			auto found = 0;
+			for(auto& q : scene.queries) {
+				found += query(q);
+			}
+			bench::do_not_optimize(found);
+		}) / query_count);
+	}
+
+	void run(const std::string& name, int count) {
+		auto scene = Scene{count};
+
+		for(auto& q : scene.queries) {
+			INVARIANT(scene.scan_radius(q)==scene.grid_radius(q), "radius query results differ");
+			INVARIANT(scene.scan_ray(q)==scene.grid_ray(q), "ray query results differ");
+		}
+
+		run_queries(name+" radius linear", scene, [&](auto& q){return scene.scan_radius(q);});
+		run_queries(name+" radius Spatial_grid", scene, [&](auto& q){return scene.grid_radius(q);});
+		run_queries(name+" ray linear", scene, [&](auto& q){return scene.scan_ray(q);});
+		run_queries(name+" ray Spatial_grid", scene, [&](auto& q){return scene.grid_ray(q);});
+	}
+}
+
+int main() {
+	run("20 boxes:", 20);
+	run("100 boxes:", 100);
+	run("1000 boxes:", 1000);
+	run("10000 boxes:", 10000);
+}
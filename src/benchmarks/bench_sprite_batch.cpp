@@ -0,0 +1,96 @@
+/** radix vs. insertion sorting of the Sprite_batch **************************
+ *                                                                           *
+ * Copyright (c) 2016 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#include "benchmark.hpp"
+
+#include <core/asset/asset_manager.hpp>
+#include <core/renderer/command_queue.hpp>
+#include <core/renderer/graphics_ctx.hpp>
+#include <core/renderer/material.hpp>
+#include <core/renderer/sprite_batch.hpp>
+#include <core/utils/log.hpp>
+
+#include <SDL2/SDL.h>
+
+#include <random>
+#include <vector>
+
+using namespace lux;
+using namespace lux::renderer;
+using namespace lux::unit_literals;
+
+namespace {
+	constexpr auto material_count = 8;
+	constexpr auto alpha_material_count = 2;
+
+	// written to the write dir, because the assets don't contain any materials
+	auto create_materials(asset::Asset_manager& assets) -> std::vector<Material_ptr> {
+		auto materials = std::vector<Material_ptr>();
+		for(auto i=0; i<material_count; i++) {
+			auto path = "bench_material_"+std::to_string(i)+".json";
+			auto aid = asset::AID{"mat"_strid, path};
+			{
+				auto out = asset::ostream{aid, assets, path};
+				out<<"{\"albedo\": \"tex:material\", \"alpha\": "
+				   <<(i<alpha_material_count ? "true" : "false")<<"}";
+			}
+			materials.push_back(assets.load<Material>(aid, false));
+		}
+		return materials;
+	}
+
+	auto create_sprites(const std::vector<Material_ptr>& materials, int count) -> std::vector<Sprite> {
+		auto rng = std::mt19937{42};
+		auto position = std::uniform_real_distribution<float>(-100.f, 100.f);
+		auto depth = std::uniform_real_distribution<float>(-1.f, 1.f);
+		auto material = std::uniform_int_distribution<std::size_t>(0, materials.size()-1);
+
+		auto sprites = std::vector<Sprite>();
+		sprites.reserve(static_cast<std::size_t>(count));
+		for(auto i=0; i<count; i++) {
+			sprites.emplace_back(glm::vec3{position(rng), position(rng), depth(rng)}, 0_deg,
+			                     glm::vec2{1.f, 1.f}, glm::vec4{0.f, 0.f, 1.f, 1.f},
+			                     0.f, 0.f, *materials[material(rng)]);
+		}
+		return sprites;
+	}
+
+	void run(const std::string& name, const std::vector<Sprite>& sprites, Sprite_batch::Sort_mode mode) {
+		Sprite_batch batch{sprites.size()};
+		batch.sort_mode(mode);
+		Command_queue queue;
+
+		// the execution of the draw commands isn't included
+		bench::report(name, bench::measure([&]{queue.flush();}, [&] {
+			for(auto& sprite : sprites) {
+				batch.insert(sprite);
+			}
+			batch.flush(queue);
+		}));
+	}
+}
+
+int main(int argc, char** argv) {
+	// requires the archives.lst of the asset directory, i.e. has to be run from /assets
+	asset::Asset_manager assets{argc>0 ? argv[0] : "", "BanishedBlaze_bench"};
+
+	INVARIANT(SDL_Init(SDL_INIT_VIDEO)==0, "Could not initialize SDL: "<<SDL_GetError());
+	{
+		Graphics_ctx graphics{"bench_sprite_batch", assets};
+		init_materials(assets);
+		init_sprite_renderer(assets);
+
+		auto materials = create_materials(assets);
+		for(auto count : {100, 1000, 10000}) {
+			auto sprites = create_sprites(materials, count);
+			auto prefix = std::to_string(count)+" sprites:";
+			run(prefix+" insertion", sprites, Sprite_batch::Sort_mode::insertion);
+			run(prefix+" radix", sprites, Sprite_batch::Sort_mode::radix);
+		}
+	}
+	SDL_Quit();
+}
@@ -0,0 +1,124 @@
+/** iteration of Transform_comp-sized data: Soa vs. Pool_storage_policy *******
+ *                                                                           *
+ * Copyright (c) 2016 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#include "benchmark.hpp"
+
+#include <game/sys/physics/transform_comp.hpp>
+
+#include <core/ecs/ecs.hpp>
+#include <core/utils/thread_pool.hpp>
+
+using namespace lux;
+using namespace lux::unit_literals;
+using sys::physics::Transform_data;
+
+namespace {
+	// same members as the Transform_comp, stored inline
+	struct Pool_transform : ecs::Component<Pool_transform, ecs::Paged_index_policy,
+	                                       ecs::Pool_storage_policy<256, Pool_transform>> {
+		static constexpr const char* name() {return "Bench_pool_transform";}
+		using Component::Component;
+
+		auto data()noexcept -> Transform_data& {return _data;}
+
+		Transform_data _data;
+		bool _rotation_fixed = false;
+		bool _flip_horizontal = false;
+		bool _flip_vertical = false;
+	};
+
+	// same layout as the Transform_comp
+	struct Soa_transform : ecs::Component<Soa_transform, ecs::Paged_index_policy,
+	                                      ecs::Soa_storage_policy<256, Soa_transform, Transform_data>>,
+	                       ecs::Soa_field<Transform_data> {
+		static constexpr const char* name() {return "Bench_soa_transform";}
+		using Component::Component;
+
+		auto data()noexcept -> Transform_data& {return soa_fields();}
+
+		bool _rotation_fixed = false;
+		bool _flip_horizontal = false;
+		bool _flip_vertical = false;
+	};
+
+	template<class T>
+	struct Scene {
+		util::Thread_pool thread_pool {0};
+		ecs::Entity_manager manager {thread_pool};
+		typename T::Pool& pool;
+
+		Scene(int count) : pool(manager.list<T>()) {
+			for(auto i=0; i<count; i++) {
+				manager.emplace().template emplace<T>();
+			}
+			manager.process_queued_actions();
+		}
+	};
+
+	auto read(const Transform_data& data) {
+		return remove_units(data.position).x + data.rotation.value() + data.scale;
+	}
+	void write(Transform_data& data) {
+		data.position += Position{1_m, 0_m, 0_m};
+		data.revision++;
+	}
+
+	template<class T>
+	void run_components(const std::string& name, int count) {
+		Scene<T> scene{count};
+
+		bench::report(name+" read", bench::measure([&] {
+			auto sum = 0.f;
+			for(auto& comp : scene.pool) {
+				sum += read(comp.data());
+			}
+			bench::do_not_optimize(sum);
+		}));
+
+		bench::report(name+" write", bench::measure([&] {
+			for(auto& comp : scene.pool) {
+				write(comp.data());
+			}
+		}));
+	}
+
+	// iterates the Transform_data array directly, without touching the components
+	void run_fields(const std::string& name, int count) {
+		Scene<Soa_transform> scene{count};
+		auto& fields = scene.pool.storage().fields<Transform_data>();
+
+		bench::report(name+" read", bench::measure([&] {
+			auto sum = 0.f;
+			fields.for_each_span([&](auto begin, auto end) {
+				for(auto data=begin; data!=end; ++data) {
+					sum += read(*data);
+				}
+			});
+			bench::do_not_optimize(sum);
+		}));
+
+		bench::report(name+" write", bench::measure([&] {
+			fields.for_each_span([&](auto begin, auto end) {
+				for(auto data=begin; data!=end; ++data) {
+					write(*data);
+				}
+			});
+		}));
+	}
+
+	void run(const std::string& name, int count) {
+		run_components<Pool_transform>(name+" Pool_storage_policy", count);
+		run_components<Soa_transform>(name+" Soa_storage_policy", count);
+		run_fields(name+" Soa_storage_policy fields", count);
+	}
+}
+
+int main() {
+	run("1k:", 1000);
+	run("10k:", 10000);
+	run("100k:", 100000);
+}
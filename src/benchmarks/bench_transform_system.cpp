@@ -0,0 +1,92 @@
+/** stress test of the parent/child hierarchy of the Transform_system ********
+ *                                                                           *
+ * Copyright (c) 2016 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#include "benchmark.hpp"
+
+#include <game/sys/physics/transform_system.hpp>
+
+#include <core/ecs/ecs.hpp>
+#include <core/utils/thread_pool.hpp>
+
+using namespace lux;
+using namespace lux::sys::physics;
+using namespace lux::unit_literals;
+
+namespace {
+	constexpr auto entity_count = 10000;
+
+	struct Scene {
+		util::Thread_pool thread_pool {0};
+		ecs::Entity_manager ecs {thread_pool};
+		Transform_system transforms {ecs};
+		std::vector<ecs::Entity_facet> entities;
+
+		// chain: each entity is attached to the previous one; otherwise all to the first
+		Scene(bool chain) {
+			entities.push_back(ecs.emplace());
+			entities.back().emplace<Transform_comp>();
+
+			for(auto i=1; i<entity_count; i++) {
+				auto parent = chain ? entities.back().handle() : entities.front().handle();
+				entities.push_back(ecs.emplace());
+				entities.back().emplace<Transform_comp>();
+				entities.back().emplace<Parent_comp>(parent, Position{1_m, 0_m, 0_m});
+			}
+			update();
+		}
+
+		void update() {
+			ecs.next_change_frame();
+			ecs.process_queued_actions();
+			transforms.update(16_ms);
+		}
+
+		auto transform(std::size_t i) -> Transform_comp& {
+			return entities.at(i).get<Transform_comp>().get_or_throw();
+		}
+		auto parent(std::size_t i) -> Parent_comp& {
+			return entities.at(i).get<Parent_comp>().get_or_throw();
+		}
+	};
+
+	void run(const std::string& name, bool chain) {
+		Scene scene{chain};
+		auto leaf = static_cast<std::size_t>(entity_count-1);
+
+		bench::report(name+" idle", bench::measure([&] {
+			scene.update();
+		}));
+
+		auto x = 0.f;
+		bench::report(name+" moved root", bench::measure([&] {
+			x += 1.f;
+			scene.transform(0).position({x*1_m, 0_m, 0_m});
+			scene.update();
+		}));
+
+		bench::report(name+" changed leaf offset", bench::measure([&] {
+			x += 1.f;
+			scene.parent(leaf).offset({x*1_m, 0_m, 0_m});
+			scene.update();
+		}));
+
+		// moving the leaf between two parents forces a rebuild of the hierarchy
+		auto first_parent = scene.parent(leaf).parent();
+		auto second_parent = scene.entities.at(1).handle();
+		auto flip = false;
+		bench::report(name+" rebuild", bench::measure([&] {
+			flip = !flip;
+			scene.parent(leaf).parent(flip ? second_parent : first_parent);
+			scene.update();
+		}));
+	}
+}
+
+int main() {
+	run("10k deep chain:", true);
+	run("10k wide fan-out:", false);
+}
@@ -0,0 +1,107 @@
+/** cost of setting uniforms with short and long names ***********************
+ *                                                                           *
+ * Copyright (c) 2016 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#include "benchmark.hpp"
+
+#include <core/asset/asset_manager.hpp>
+#include <core/renderer/graphics_ctx.hpp>
+#include <core/renderer/shader.hpp>
+#include <core/renderer/uniform_map.hpp>
+#include <core/utils/log.hpp>
+
+#include <SDL2/SDL.h>
+
+#include <array>
+#include <memory>
+
+using namespace lux;
+using namespace lux::renderer;
+
+namespace {
+	constexpr auto uniform_count = 6;
+	using Names = std::array<const char*, uniform_count>;
+
+	const auto short_names = Names{{"a", "b", "c", "d", "e", "f"}};
+	const auto long_names = Names{{
+		"uniform_with_a_really_long_name_for_the_light_color_0",
+		"uniform_with_a_really_long_name_for_the_light_color_1",
+		"uniform_with_a_really_long_name_for_the_light_color_2",
+		"uniform_with_a_really_long_name_for_the_light_color_3",
+		"uniform_with_a_really_long_name_for_the_light_color_4",
+		"uniform_with_a_really_long_name_for_the_light_color_5"
+	}};
+
+	// in place, because the attached shaders keep a pointer to the program
+	void build_program(Shader_program& program, const Names& names) {
+		auto vert_source = std::string{
+			"#version 100\n"
+			"attribute vec2 position;\n"
+			"void main() {\n"
+			"	gl_Position = vec4(position, 0.0, 1.0);\n"
+			"}\n"};
+
+		auto frag_source = std::string{"#version 100\nprecision mediump float;\n"};
+		for(auto name : names) {
+			frag_source += std::string("uniform vec4 ")+name+";\n";
+		}
+		frag_source += "void main() {\n	gl_FragColor = vec4(0.0)";
+		for(auto name : names) {
+			frag_source += std::string(" + ")+name;
+		}
+		frag_source += ";\n}\n";
+
+		program.attach_shader(std::make_shared<Shader>(Shader_type::vertex, vert_source, "bench.vert"))
+		       .attach_shader(std::make_shared<Shader>(Shader_type::fragment, frag_source, "bench.frag"))
+		       .build();
+	}
+
+	void run(const std::string& name, const Names& names) {
+		Shader_program program;
+		build_program(program, names);
+		program.bind();
+
+		Uniform_map<uniform_count> uniforms;
+		for(auto uniform : names) {
+			uniforms.emplace(uniform, glm::vec4(1.f));
+		}
+
+		// the values don't change, so no GL calls are made
+		bench::report(name+" bind_all", bench::measure([&] {
+			uniforms.bind_all(program);
+		}));
+
+		auto value = 0.f;
+		bench::report(name+" emplace+bind_all", bench::measure([&] {
+			value += 1.f;
+			for(auto uniform : names) {
+				uniforms.emplace(uniform, glm::vec4(value));
+			}
+			uniforms.bind_all(program);
+		}));
+
+		bench::report(name+" set_uniform(name)", bench::measure([&] {
+			for(auto uniform : names) {
+				program.set_uniform(uniform, glm::vec4(1.f));
+			}
+		}));
+	}
+}
+
+int main(int argc, char** argv) {
+	// requires the archives.lst of the asset directory, i.e. has to be run from /assets
+	asset::Asset_manager assets{argc>0 ? argv[0] : "", "BanishedBlaze_bench"};
+
+	INVARIANT(SDL_Init(SDL_INIT_VIDEO)==0, "Could not initialize SDL: "<<SDL_GetError());
+	{
+		Graphics_ctx graphics{"bench_uniforms", assets};
+
+		// 6 vec4 uniforms each
+		run("1 char names:", short_names);
+		run("53 char names:", long_names);
+	}
+	SDL_Quit();
+}
@@ -0,0 +1,80 @@
+/** helpers for the micro benchmarks *****************************************
+ *                                                                           *
+ * Copyright (c) 2016 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+
+namespace lux {
+namespace bench {
+
+	using Clock = std::chrono::steady_clock;
+
+	/// the minimal time spent in each measure(...)
+	constexpr auto min_duration = std::chrono::milliseconds(250);
+
+	/**
+	 * Returns the mean duration of f() in microseconds.
+	 * f is called once to warm up and then repeatedly for at least min_duration.
+	 */
+	template<class F>
+	auto measure(F&& f) -> double {
+		f();
+
+		auto runs = 0;
+		auto start = Clock::now();
+		auto elapsed = Clock::duration::zero();
+		do {
+			f();
+			runs++;
+			elapsed = Clock::now() - start;
+		} while(elapsed < min_duration);
+
+		return std::chrono::duration<double, std::micro>(elapsed).count() / runs;
+	}
+
+	/// like measure(f), but setup() is called before each run of f() and not included in the result
+	template<class S, class F>
+	auto measure(S&& setup, F&& f) -> double {
+		setup();
+		f();
+
+		auto runs = 0;
+		auto measured = Clock::duration::zero();
+		auto start = Clock::now();
+		do {
+			setup();
+			auto run_start = Clock::now();
+			f();
+			measured += Clock::now() - run_start;
+			runs++;
+		} while(Clock::now() - start < min_duration);
+
+		return std::chrono::duration<double, std::micro>(measured).count() / runs;
+	}
+
+	/// prints "name: duration" aligned, in the most readable unit
+	inline void report(const std::string& name, double us) {
+		std::cout<<std::left<<std::setw(48)<<name<<std::right<<std::fixed<<std::setprecision(2);
+		if(us>=1000.0)
+			std::cout<<std::setw(10)<<(us/1000.0)<<" ms"<<std::endl;
+		else
+			std::cout<<std::setw(10)<<us<<" us"<<std::endl;
+	}
+
+	/// prevents the compiler from removing computations, whose results are otherwise unused
+	template<class T>
+	void do_not_optimize(const T& value) {
+		asm volatile("" : : "g"(&value) : "memory");
+	}
+
+}
+}
@@ -0,0 +1,91 @@
+/** per-thread recording of deferred ECS operations ***************************
+ *                                                                           *
+ * Copyright (c) 2016 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#pragma once
+
+#include "types.hpp"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+
+namespace lux {
+namespace ecs {
+
+	class Command_list_base {
+		public:
+			virtual ~Command_list_base() = default;
+
+			virtual auto insertion_count()const noexcept -> std::size_t = 0;
+			virtual void clear() = 0;
+
+			auto empty()const noexcept {
+				return deletions.empty() && insertion_count()==0;
+			}
+
+			std::vector<Entity_handle> deletions;
+	};
+
+	/// the deferred insertions and deletions of a single component type
+	template<class T>
+	class Command_list : public Command_list_base {
+		public:
+			using Insertion = std::pair<T,Entity_handle>;
+
+			auto insertion_count()const noexcept -> std::size_t override {
+				return insertions.size();
+			}
+			void clear() override {
+				deletions.clear();
+				insertions.clear();
+			}
+
+			std::vector<Insertion> insertions;
+	};
+
+	/**
+	 * Records the deferred operations of a single thread, so they don't have to be synchronized
+	 *   until Entity_manager::process_queued_actions merges the buffers of all threads.
+	 * The component containers swap the recorded lists with their (empty) processed lists,
+	 *   so the buffers keep their capacity and don't allocate in the steady state.
+	 * Only accessed by its owning thread, except by process_queued_actions, stats and clear,
+	 *   which must not run while the thread is recording.
+	 */
+	class Command_buffer {
+		public:
+			template<class T>
+			auto list() -> Command_list<T>& {
+				auto type = static_cast<std::size_t>(component_type_id<T>());
+				if(type >= _lists.size()) {
+					_lists.resize(type+1);
+				}
+
+				auto& list = _lists[type];
+				if(!list) {
+					list = std::make_unique<Command_list<T>>();
+				}
+
+				return static_cast<Command_list<T>&>(*list);
+			}
+
+			void erase(Entity_handle entity) {
+				_erased_entities.push_back(entity);
+			}
+
+		private:
+			friend class Entity_manager;
+
+			std::vector<std::unique_ptr<Command_list_base>> _lists; //< indexed by Component_type
+			std::vector<Entity_handle> _erased_entities;
+	};
+
+	/// the command buffer of the calling thread
+	extern auto get_command_buffer(Entity_manager&) -> Command_buffer&;
+
+}
+}
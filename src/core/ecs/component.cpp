@@ -1,5 +1,7 @@
 #include "component.hpp"
 
+#include <algorithm>
+
 namespace lux {
 namespace ecs {
 
@@ -27,6 +29,129 @@ namespace ecs {
 	void Sparse_index_policy::clear() {
 		_table.clear();
 	}
+	auto Sparse_index_policy::memory_usage()const -> std::size_t {
+		// estimate for node based implementations: one node with a next-pointer per entry
+		using value_type = decltype(_table)::value_type;
+		return _table.size() * (sizeof(value_type) + sizeof(void*))
+		       + _table.bucket_count() * sizeof(void*);
+	}
+
+
+	namespace {
+		constexpr auto flat_index_min_capacity = std::size_t(16);
+	}
+
+	void Flat_index_policy::attach(Entity_id owner, Component_index comp) {
+		if(owner==invalid_entity_id)
+			return;
+
+		// max load factor of 3/4
+		if((_size+1)*4 > _slots.size()*3) {
+			_rehash(std::max(flat_index_min_capacity, _slots.size()*2));
+		}
+
+		auto inserted = Slot{owner, comp};
+		auto dist = std::size_t(0);
+		for(auto i=_home(owner); ; i=(i+1) & _mask, dist++) {
+			auto& slot = _slots[i];
+
+			if(slot.owner==invalid_entity_id) {
+				slot = inserted;
+				_size++;
+				return;
+			}
+
+			if(slot.owner==inserted.owner) {
+				slot.comp = inserted.comp;
+				return;
+			}
+
+			// robin hood: take the slot from entries that are closer to their home slot
+			auto slot_dist = _distance(i);
+			if(slot_dist<dist) {
+				std::swap(slot, inserted);
+				dist = slot_dist;
+			}
+		}
+	}
+	void Flat_index_policy::detach(Entity_id owner) {
+		if(owner==invalid_entity_id || _size==0)
+			return;
+
+		for(auto i=_home(owner), dist=std::size_t(0); ; i=(i+1) & _mask, dist++) {
+			auto& slot = _slots[i];
+			if(slot.owner==invalid_entity_id || _distance(i)<dist)
+				return; // not found
+
+			if(slot.owner==owner) {
+				// shift the following entries back, until one is empty or in its home slot
+				auto next = (i+1) & _mask;
+				while(_slots[next].owner!=invalid_entity_id && _distance(next)>0) {
+					_slots[i] = _slots[next];
+					i = next;
+					next = (next+1) & _mask;
+				}
+
+				_slots[i] = Slot{};
+				_size--;
+				return;
+			}
+		}
+	}
+	void Flat_index_policy::shrink_to_fit() {
+		auto capacity = flat_index_min_capacity;
+		while(_size*4 > capacity*3) {
+			capacity *= 2;
+		}
+
+		if(capacity < _slots.size()) {
+			_rehash(capacity);
+		}
+	}
+	auto Flat_index_policy::find(Entity_id owner)const -> util::maybe<Component_index> {
+		if(owner==invalid_entity_id || _size==0)
+			return util::nothing();
+
+		for(auto i=_home(owner), dist=std::size_t(0); ; i=(i+1) & _mask, dist++) {
+			auto& slot = _slots[i];
+			if(slot.owner==owner)
+				return slot.comp;
+
+			if(slot.owner==invalid_entity_id || _distance(i)<dist)
+				return util::nothing();
+		}
+	}
+	void Flat_index_policy::clear() {
+		_slots.clear();
+		_mask = 0;
+		_size = 0;
+	}
+	auto Flat_index_policy::memory_usage()const -> std::size_t {
+		return _slots.capacity() * sizeof(Slot);
+	}
+
+	auto Flat_index_policy::_home(Entity_id owner)const noexcept -> std::size_t {
+		// multiplication with an odd constant is a bijection modulo the table size, so the
+		//   mostly sequential entity ids don't collide
+		return (static_cast<uint32_t>(owner) * UINT32_C(2654435769)) & _mask;
+	}
+	auto Flat_index_policy::_distance(std::size_t slot)const noexcept -> std::size_t {
+		return (slot - _home(_slots[slot].owner)) & _mask;
+	}
+	void Flat_index_policy::_rehash(std::size_t capacity) {
+		auto old_slots = std::move(_slots);
+
+		_slots.clear();
+		_slots.resize(capacity);
+		_mask = capacity-1;
+		_size = 0;
+
+		for(auto& slot : old_slots) {
+			if(slot.owner!=invalid_entity_id) {
+				attach(slot.owner, slot.comp);
+			}
+		}
+	}
 
 
 	Compact_index_policy::Compact_index_policy() {
@@ -37,7 +162,7 @@ namespace ecs {
 		if(owner==invalid_entity_id)
 			return;
 
-		if(static_cast<Entity_id>(_table.size()) < owner) {
+		if(static_cast<Entity_id>(_table.size()) <= owner) {
 			auto capacity = static_cast<std::size_t>(std::max(owner, 64));
 			_table.resize(capacity*2, -1);
 		}
@@ -55,7 +180,7 @@ namespace ecs {
 		}
 	}
 	void Compact_index_policy::shrink_to_fit() {
-		auto new_end = std::find_if(_table.rbegin(), _table.rend(), [](auto i){return i!=0;});
+		auto new_end = std::find_if(_table.rbegin(), _table.rend(), [](auto i){return i>=0;});
 		_table.erase(new_end.base(), _table.end());
 		_table.shrink_to_fit();
 	}
@@ -77,6 +202,134 @@ namespace ecs {
 	void Compact_index_policy::clear() {
 		_table.clear();
 	}
+	auto Compact_index_policy::memory_usage()const -> std::size_t {
+		return _table.capacity() * sizeof(Component_index);
+	}
+
+
+	constexpr std::size_t Paged_index_policy::page_size;
+
+	void Paged_index_policy::attach(Entity_id owner, Component_index comp) {
+		if(owner==invalid_entity_id)
+			return;
+
+		auto page_idx = static_cast<std::size_t>(owner) >> page_bits;
+		if(_pages.size() <= page_idx) {
+			_pages.resize(page_idx+1);
+		}
+
+		auto& page = _pages[page_idx];
+		if(!page) {
+			page = std::make_unique<Page>();
+		}
+
+		auto& entry = page->entries[static_cast<std::size_t>(owner) & (page_size-1)];
+		if(entry<0) {
+			page->used++;
+		}
+		entry = comp;
+	}
+	void Paged_index_policy::detach(Entity_id owner) {
+		if(owner==invalid_entity_id)
+			return;
+
+		auto page_idx = static_cast<std::size_t>(owner) >> page_bits;
+		if(page_idx >= _pages.size() || !_pages[page_idx])
+			return;
+
+		auto& page = _pages[page_idx];
+		auto& entry = page->entries[static_cast<std::size_t>(owner) & (page_size-1)];
+		if(entry>=0) {
+			entry = -1;
+			if(--page->used == 0) {
+				page.reset();
+			}
+		}
+	}
+	void Paged_index_policy::shrink_to_fit() {
+		auto new_end = std::find_if(_pages.rbegin(), _pages.rend(), [](auto& p){return p!=nullptr;});
+		_pages.erase(new_end.base(), _pages.end());
+		_pages.shrink_to_fit();
+	}
+	auto Paged_index_policy::find(Entity_id owner)const -> util::maybe<Component_index> {
+		if(owner==invalid_entity_id)
+			return util::nothing();
+
+		auto page_idx = static_cast<std::size_t>(owner) >> page_bits;
+		if(page_idx < _pages.size() && _pages[page_idx]) {
+			auto comp = _pages[page_idx]->entries[static_cast<std::size_t>(owner) & (page_size-1)];
+			if(comp>=0) {
+				return comp;
+			}
+		}
+
+		return util::nothing();
+	}
+	void Paged_index_policy::clear() {
+		_pages.clear();
+	}
+	auto Paged_index_policy::memory_usage()const -> std::size_t {
+		auto pages = std::count_if(_pages.begin(), _pages.end(), [](auto& p){return p!=nullptr;});
+		return _pages.capacity() * sizeof(std::unique_ptr<Page>)
+		       + static_cast<std::size_t>(pages) * sizeof(Page);
+	}
+
+
+	constexpr uint64_t Change_tracker::history;
+	constexpr Component_index Change_tracker::word_bits;
+
+	Change_tracker::Change_tracker(Component_index chunk_len)
+	    : _chunk_len(chunk_len), _words_per_chunk((chunk_len + word_bits-1) / word_bits) {
+	}
+
+	void Change_tracker::reserve(Component_index size) {
+		auto chunks = static_cast<std::size_t>((size + _chunk_len-1) / _chunk_len);
+		if(chunks > _chunk_frames.size()) {
+			_chunk_frames.resize(chunks, 0);
+			for(auto& bits : _bits) {
+				bits.resize(chunks * static_cast<std::size_t>(_words_per_chunk), 0);
+			}
+		}
+	}
+	void Change_tracker::mark(Component_index idx) {
+		auto word = _word(idx);
+		INVARIANT(word < _bits[0].size(), "Change_tracker::mark on unreserved index "<<idx);
+
+		// atomic, because the components of a chunk may be marked by code iterating a different
+		//   container (e.g. the Transform_comp of an entity inside a parallel loop over its AI)
+		__atomic_fetch_or(&_bits[_frame % history][word], uint64_t(1) << (idx % _chunk_len % word_bits),
+		                  __ATOMIC_RELAXED);
+		__atomic_store_n(&_chunk_frames[static_cast<std::size_t>(idx / _chunk_len)], _frame + 1,
+		                 __ATOMIC_RELAXED);
+	}
+	void Change_tracker::unmark(Component_index idx) {
+		auto word = _word(idx);
+		if(word >= _bits[0].size())
+			return;
+
+		auto mask = ~(uint64_t(1) << (idx % _chunk_len % word_bits));
+		for(auto& bits : _bits) {
+			bits[word] &= mask;
+		}
+	}
+	void Change_tracker::clear() {
+		_chunk_frames.clear();
+		for(auto& bits : _bits) {
+			bits.clear();
+		}
+	}
+	void Change_tracker::frame(uint64_t frame) {
+		INVARIANT(frame >= _frame, "Change_tracker frames can't go backwards");
+
+		// the bitsets of the skipped frames and the new one are reused, i.e. the changes they
+		//   recorded fall out of the history
+		auto cleared = std::min(frame - _frame, history);
+		for(auto i=uint64_t(1); i<=cleared; i++) {
+			auto& bits = _bits[(_frame + i) % history];
+			std::fill(bits.begin(), bits.end(), 0);
+		}
+		_frame = frame;
+	}
 
 }
 }
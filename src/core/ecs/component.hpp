@@ -22,11 +22,27 @@
 
 
 namespace lux {
+namespace util {class Thread_pool;}
+
 namespace ecs {
 
 	template<class T>
 	class Component_container;
 
+	class Command_list_base;
+
+	/// the pool used to process components in parallel (see Component_container::parallel_for_each)
+	extern auto get_thread_pool(Entity_manager&) -> util::Thread_pool&;
+
+	/// max number of components relocated per frame by the compaction (see Entity_manager::compaction_budget)
+	extern auto get_compaction_budget(Entity_manager&) -> Component_index;
+
+	template<class... C>
+	class Entity_view;
+
+	template<class... C>
+	class Owning_group;
+
 
 	struct Index_policy {
 		void attach(Entity_id, Component_index); //< overrides previous assignments
@@ -34,13 +50,17 @@ namespace ecs {
 		void shrink_to_fit();
 		auto find(Entity_id)const -> util::maybe<Component_index>;
 		void clear();
+		auto memory_usage()const -> std::size_t; //< in bytes
 	};
+	class Flat_index_policy;    //< default, for components used by a subset of the entities
 	class Sparse_index_policy;  //< for rarely used components
 	class Compact_index_policy; //< for frequently used components
+	class Paged_index_policy;   //< for frequently used components, with memory bound by the live id ranges
 
 	template<class T>
 	struct Storage_policy {
 		using iterator = void;
+		static constexpr Component_index chunk_len = 32; //< components per chunk
 		auto begin() -> iterator;
 		auto end() -> iterator;
 		auto size()const -> Component_index;
@@ -48,16 +68,123 @@ namespace ecs {
 
 		template<class... Args>
 		auto emplace(Args&&... args) -> std::tuple<T&, Component_index>;
+		void reserve(Component_index); //< total number of components
 		void replace(Component_index, T&&);
 		template<typename F>
 		void erase(Component_index, F&& relocate);
 		template<typename F>
 		void shrink_to_fit(F&& relocate);
+		template<typename F>
+		void compact(F&& relocate); //< afterwards all indices in [0, size()) are valid
+		template<typename F>
+		bool compact_step(Component_index max_moves, F&& relocate); //< true if no holes are left
+		void swap(Component_index, Component_index);
 		auto get(Component_index) -> T&;
 		void clear();
+		auto chunk_count()const -> Component_index;
+		template<typename F>
+		void for_each_in_chunks(Component_index first_chunk, Component_index last_chunk, F&& f);
+		template<typename F>
+		void for_each_span(F&& f); //< f(T* begin, T* end) for each contiguous range of components
+		auto allocated_chunks()const -> Component_index;
+		auto free_count()const -> Component_index; //< holes, that are reused by the next insertions
+		auto memory_usage()const -> std::size_t; //< in bytes
 	};
 	template<std::size_t Chunk_size, class T>
 	class Pool_storage_policy;
+	template<std::size_t Chunk_size, class T, class... Fields>
+	class Soa_storage_policy;
+
+	namespace details {
+		template<class T>
+		auto has_binary_serialization(int) -> decltype(
+		        save_component(std::declval<Binary_writer&>(), std::declval<const T&>()),
+		        load_component(std::declval<Binary_reader&>(), std::declval<T&>()),
+		        std::true_type{});
+
+		template<class T>
+		auto has_binary_serialization(long) -> std::false_type;
+	}
+	template<class T>
+	using has_binary_serialization = decltype(details::has_binary_serialization<T>(0));
+
+	/**
+	 * A group of fields of a component, that is stored in a separate contiguous array by the
+	 *   Soa_storage_policy. The component has to inherit from Soa_field<Fields> for each of the
+	 *   field groups passed to its Soa_storage_policy.
+	 * Detached components (e.g. while they are queued for insertion) own an instance of Fields,
+	 *   that is allocated on construction and moved into the storage on insertion, so accessing
+	 *   the fields never allocates (and can't throw).
+	 */
+	template<class Fields>
+	class Soa_field {
+		template<std::size_t, class, class...>
+		friend class Soa_storage_policy;
+
+		public:
+			Soa_field() : _fields(new Fields()), _owned(true) {}
+			Soa_field(Soa_field&& rhs)noexcept : _fields(rhs._fields), _owned(rhs._owned) {
+				rhs._fields = nullptr;
+				rhs._owned = false;
+			}
+			/// copies are detached and own their fields until they are inserted
+			Soa_field(const Soa_field& rhs)
+			    : _fields(rhs._fields ? new Fields(*rhs._fields) : new Fields()), _owned(true) {
+			}
+			Soa_field& operator=(const Soa_field& rhs) {
+				if(this!=&rhs) {
+					if(!_fields) { // moved-from
+						_fields = new Fields();
+						_owned = true;
+					}
+					*_fields = rhs._fields ? *rhs._fields : Fields();
+				}
+				return *this;
+			}
+			Soa_field& operator=(Soa_field&& rhs)noexcept {
+				if(this!=&rhs) {
+					_reset();
+					_fields = rhs._fields;
+					_owned = rhs._owned;
+					rhs._fields = nullptr;
+					rhs._owned = false;
+				}
+				return *this;
+			}
+			~Soa_field()noexcept {
+				_reset();
+			}
+
+		protected:
+			/// must not be called on moved-from components
+			auto soa_fields()noexcept -> Fields& {
+				return *_fields;
+			}
+			auto soa_fields()const -> const Fields& {
+				static const Fields defaults = Fields();
+				return _fields ? *_fields : defaults;
+			}
+
+		private:
+			Fields* _fields = nullptr;
+			bool    _owned = false;
+
+			void _reset()noexcept {
+				if(_owned) {
+					delete _fields;
+				}
+				_fields = nullptr;
+				_owned = false;
+			}
+			// called by the storage policy after the component has been moved to its final location
+			void _bind(Fields& stored) {
+				if(_owned) {
+					stored = std::move(*_fields);
+					_reset();
+				}
+				_fields = &stored;
+			}
+	};
 
 
 	/**
@@ -69,8 +196,15 @@ namespace ecs {
 	 * Any component C may provide the following additional ADL functions for serialisation:
 	 *  - void load_component(ecs::Deserializer& state, C& v)
 	 *  - void save_component(ecs::Serializer& state, const C& v)
+	 * and for the (faster) binary snapshots, that fall back to the JSON functions if these are missing:
+	 *  - void load_component(ecs::Binary_reader& state, C& v)
+	 *  - void save_component(ecs::Binary_writer& state, const C& v)
+	 *
+	 * Copy-constructible components are instantiated from blueprints by copying a prototype,
+	 *   that has been loaded once without an owner. Components whose load_component depends
+	 *   on their owner must not be copyable.
 	 */
-	template<class T, class Index_policy=Sparse_index_policy, class Storage_policy=Pool_storage_policy<32, T>>
+	template<class T, class Index_policy=Flat_index_policy, class Storage_policy=Pool_storage_policy<32, T>>
 	class Component {
 		template<class>
 		friend class Component_container;
@@ -99,7 +233,9 @@ namespace ecs {
 			Component(Entity_manager& manager, Entity_handle owner)
 			    : _manager(&manager), _owner(owner) {}
 			Component(Component&&)noexcept = default;
+			Component(const Component&) = default;
 			Component& operator=(Component&&) = default;
+			Component& operator=(const Component&) = default;
 
 			auto owner_handle()const noexcept -> Entity_handle {
 				INVARIANT(_owner, "invalid component");
@@ -114,6 +250,9 @@ namespace ecs {
 			}
 
 		protected:
+			/// see Component_container::mark_changed; no-op for components without a container
+			void mark_changed();
+
 			~Component()noexcept { //< protected destructor to avoid destruction by base-class
 				_validate_type_helper();
 			}
@@ -144,24 +283,59 @@ namespace ecs {
 			//< NOT thread-safe; returns false if component doesn't exists
 			virtual bool save(Entity_handle owner, Serializer&) = 0;
 
+			//< NOT thread-safe; only valid if binary_serializable()
+			virtual void restore(Entity_handle owner, Binary_reader&) = 0;
+
+			//< NOT thread-safe; only valid if binary_serializable(); returns false if component doesn't exists
+			virtual bool save(Entity_handle owner, Binary_writer&) = 0;
+
+			//< NOT thread-safe; takes the recorded operations of a Command_list<T> (leaving it empty)
+			virtual void merge_commands(Command_list_base&) = 0;
+
+			//< NOT thread-safe; queues the deletion of the components owned by the erased entities
+			virtual void merge_erased(const std::vector<Entity_handle>& entities) = 0;
+
 			//< NOT thread-safe
 			virtual void process_queued_actions() = 0;
 
+			//< NOT thread-safe; see Entity_manager::next_change_frame
+			virtual void change_frame(uint64_t frame) = 0;
+
 			/// NOT thread safe
 			virtual void clear() = 0;
 
 		public:
 			/// thread safe
 			virtual void erase(Entity_handle owner) = 0;
+
+			/// NOT thread-safe; an unowned component to clone(...) from or nullptr if it can't be copied
+			virtual auto create_prototype() -> std::shared_ptr<void> = 0;
+
+			/// NOT thread-safe
+			virtual void load_prototype(void* prototype, Deserializer&) = 0;
+
+			/// NOT thread-safe; returns false if the entity already has a component of this type
+			virtual bool clone(Entity_handle owner, const void* prototype) = 0;
+
+			/// NOT thread-safe; clone(...) into each of the count owners, allocating the storage once;
+			///   cloned[i] is false if owners[i] already has a component of this type
+			virtual void clone_bulk(const Entity_handle* owners, std::size_t count, const void* prototype,
+			                        std::vector<bool>& cloned) = 0;
 			
 			///thread safe
 			virtual auto value_type()const noexcept -> Component_type = 0;
 
+			/// NOT thread-safe; memory usage and queue depths (see Entity_manager::stats)
+			virtual auto stats()const -> Component_stats = 0;
+
+			/// thread safe; true if the component provides the binary load/save_component functions
+			virtual auto binary_serializable()const noexcept -> bool = 0;
+
 			/// thread safe
 			// auto find(Entity_handle owner) -> util::maybe<T&>
 			
 			/// thread safe
-			// auto has(Entity_handle owner)const -> bool
+			virtual auto has(Entity_handle owner)const -> bool = 0;
 
 			/// thread safe
 			// void emplace(Entity_handle owner, Args&&... args);
@@ -1,6 +1,12 @@
 #pragma once
 
-#include <moodycamel/concurrentqueue.hpp>
+#include "command_buffer.hpp"
+
+#include "../utils/thread_pool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <tuple>
 
 #ifndef ECS_COMPONENT_INCLUDED
 #include "component.hpp"
@@ -17,10 +23,38 @@ namespace ecs {
 			void shrink_to_fit();
 			auto find(Entity_id)const -> util::maybe<Component_index>;
 			void clear();
+			auto memory_usage()const -> std::size_t;
 
 		private:
 			std::unordered_map<Entity_id, Component_index> _table;
 	};
+	/**
+	 * Open-addressing hash table using robin hood hashing (with backward shift deletion,
+	 *   i.e. without tombstones), so lookups are a few contiguous loads without allocations.
+	 */
+	class Flat_index_policy {
+		public:
+			void attach(Entity_id, Component_index);
+			void detach(Entity_id);
+			void shrink_to_fit();
+			auto find(Entity_id)const -> util::maybe<Component_index>;
+			void clear();
+			auto memory_usage()const -> std::size_t;
+
+		private:
+			struct Slot {
+				Entity_id owner = invalid_entity_id; //< invalid_entity_id marks empty slots
+				Component_index comp = -1;
+			};
+
+			std::vector<Slot> _slots;
+			std::size_t _mask = 0; //< _slots.size()-1
+			std::size_t _size = 0;
+
+			auto _home(Entity_id owner)const noexcept -> std::size_t;
+			auto _distance(std::size_t slot)const noexcept -> std::size_t;
+			void _rehash(std::size_t capacity);
+	};
 	class Compact_index_policy {
 		public:
 			Compact_index_policy();
@@ -29,10 +63,128 @@ namespace ecs {
 			void shrink_to_fit();
 			auto find(Entity_id)const -> util::maybe<Component_index>;
 			void clear();
+			auto memory_usage()const -> std::size_t;
 
 		private:
 			std::vector<Component_index> _table;
 	};
+	/**
+	 * Sparse set split into fixed-size pages, that are allocated on first use and freed when
+	 *   they become empty, so the memory is proportional to the ranges of live entity ids.
+	 */
+	class Paged_index_policy {
+		public:
+			void attach(Entity_id, Component_index);
+			void detach(Entity_id);
+			void shrink_to_fit();
+			auto find(Entity_id)const -> util::maybe<Component_index>;
+			void clear();
+			auto memory_usage()const -> std::size_t;
+
+		private:
+			static constexpr auto page_bits = 8;
+			static constexpr auto page_size = std::size_t(1) << page_bits;
+
+			struct Page {
+				std::array<Component_index, page_size> entries;
+				std::size_t used = 0;
+
+				Page() {entries.fill(-1);}
+			};
+
+			std::vector<std::unique_ptr<Page>> _pages;
+	};
+
+
+	/**
+	 * Dirty bits of the components of a container, indexed by their component index.
+	 * The bits are grouped by storage chunk (without sharing words between chunks), so the
+	 *   changes of a chunk can be skipped cheaply.
+	 * Changes are remembered for the last `history` frames. Older queries conservatively
+	 *   report all components as changed.
+	 */
+	class Change_tracker {
+		public:
+			static constexpr uint64_t history = 4;
+
+			explicit Change_tracker(Component_index chunk_len);
+
+			/// NOT thread-safe; makes room for the indices [0, size)
+			void reserve(Component_index size);
+			/// thread-safe (but not concurrently to reserve/frame/for_each_since); idx has to be reserved
+			void mark(Component_index idx);
+			void unmark(Component_index idx);
+			/// the component has been relocated; reported as changed at its new index
+			void moved(Component_index from, Component_index to) {
+				unmark(from);
+				mark(to);
+			}
+			void clear();
+
+			auto frame()const noexcept {return _frame;}
+			/// NOT thread-safe; advances the current frame and forgets changes older than the history
+			void frame(uint64_t frame);
+
+			auto memory_usage()const noexcept -> std::size_t {
+				auto usage = _chunk_frames.capacity() * sizeof(uint64_t);
+				for(auto& bits : _bits) {
+					usage += bits.capacity() * sizeof(uint64_t);
+				}
+				return usage;
+			}
+
+			/// true if all changes since the given frame are known
+			auto tracked_since(uint64_t since)const noexcept {
+				return since + history > _frame;
+			}
+
+			/// calls f(Component_index) for each index marked in [since, frame()]; requires tracked_since(since)
+			template<class F>
+			void for_each_since(uint64_t since, F&& f)const;
+
+		private:
+			static constexpr Component_index word_bits = 64;
+
+			Component_index _chunk_len;
+			Component_index _words_per_chunk;
+			uint64_t        _frame = 0;
+			std::array<std::vector<uint64_t>, history> _bits; //< one bitset per frame in the history
+			std::vector<uint64_t> _chunk_frames; //< last frame+1 in which a component of the chunk was marked
+
+			auto _word(Component_index idx)const noexcept -> std::size_t {
+				auto in_chunk = idx % _chunk_len;
+				return static_cast<std::size_t>((idx / _chunk_len) * _words_per_chunk + in_chunk / word_bits);
+			}
+	};
+
+	template<class F>
+	void Change_tracker::for_each_since(uint64_t since, F&& f)const {
+		INVARIANT(tracked_since(since), "Changes since frame "<<since<<" are no longer tracked");
+
+		since = std::min(since, _frame);
+		auto frames = _frame - since + 1;
+		auto chunks = _chunk_frames.size();
+
+		for(auto chunk=0ul; chunk<chunks; chunk++) {
+			if(_chunk_frames[chunk] <= since)
+				continue;
+
+			auto first_word = chunk * static_cast<std::size_t>(_words_per_chunk);
+			for(auto w=0; w<_words_per_chunk; w++) {
+				auto word = first_word + static_cast<std::size_t>(w);
+				auto bits = uint64_t(0);
+				for(auto i=uint64_t(0); i<frames; i++) {
+					bits |= _bits[(since+i) % history][word];
+				}
+
+				while(bits!=0) {
+					auto bit = static_cast<Component_index>(__builtin_ctzll(bits));
+					bits &= bits-1;
+					f(static_cast<Component_index>(chunk) * _chunk_len + w*word_bits + bit);
+				}
+			}
+		}
+	}
 
 
 	template<class T>
@@ -59,34 +211,188 @@ namespace ecs {
 			using pool_t = util::pool<T, Chunk_size, Component_index, Pool_storage_policy_value_traits<T>>;
 		public:
 			using iterator = typename pool_t::iterator;
+			static constexpr auto chunk_len = static_cast<Component_index>(Chunk_size);
 
 			template<class... Args>
 			auto emplace(Args&&... args) -> std::tuple<T&, Component_index> {
 				return _pool.emplace_back(std::forward<Args>(args)...);
 			}
 
+			void reserve(Component_index size) {
+				_pool.reserve(size);
+			}
+
+			void replace(Component_index idx, T&& new_element) {
+				_pool.replace(idx, std::move(new_element));
+			}
+
+			template<typename F>
+			void erase(Component_index idx, F&& relocate) {
+				_pool.erase(idx, std::forward<F>(relocate));
+			}
+
+			void clear() {
+				_pool.clear();
+			}
+
+			template<typename F>
+			void shrink_to_fit(F&& relocate) {
+				_pool.shrink_to_fit(std::forward<F>(relocate));
+			}
+
+			template<typename F>
+			void compact(F&& relocate) {
+				_pool.compact(std::forward<F>(relocate));
+			}
+
+			template<typename F>
+			bool compact_step(Component_index max_moves, F&& relocate) {
+				return _pool.compact_step(max_moves, std::forward<F>(relocate));
+			}
+
+			void swap(Component_index a, Component_index b) {
+				_pool.swap(a, b);
+			}
+
+			auto get(Component_index idx) -> T& {
+				return _pool.get(idx);
+			}
+
+			auto begin()noexcept -> iterator {
+				return _pool.begin();
+			}
+			auto end()noexcept -> iterator {
+				return _pool.end();
+			}
+			auto size()const -> Component_index {
+				return _pool.size();
+			}
+			auto chunk_count()const -> Component_index {
+				return _pool.chunk_count();
+			}
+			template<typename F>
+			void for_each_in_chunks(Component_index first_chunk, Component_index last_chunk, F&& f) {
+				_pool.for_each_in_chunks(first_chunk, last_chunk, std::forward<F>(f));
+			}
+			template<typename F>
+			void for_each_span(F&& f) {
+				_pool.for_each_span(std::forward<F>(f));
+			}
+			auto empty()const -> bool {
+				return _pool.empty();
+			}
+			auto allocated_chunks()const -> Component_index {
+				return _pool.allocated_chunks();
+			}
+			auto free_count()const -> Component_index {
+				return _pool.free_count();
+			}
+			auto memory_usage()const -> std::size_t {
+				return _pool.memory_usage();
+			}
+
+		private:
+			pool_t _pool;
+	};
+
+	/**
+	 * Stores the components densely (without holes) and each of the field groups Fields...
+	 *   in a separate pool with the same indices, so loops that only touch one field group
+	 *   don't have to load the rest of the component.
+	 * T has to inherit from Soa_field<F> for every F in Fields.
+	 */
+	template<std::size_t Chunk_size, class T, class... Fields>
+	class Soa_storage_policy {
+			static_assert(sizeof...(Fields)>0, "Soa_storage_policy requires at least one field group");
+
+			using pool_t = util::pool<T, Chunk_size, Component_index>;
+			template<class F>
+			using field_pool_t = util::pool<F, Chunk_size, Component_index>;
+
+		public:
+			using iterator = typename pool_t::iterator;
+			static constexpr auto chunk_len = static_cast<Component_index>(Chunk_size);
+
+			template<class... Args>
+			auto emplace(Args&&... args) -> std::tuple<T&, Component_index> {
+				auto comp = _pool.emplace_back(std::forward<Args>(args)...);
+				auto ignored = {(_field_pool<Fields>().emplace_back(), 0)...};
+				(void)ignored;
+
+				_bind(std::get<1>(comp));
+				return comp;
+			}
+
+			void reserve(Component_index size) {
+				_pool.reserve(size);
+				auto ignored = {(_field_pool<Fields>().reserve(size), 0)...};
+				(void)ignored;
+			}
+
 			void replace(Component_index idx, T&& new_element) {
 				_pool.replace(idx, std::move(new_element));
+				auto ignored = {(_field_pool<Fields>().replace(idx, Fields()), 0)...};
+				(void)ignored;
+
+				_bind(idx);
 			}
 
 			template<typename F>
 			void erase(Component_index idx, F&& relocate) {
 				_pool.erase(idx, std::forward<F>(relocate));
+				auto ignored = {(_field_pool<Fields>().erase(idx), 0)...};
+				(void)ignored;
+
+				if(idx < _pool.size()) {
+					_bind(idx);
+				}
 			}
 
 			void clear() {
 				_pool.clear();
+				auto ignored = {(_field_pool<Fields>().clear(), 0)...};
+				(void)ignored;
 			}
 
 			template<typename F>
 			void shrink_to_fit(F&& relocate) {
 				_pool.shrink_to_fit(std::forward<F>(relocate));
+				auto ignored = {(_field_pool<Fields>().shrink_to_fit(), 0)...};
+				(void)ignored;
+			}
+
+			template<typename F>
+			void compact(F&&) {
+				// the storage never contains holes
+			}
+
+			template<typename F>
+			bool compact_step(Component_index, F&& relocate) {
+				shrink_to_fit(std::forward<F>(relocate));
+				return true;
+			}
+
+			void swap(Component_index a, Component_index b) {
+				if(a!=b) {
+					_pool.swap(a, b);
+					auto ignored = {(_field_pool<Fields>().swap(a, b), 0)...};
+					(void)ignored;
+
+					_bind(a);
+					_bind(b);
+				}
 			}
 
 			auto get(Component_index idx) -> T& {
 				return _pool.get(idx);
 			}
 
+			/// the field group F of all components, with the same indices as get()
+			template<class F>
+			auto fields() -> field_pool_t<F>& {
+				return _field_pool<F>();
+			}
+
 			auto begin()noexcept -> iterator {
 				return _pool.begin();
 			}
@@ -96,12 +402,47 @@ namespace ecs {
 			auto size()const -> Component_index {
 				return _pool.size();
 			}
+			auto chunk_count()const -> Component_index {
+				return _pool.chunk_count();
+			}
+			template<typename F>
+			void for_each_in_chunks(Component_index first_chunk, Component_index last_chunk, F&& f) {
+				_pool.for_each_in_chunks(first_chunk, last_chunk, std::forward<F>(f));
+			}
+			template<typename F>
+			void for_each_span(F&& f) {
+				_pool.for_each_span(std::forward<F>(f));
+			}
 			auto empty()const -> bool {
 				return _pool.empty();
 			}
+			auto allocated_chunks()const -> Component_index {
+				return _pool.allocated_chunks();
+			}
+			auto free_count()const -> Component_index {
+				return 0;
+			}
+			auto memory_usage()const -> std::size_t {
+				auto usage = _pool.memory_usage();
+				auto ignored = {(usage += std::get<field_pool_t<Fields>>(_fields).memory_usage(), 0)...};
+				(void)ignored;
+				return usage;
+			}
 
 		private:
 			pool_t _pool;
+			std::tuple<field_pool_t<Fields>...> _fields;
+
+			template<class F>
+			auto _field_pool() -> field_pool_t<F>& {
+				return std::get<field_pool_t<F>>(_fields);
+			}
+
+			void _bind(Component_index idx) {
+				auto& comp = _pool.get(idx);
+				auto ignored = {(static_cast<Soa_field<Fields>&>(comp)._bind(_field_pool<Fields>().get(idx)), 0)...};
+				(void)ignored;
+			}
 	};
 
 
@@ -109,11 +450,13 @@ namespace ecs {
 	template<class T>
 	class Component_container : public Component_container_base {
 		friend class Entity_manager;
+		template<class...> friend class Entity_view;
+		template<class...> friend class Owning_group;
 		friend void load(sf2::JsonDeserializer& s, Entity_handle& e);
 		friend void save(sf2::JsonSerializer& s, const Entity_handle& e);
 
 		public:
-			Component_container(Entity_manager& m) : _manager(m) {
+			Component_container(Entity_manager& m) : _changes(T::storage_policy::chunk_len), _manager(m) {
 				T::_validate_type_helper();
 				_index.clear();
 			}
@@ -122,25 +465,32 @@ namespace ecs {
 				return component_type_id<T>();
 			}
 
-		protected:
-			void restore(Entity_handle owner, Deserializer& deserializer)override {
-				auto entity_id = get_entity_id(owner, _manager);
-				if(entity_id==invalid_entity_id) {
-					FAIL("emplace_or_find_now of component from invalid/deleted entity");
-				}
-
-				auto& comp = [&]() -> T& {
-					auto comp_idx =_index.find(entity_id);
-					if(comp_idx.is_some()) {
-						return _storage.get(comp_idx.get_or_throw());
-					}
+			auto stats()const -> Component_stats override {
+				auto s = Component_stats{};
+				s.name                = T::name();
+				s.type                = value_type();
+				s.size                = _storage.size();
+				s.allocated_chunks    = _storage.allocated_chunks();
+				s.storage_bytes       = _storage.memory_usage() + _changes.memory_usage();
+				s.free_slots          = _storage.free_count();
+				s.index_bytes         = _index.memory_usage();
+				s.queued_insertions   = _queued_insertions.size();
+				s.queued_deletions    = _queued_deletions.size();
+				s.unoptimized_deletes = _unoptimized_deletes;
+				s.fragmentation       = _fragmentation();
+				s.compacting          = _compacting;
+				s.fragmentation_before_compaction = _fragmentation_before_compaction;
+				s.fragmentation_after_compaction  = _fragmentation_after_compaction;
+				return s;
+			}
 
-					auto comp = _storage.emplace(_manager, owner);
-					_index.attach(entity_id, std::get<1>(comp));
-					return std::get<0>(comp);
-				}();
+			auto binary_serializable()const noexcept -> bool override {
+				return has_binary_serialization<T>::value;
+			}
 
-				load_component(deserializer, comp);
+		protected:
+			void restore(Entity_handle owner, Deserializer& deserializer)override {
+				load_component(deserializer, _emplace_or_find_now(owner));
 			}
 
 			bool save(Entity_handle owner, Serializer& serializer)override {
@@ -151,99 +501,289 @@ namespace ecs {
 				});
 			}
 
+			void restore(Entity_handle owner, Binary_reader& reader)override {
+				_restore_binary(owner, reader, has_binary_serialization<T>{});
+			}
+
+			bool save(Entity_handle owner, Binary_writer& writer)override {
+				return _save_binary(owner, writer, has_binary_serialization<T>{});
+			}
+
 			void clear() override {
-				_queued_deletions = Queue<Entity_handle>{}; // clear by moving a new queue into the old
-				_queued_insertions = Queue<Insertion>{}; // clear by moving a new queue into the old
+				_queued_deletions.clear();
+				_queued_insertions.clear();
 				_index.clear();
 				_storage.clear();
+				_changes.clear();
+				_erased.clear();
+				_erased_tracked_since = _changes.frame()+1;
 				_unoptimized_deletes = 0;
+				_compacting = false;
 				_index.shrink_to_fit();
-				_storage.shrink_to_fit([&](auto, auto& comp, auto new_idx) {
+				_storage.shrink_to_fit([&](auto old_idx, auto& comp, auto new_idx) {
 					_index.attach(comp.owner_handle().id(), new_idx);
+					_changes.moved(old_idx, new_idx);
+				});
+				_structural_revision++;
+			}
+
+			void change_frame(uint64_t frame) override {
+				_changes.frame(frame);
+
+				// forget the erasures that fell out of the history (see for_each_erased)
+				auto outdated = std::find_if(_erased.begin(), _erased.end(), [&](auto& e) {
+					return std::get<0>(e) + Change_tracker::history > frame;
 				});
+				_erased.erase(_erased.begin(), outdated);
+			}
+
+			void merge_commands(Command_list_base& list) override {
+				auto& commands = static_cast<Command_list<T>&>(list);
+				_append(_queued_deletions, commands.deletions);
+				_append(_queued_insertions, commands.insertions);
+			}
+
+			void merge_erased(const std::vector<Entity_handle>& entities) override {
+				_queued_deletions.insert(_queued_deletions.end(), entities.begin(), entities.end());
 			}
 
 			void process_queued_actions() override {
+				auto size_before = _storage.size();
+
 				process_deletions();
 				process_insertions();
 
 				if(_unoptimized_deletes>32) {
 					_unoptimized_deletes = 0;
+					if(!_compacting) {
+						_compacting = true;
+						_fragmentation_before_compaction = _fragmentation();
+					}
+				}
+				if(_compacting) {
+					_compaction_step();
+				}
+
+				if(size_before!=_storage.size() || _structural_changes_pending) {
+					_structural_changes_pending = false;
+					_structural_revision++;
+				}
+			}
+
+			// used by views & groups; NOT thread-safe; doesn't validate the entity
+			auto _find_by_id(Entity_id entity_id) -> T* {
+				return _index.find(entity_id).process(static_cast<T*>(nullptr), [&](auto comp_idx) {
+					return &_storage.get(comp_idx);
+				});
+			}
+			auto _get_by_index(Component_index idx) -> T& {
+				return _storage.get(idx);
+			}
+			auto _index_of(Entity_id entity_id)const -> util::maybe<Component_index> {
+				return _index.find(entity_id);
+			}
+			auto _fragmentation()const -> float {
+				auto free = _storage.free_count();
+				return free>0 ? static_cast<float>(free) / static_cast<float>(_storage.size()+free) : 0.f;
+			}
+			// fills up to get_compaction_budget(...) holes per frame, until the storage is compact
+			void _compaction_step() {
+				auto moved = false;
+				_compacting = !_storage.compact_step(get_compaction_budget(_manager),
+				                                     [&](auto old_idx, auto& comp, auto new_idx) {
+					_index.attach(comp.owner_handle().id(), new_idx);
+					_changes.moved(old_idx, new_idx);
+					moved = true;
+				});
+
+				if(moved) {
+					_structural_changes_pending = true;
+				}
+				if(!_compacting) {
 					_index.shrink_to_fit();
-					_storage.shrink_to_fit([&](auto, auto& comp, auto new_idx) {
-						_index.attach(comp.owner_handle().id(), new_idx);
-					});
+					_fragmentation_after_compaction = _fragmentation();
+				}
+			}
+
+			// removes all holes from the storage, so [0, size()) are valid indices
+			void _compact() {
+				_storage.compact([&](auto old_idx, auto& comp, auto new_idx) {
+					_index.attach(comp.owner_handle().id(), new_idx);
+					_changes.moved(old_idx, new_idx);
+				});
+			}
+			void _swap(Component_index a, Component_index b) {
+				if(a!=b) {
+					_storage.swap(a, b);
+					_index.attach(_storage.get(a).owner_handle().id(), a);
+					_index.attach(_storage.get(b).owner_handle().id(), b);
+					_changes.mark(a);
+					_changes.mark(b);
+				}
+			}
+			// marks the component as changed, because the callers modify it
+			auto _emplace_or_find_now(Entity_handle owner) -> T& {
+				auto entity_id = get_entity_id(owner, _manager);
+				if(entity_id==invalid_entity_id) {
+					FAIL("emplace_or_find_now of component from invalid/deleted entity");
+				}
+
+				auto comp_idx =_index.find(entity_id);
+				if(comp_idx.is_some()) {
+					_changes.mark(comp_idx.get_or_throw());
+					return _storage.get(comp_idx.get_or_throw());
+				}
+
+				auto comp = _storage.emplace(_manager, owner);
+				_index.attach(entity_id, std::get<1>(comp));
+				_mark_inserted(std::get<1>(comp));
+				_structural_revision++;
+				return std::get<0>(comp);
+			}
+
+			void _restore_binary(Entity_handle owner, Binary_reader& reader, std::true_type) {
+				load_component(reader, _emplace_or_find_now(owner));
+			}
+			void _restore_binary(Entity_handle, Binary_reader&, std::false_type) {
+				FAIL("binary restore of component "<<T::name()<<", that has no binary serialization");
+			}
+			bool _save_binary(Entity_handle owner, Binary_writer& writer, std::true_type) {
+				return find(owner).process(false, [&](T& comp) {
+					save_component(writer, static_cast<const T&>(comp));
+					return true;
+				});
+			}
+			bool _save_binary(Entity_handle, Binary_writer&, std::false_type) {
+				FAIL("binary save of component "<<T::name()<<", that has no binary serialization");
+			}
+
+			auto _create_prototype(std::true_type) -> std::shared_ptr<void> {
+				return std::make_shared<T>(_manager, invalid_entity);
+			}
+			auto _create_prototype(std::false_type) -> std::shared_ptr<void> {
+				return {};
+			}
+
+			bool _clone(Entity_handle owner, const void* prototype, std::true_type) {
+				auto entity_id = get_entity_id(owner, _manager);
+				if(entity_id==invalid_entity_id) {
+					FAIL("clone of component to invalid/deleted entity");
+				}
+
+				if(_index.find(entity_id).is_some()) {
+					return false;
+				}
+
+				auto comp = _storage.emplace(*static_cast<const T*>(prototype));
+				std::get<0>(comp)._manager = &_manager;
+				std::get<0>(comp)._owner = owner;
+				_index.attach(entity_id, std::get<1>(comp));
+				_mark_inserted(std::get<1>(comp));
+				_structural_revision++;
+				return true;
+			}
+			bool _clone(Entity_handle, const void*, std::false_type) {
+				FAIL("clone of component "<<T::name()<<", that isn't copy-constructible");
+			}
+			void _clone_bulk(const Entity_handle* owners, std::size_t count, const void* prototype,
+			                 std::vector<bool>& cloned, std::true_type) {
+				_storage.reserve(_storage.size() + static_cast<Component_index>(count));
+
+				cloned.resize(count);
+				for(auto i=0ul; i<count; i++) {
+					cloned[i] = _clone(owners[i], prototype, std::true_type{});
+				}
+			}
+			void _clone_bulk(const Entity_handle*, std::size_t, const void*, std::vector<bool>&, std::false_type) {
+				FAIL("clone of component "<<T::name()<<", that isn't copy-constructible");
+			}
+
+			/// incremented by process_queued_actions every time components have been added or removed
+			auto _revision()const noexcept {return _structural_revision;}
+
+			void _mark_inserted(Component_index idx) {
+				_changes.reserve(idx+1);
+				_changes.mark(idx);
+			}
+
+			template<class E>
+			static void _append(std::vector<E>& dest, std::vector<E>& src) {
+				if(dest.empty()) {
+					dest.swap(src); // the recording thread gets our processed (empty) list and its capacity
+				} else {
+					dest.insert(dest.end(), std::make_move_iterator(src.begin()), std::make_move_iterator(src.end()));
+					src.clear();
 				}
 			}
 
 			void process_deletions() {
-				std::array<Entity_handle, 16> deletions_buffer;
-
-				do {
-					std::size_t deletions = _queued_deletions.try_dequeue_bulk(deletions_buffer.data(),
-					                                                           deletions_buffer.size());
-					if(deletions>0) {
-						for(auto i=0ull; i<deletions; i++) {
-							auto entity_id = get_entity_id(deletions_buffer[i], _manager);
-							if(entity_id==invalid_entity_id) {
-								WARN("Discard delete of component "<<T::name()<<" from invalid/deleted entity: "<<entity_name(deletions_buffer[i]));
-								continue;
-							}
-
-							auto comp_idx_mb = _index.find(entity_id);
-							if(!comp_idx_mb) {
-								continue;
-							}
-
-							auto comp_idx = comp_idx_mb.get_or_throw();
-							_index.detach(entity_id);
-
-							Insertion insertion;
-							if(_queued_insertions.try_dequeue(insertion)) {
-								auto entity_id = get_entity_id(std::get<1>(insertion), _manager);
-								if(entity_id==invalid_entity_id) {
-									_storage.erase(comp_idx, [&](auto, auto& comp, auto new_idx) {
-										_index.attach(comp.owner_handle().id(), new_idx);
-									});
-
-								} else {
-									_storage.replace(comp_idx, std::move(std::get<0>(insertion)));
-									_index.attach(std::get<1>(insertion).id(), comp_idx);
-								}
-							} else {
-								_storage.erase(comp_idx, [&](auto, auto& comp, auto new_idx) {
-									auto entity_id = get_entity_id(comp.owner_handle(), _manager);
-									_index.attach(entity_id, new_idx);
-								});
-								_unoptimized_deletes++;
-							}
+				for(auto owner : _queued_deletions) {
+					auto entity_id = get_entity_id(owner, _manager);
+					if(entity_id==invalid_entity_id) {
+						WARN("Discard delete of component "<<T::name()<<" from invalid/deleted entity: "<<entity_name(owner));
+						continue;
+					}
+
+					auto comp_idx_mb = _index.find(entity_id);
+					if(!comp_idx_mb) {
+						continue;
+					}
+
+					auto comp_idx = comp_idx_mb.get_or_throw();
+					_index.detach(entity_id);
+					_erased.emplace_back(_changes.frame(), owner);
+
+					if(!_queued_insertions.empty()) {
+						auto insertion = std::move(_queued_insertions.back());
+						_queued_insertions.pop_back();
+
+						auto entity_id = get_entity_id(std::get<1>(insertion), _manager);
+						if(entity_id==invalid_entity_id) {
+							_changes.unmark(comp_idx);
+							_storage.erase(comp_idx, [&](auto old_idx, auto& comp, auto new_idx) {
+								_index.attach(comp.owner_handle().id(), new_idx);
+								_changes.moved(old_idx, new_idx);
+							});
+
+						} else {
+							_storage.replace(comp_idx, std::move(std::get<0>(insertion)));
+							_changes.mark(comp_idx);
+							_index.attach(std::get<1>(insertion).id(), comp_idx);
+							_structural_changes_pending = true;
 						}
 					} else {
-						break;
+						_changes.unmark(comp_idx);
+						_storage.erase(comp_idx, [&](auto old_idx, auto& comp, auto new_idx) {
+							auto entity_id = get_entity_id(comp.owner_handle(), _manager);
+							_index.attach(entity_id, new_idx);
+							_changes.moved(old_idx, new_idx);
+						});
+						_unoptimized_deletes++;
 					}
-				} while(true);
+				}
+
+				_queued_deletions.clear();
 			}
 			void process_insertions() {
-				std::array<Insertion, 8> insertions_buffer;
-
-				do {
-					std::size_t insertions = _queued_insertions.try_dequeue_bulk(insertions_buffer.data(),
-					                                                             insertions_buffer.size());
-					if(insertions>0) {
-						for(auto i=0ull; i<insertions; i++) {
-							auto entity_id = get_entity_id(std::get<1>(insertions_buffer[i]), _manager);
-							if(entity_id==invalid_entity_id) {
-								WARN("Discard insertion of component from invalid/deleted entity: "<<entity_name(std::get<1>(insertions_buffer[i])));
-								continue;
-							}
-
-							auto comp = _storage.emplace(std::move(std::get<0>(insertions_buffer[i])));
-							_index.attach(entity_id, std::get<1>(comp));
-						}
-					} else {
-						break;
+				if(_queued_insertions.empty())
+					return;
+
+				// allocate the storage for all insertions (e.g. from emplace_bulk) up front
+				_storage.reserve(_storage.size() + static_cast<Component_index>(_queued_insertions.size()));
+
+				for(auto& insertion : _queued_insertions) {
+					auto entity_id = get_entity_id(std::get<1>(insertion), _manager);
+					if(entity_id==invalid_entity_id) {
+						WARN("Discard insertion of component from invalid/deleted entity: "<<entity_name(std::get<1>(insertion)));
+						continue;
 					}
-				} while(true);
+
+					auto comp = _storage.emplace(std::move(std::get<0>(insertion)));
+					_index.attach(entity_id, std::get<1>(comp));
+					_mark_inserted(std::get<1>(comp));
+				}
+
+				_queued_insertions.clear();
 			}
 
 		public:
@@ -256,12 +796,47 @@ namespace ecs {
 				                      std::forward_as_tuple(_manager, owner, std::forward<Args>(args)...),
 				                      std::forward_as_tuple(owner));
 				std::forward<F>(init)(inst.first);
-				_queued_insertions.enqueue(std::move(inst));
+				get_command_buffer(_manager).list<T>().insertions.push_back(std::move(inst));
+			}
+
+			/**
+			 * Queues a component for each of the count owners as one block.
+			 * init = func(T&, index:std::size_t)->void
+			 */
+			template<typename F, typename... Args>
+			void emplace_bulk(F&& init, const Entity_handle* owners, std::size_t count, const Args&... args) {
+				auto& insertions = get_command_buffer(_manager).list<T>().insertions;
+				insertions.reserve(insertions.size() + count);
+
+				for(auto i=0ul; i<count; i++) {
+					INVARIANT(owners[i]!=invalid_entity, "emplace_bulk on invalid entity");
+
+					insertions.emplace_back(std::piecewise_construct,
+					                        std::forward_as_tuple(_manager, owners[i], args...),
+					                        std::forward_as_tuple(owners[i]));
+					init(insertions.back().first, i);
+				}
 			}
 
 			void erase(Entity_handle owner)override {
 				INVARIANT(owner, "erase on invalid entity");
-				_queued_deletions.enqueue(owner);
+				get_command_buffer(_manager).list<T>().deletions.push_back(owner);
+			}
+
+			auto create_prototype() -> std::shared_ptr<void> override {
+				return _create_prototype(std::is_copy_constructible<T>{});
+			}
+
+			void load_prototype(void* prototype, Deserializer& deserializer)override {
+				load_component(deserializer, *static_cast<T*>(prototype));
+			}
+
+			bool clone(Entity_handle owner, const void* prototype)override {
+				return _clone(owner, prototype, std::is_copy_constructible<T>{});
+			}
+			void clone_bulk(const Entity_handle* owners, std::size_t count, const void* prototype,
+			                std::vector<bool>& cloned)override {
+				_clone_bulk(owners, count, prototype, cloned, std::is_copy_constructible<T>{});
 			}
 
 			auto find(Entity_handle owner) -> util::maybe<T&> {
@@ -271,12 +846,25 @@ namespace ecs {
 					return util::justPtr(&_storage.get(comp_idx));
 				});
 			}
-			auto has(Entity_handle owner)const -> bool {
+			auto has(Entity_handle owner)const -> bool override {
 				auto entity_id = get_entity_id(owner, _manager);
 
 				return _index.find(entity_id).is_some();
 			}
 
+			/// bulk lookup for joins (see Entity_view): out[i] is the component of the entity ids[i]
+			///   or nullptr; NOT thread-safe; doesn't validate the entities
+			void find_all(const Entity_id* ids, std::size_t count, T** out) {
+				for(auto i=std::size_t(0); i<count; i++) {
+					out[i] = _find_by_id(ids[i]);
+				}
+			}
+
+			/// changes every time components have been added, removed or relocated
+			auto structural_revision()const noexcept {
+				return _revision();
+			}
+
 			auto begin()noexcept {
 				return _storage.begin();
 			}
@@ -289,22 +877,107 @@ namespace ecs {
 			auto empty()const noexcept {
 				return _storage.empty();
 			}
-			
+
+			/**
+			 * Calls f(T&) for all components, distributed over the engines thread pool by storage chunk.
+			 * f may only modify the passed component (and other state owned by its entity) and
+			 *   must only use the deferred ECS operations. NOT thread-safe.
+			 */
+			template<typename F>
+			void parallel_for_each(F&& f) {
+				get_thread_pool(_manager).parallel_for(_storage.chunk_count(), [&](auto first, auto last) {
+					_storage.for_each_in_chunks(static_cast<Component_index>(first),
+					                            static_cast<Component_index>(last), f);
+				});
+			}
+
+			/**
+			 * Marks the component as changed in the current frame (see for_each_changed).
+			 * Changes can't be detected automatically, so code modifying the tracked state of a
+			 *   component has to call this (or Component::mark_changed).
+			 * Thread-safe for concurrent marks, but not concurrently to process_queued_actions,
+			 *   change_frame or for_each_changed.
+			 */
+			void mark_changed(const T& comp) {
+				if(comp._owner) {
+					_index.find(comp._owner.id()).process([&](auto comp_idx) {
+						_changes.mark(comp_idx);
+					});
+				}
+			}
+			void mark_changed(Entity_handle owner) {
+				_index.find(get_entity_id(owner, _manager)).process([&](auto comp_idx) {
+					_changes.mark(comp_idx);
+				});
+			}
+
+			/**
+			 * Calls f(T&) for all components, that have been inserted or marked as changed since
+			 *   the given frame (inclusive, see Entity_manager::change_frame).
+			 * If the frame is older than the tracked history, f is called for all components.
+			 * Components may be reported more than once per frame range (e.g. after they have
+			 *   been relocated). NOT thread-safe.
+			 */
+			template<typename F>
+			void for_each_changed(uint64_t since_frame, F&& f) {
+				if(!_changes.tracked_since(since_frame)) {
+					for(auto& comp : *this) {
+						f(comp);
+					}
+					return;
+				}
+
+				_changes.for_each_since(since_frame, [&](auto comp_idx) {
+					f(_storage.get(comp_idx));
+				});
+			}
+
+			/**
+			 * Calls f(Entity_handle) for the owners of all components, that have been removed since
+			 *   the given frame (inclusive, see Entity_manager::change_frame). The owner might have
+			 *   got a new component since then.
+			 * Returns false without calling f, if the frame is older than the tracked history or
+			 *   the container has been cleared since. NOT thread-safe.
+			 */
+			template<typename F>
+			bool for_each_erased(uint64_t since_frame, F&& f) {
+				if(!_changes.tracked_since(since_frame) || since_frame<_erased_tracked_since) {
+					return false;
+				}
+
+				for(auto& e : _erased) {
+					if(std::get<0>(e)>=since_frame) {
+						f(std::get<1>(e));
+					}
+				}
+				return true;
+			}
+
+			/// direct access to the storage policy (e.g. Soa_storage_policy::fields); NOT thread-safe
+			auto storage()noexcept -> typename T::storage_policy& {
+				return _storage;
+			}
+
 			using iterator = typename T::storage_policy::iterator;
 
 		private:
-			using Insertion = std::pair<T,Entity_handle>;
-
-			template<class E>
-			using Queue = moodycamel::ConcurrentQueue<E>;
+			using Insertion = typename Command_list<T>::Insertion;
 
 			typename T::index_policy   _index;
 			typename T::storage_policy _storage;
-
-			Entity_manager&      _manager;
-			Queue<Entity_handle> _queued_deletions;
-			Queue<Insertion>     _queued_insertions;
-			int                  _unoptimized_deletes = 0;
+			Change_tracker             _changes;
+			std::vector<std::tuple<uint64_t, Entity_handle>> _erased; //< frame and owner of removed components
+			uint64_t                   _erased_tracked_since = 0;
+
+			Entity_manager&            _manager;
+			std::vector<Entity_handle> _queued_deletions;  //< merged from the command buffers
+			std::vector<Insertion>     _queued_insertions; //< merged from the command buffers
+			int                        _unoptimized_deletes = 0;
+			bool                       _compacting = false;
+			float                      _fragmentation_before_compaction = 0.f;
+			float                      _fragmentation_after_compaction = 0.f;
+			uint64_t                   _structural_revision = 0;
+			bool                       _structural_changes_pending = false;
 	};
 
 }
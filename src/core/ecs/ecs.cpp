@@ -11,30 +11,108 @@
 #include <sf2/sf2.hpp>
 
 #include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <sstream>
 #include <stdexcept>
 #include <iostream>
 
 
 
 namespace lux {
+namespace util {
+	sf2_structDef(Chunk_allocator_stats,
+		allocations,
+		deallocations,
+		reused,
+		system_allocations,
+		used_bytes,
+		cached_bytes,
+		huge_page_bytes
+	)
+}
+
 namespace ecs {
 
+	namespace {
+		std::atomic<uint64_t> next_manager_id{1};
+
+		// the command buffer of the manager, that has been used last by this thread
+		thread_local uint64_t cached_buffer_manager = 0;
+		thread_local Command_buffer* cached_buffer = nullptr;
+	}
+
 	Entity_manager::Entity_manager(User_data& ud)
-		: _userdata(ud) {
+		: Entity_manager(ud.thread_pool(), &ud.assets()) {
+
+		_userdata = &ud;
+	}
+	Entity_manager::Entity_manager(util::Thread_pool& thread_pool, asset::Asset_manager* assets)
+		: _thread_pool(thread_pool), _assets(assets), _id(next_manager_id++) {
 
 		init_serializer(*this);
 	}
 
+	auto get_thread_pool(Entity_manager& manager) -> util::Thread_pool& {
+		return manager.thread_pool();
+	}
+	auto get_compaction_budget(Entity_manager& manager) -> Component_index {
+		return manager.compaction_budget();
+	}
+	auto get_command_buffer(Entity_manager& manager) -> Command_buffer& {
+		if(cached_buffer_manager==manager._id) {
+			return *cached_buffer;
+		}
+
+		return manager._command_buffer();
+	}
+
+	auto Entity_manager::_command_buffer() -> Command_buffer& {
+		auto thread = std::this_thread::get_id();
+
+		std::lock_guard<std::mutex> lock(_command_buffers_mutex);
+
+		auto iter = std::find_if(_command_buffers.begin(), _command_buffers.end(), [&](auto& entry) {
+			return entry.first==thread;
+		});
+		if(iter==_command_buffers.end()) {
+			_command_buffers.emplace_back(thread, std::make_unique<Command_buffer>());
+			iter = _command_buffers.end() - 1;
+		}
+
+		cached_buffer_manager = _id;
+		cached_buffer = iter->second.get();
+		return *cached_buffer;
+	}
+
+	auto Entity_manager::_asset_manager() -> asset::Asset_manager& {
+		INVARIANT(_assets, "Entity_manager has been created without an Asset_manager");
+		return *_assets;
+	}
+
 	Entity_facet Entity_manager::emplace()noexcept {
 		return {*this, _handles.get_new()};
 	}
 	Entity_facet Entity_manager::emplace(const std::string& blueprint) {
 		auto e = emplace();
 
-		apply_blueprint(_userdata.assets(), e, blueprint);
+		apply_blueprint(_asset_manager(), e, blueprint);
 
 		return {*this, e.handle()};
 	}
+	auto Entity_manager::emplace_bulk(std::size_t count) -> Entity_batch {
+		auto handles = std::vector<Entity_handle>(count);
+		_handles.get_new(handles.data(), count);
+
+		return {*this, std::move(handles)};
+	}
+	auto Entity_manager::emplace_bulk(std::size_t count, const std::string& blueprint) -> Entity_batch {
+		auto batch = emplace_bulk(count);
+
+		apply_blueprint(_asset_manager(), batch, blueprint);
+
+		return batch;
+	}
 
 	auto Entity_manager::get(Entity_handle entity) -> util::maybe<Entity_facet> {
 		if(validate(entity))
@@ -45,7 +123,7 @@ namespace ecs {
 
 	void Entity_manager::erase(Entity_handle entity) {
 		if(validate(entity)) {
-			_queue_erase.enqueue(entity);
+			get_command_buffer(*this).erase(entity);
 		} else {
 			ERROR("Double-Deletion of entity "<<entity_name(entity));
 		}
@@ -54,50 +132,136 @@ namespace ecs {
 	void Entity_manager::process_queued_actions() {
 		INVARIANT(_local_queue_erase.empty(), "Someone's been sleeping in my bed! (_local_queue_erase is dirty)");
 
-		std::array<Entity_handle, 32> erase_buffer;
-		do {
-			std::size_t count = _queue_erase.try_dequeue_bulk(erase_buffer.data(), erase_buffer.size());
+		// merge the operations recorded by all threads in one pass
+		std::unique_lock<std::mutex> buffers_lock(_command_buffers_mutex);
+		for(auto& entry : _command_buffers) {
+			auto& buffer = *entry.second;
 
-			if(count>0) {
-				for(std::size_t i=0; i<count; i++) {
-					const auto h = erase_buffer[i];
-					_local_queue_erase.emplace_back(h);
+			_local_queue_erase.insert(_local_queue_erase.end(), buffer._erased_entities.begin(),
+			                          buffer._erased_entities.end());
+			buffer._erased_entities.clear();
 
-					for(auto& component : _components) {
-						if(component)
-							component->erase(h);
-					}
+			for(auto type=0u; type<buffer._lists.size(); type++) {
+				auto& list = buffer._lists[type];
+				if(list && !list->empty()) {
+					_components[type]->merge_commands(*list);
 				}
+			}
+		}
+		buffers_lock.unlock();
 
-			} else {
-				break;
+		if(!_local_queue_erase.empty()) {
+			for(auto& component : _components) {
+				if(component)
+					component->merge_erased(_local_queue_erase);
 			}
-		} while(true);
+		}
 
 		for(auto& component : _components) {
 			if(component)
 				component->process_queued_actions();
 		}
 
+		for(auto& group : _groups) {
+			group->update();
+		}
+
 		for(auto h : _local_queue_erase) {
 			_handles.free(h);
 		}
 		_local_queue_erase.clear();
 	}
 
+	void Entity_manager::next_change_frame() {
+		_change_frame++;
+
+		for(auto& component : _components) {
+			if(component)
+				component->change_frame(_change_frame);
+		}
+	}
+
+	auto Entity_manager::stats()const -> Ecs_stats {
+		auto s = Ecs_stats{};
+		s.used_slots = _handles.used_slots();
+		s.allocated_slots = _handles.allocated_slots();
+		s.free_handles = _handles.free_count();
+
+		s.components.reserve(_components.size());
+		for(auto& component : _components) {
+			if(component)
+				s.components.push_back(component->stats());
+		}
+
+		// operations that have been recorded but not merged, yet
+		std::lock_guard<std::mutex> lock(_command_buffers_mutex);
+		for(auto& entry : _command_buffers) {
+			for(auto type=0u; type<entry.second->_lists.size(); type++) {
+				auto& list = entry.second->_lists[type];
+				auto comp = std::find_if(s.components.begin(), s.components.end(), [&](auto& c) {
+					return c.type==static_cast<Component_type>(type);
+				});
+				if(list && comp!=s.components.end()) {
+					comp->queued_insertions += list->insertion_count();
+					comp->queued_deletions += list->deletions.size();
+				}
+			}
+		}
+
+		s.chunks = util::chunk_allocator_stats();
+
+		return s;
+	}
+
+	sf2_structDef(Component_stats,
+		name,
+		type,
+		size,
+		allocated_chunks,
+		storage_bytes,
+		free_slots,
+		index_bytes,
+		queued_insertions,
+		queued_deletions,
+		unoptimized_deletes,
+		fragmentation,
+		compacting,
+		fragmentation_before_compaction,
+		fragmentation_after_compaction
+	)
+	sf2_structDef(Ecs_stats,
+		used_slots,
+		allocated_slots,
+		free_handles,
+		components,
+		chunks
+	)
+
+	void save_stats(std::ostream& stream, const Ecs_stats& stats) {
+		sf2::serialize_json(stream, stats);
+	}
+
 	void Entity_manager::clear() {
 		for(auto& component : _components)
 			if(component)
 				component->clear();
 
 		_handles.clear();
-		_queue_erase = Erase_queue{};
+
+		std::lock_guard<std::mutex> lock(_command_buffers_mutex);
+		for(auto& entry : _command_buffers) {
+			for(auto& list : entry.second->_lists) {
+				if(list)
+					list->clear();
+			}
+			entry.second->_erased_entities.clear();
+		}
 	}
 
 
 	auto Entity_manager::write_one(Entity_handle source) -> ETO {
 		std::stringstream stream;
-		auto serializer = Serializer{stream, *this, _userdata.assets(), {}};
+		auto serializer = Serializer{stream, *this, _asset_manager(), {}};
 		serializer.write(source);
 		stream.flush();
 
@@ -109,14 +273,130 @@ namespace ecs {
 		}
 
 		std::istringstream stream{data};
-		auto deserializer = Deserializer{"$EntityRestore", stream, *this, _userdata.assets(), {}};
+		auto deserializer = Deserializer{"$EntityRestore", stream, *this, _asset_manager(), {}};
 		deserializer.read(target);
 		return {*this, target};
 	}
 
+	/*
+	 * Layout of a snapshot entry:
+	 *   uint32_t             size of the JSON of all components without binary serialization
+	 *                          (0 if the entity has none of them)
+	 *   char[]               JSON
+	 *   uint16_t             number of binary components
+	 *   for each binary component:
+	 *     Component_type     type
+	 *     uint32_t           size of the component data
+	 *     char[]             component data
+	 */
+	auto Entity_manager::snapshot(const std::vector<Entity_handle>& sources) -> Snapshot {
+		auto target = Snapshot{};
+		for(auto source : sources) {
+			snapshot(source, target);
+		}
+		return target;
+	}
+	void Entity_manager::snapshot(Entity_handle source, Snapshot& target) {
+		auto& data = target._data;
+		auto writer = Binary_writer{data};
+
+		auto patch = [&](std::size_t offset, auto value) {
+			std::memcpy(data.data()+offset, &value, sizeof(value));
+		};
+
+		auto has_json = std::any_of(_components.begin(), _components.end(), [&](auto& container) {
+			return container && !container->binary_serializable() && container->has(source);
+		});
+
+		auto json_size_offset = data.size();
+		writer.write(uint32_t(0));
+		if(has_json) {
+			// appends to the buffer instead of going through std::string
+			struct Buffer_appender : std::streambuf {
+				std::vector<char>& data;
+				Buffer_appender(std::vector<char>& data) : data(data) {}
+				auto overflow(int_type c) -> int_type override {
+					if(c!=traits_type::eof()) {
+						data.push_back(static_cast<char>(c));
+					}
+					return c;
+				}
+				auto xsputn(const char* s, std::streamsize n) -> std::streamsize override {
+					data.insert(data.end(), s, s+n);
+					return n;
+				}
+			};
+			Buffer_appender buffer{data};
+			std::ostream stream{&buffer};
+			auto serializer = Serializer{stream, *this, _asset_manager(), [&](Component_type type) {
+				return !list(type).binary_serializable();
+			}};
+			serializer.write(source);
+			stream.flush();
+
+			patch(json_size_offset, static_cast<uint32_t>(data.size() - json_size_offset - sizeof(uint32_t)));
+		}
+
+		auto count_offset = data.size();
+		auto count = uint16_t(0);
+		writer.write(count);
+
+		for(auto& container : _components) {
+			if(!container || !container->binary_serializable())
+				continue;
+
+			auto entry_offset = data.size();
+			writer.write(container->value_type());
+			writer.write(uint32_t(0));
+
+			if(container->save(source, writer)) {
+				patch(entry_offset+sizeof(Component_type),
+				      static_cast<uint32_t>(data.size() - entry_offset - sizeof(Component_type) - sizeof(uint32_t)));
+				count++;
+			} else {
+				data.resize(entry_offset);
+			}
+		}
+		patch(count_offset, count);
+
+		target._entities++;
+	}
+	void Entity_manager::restore(const Snapshot& snapshot) {
+		auto reader = Binary_reader{snapshot._data.data(), snapshot._data.data()+snapshot._data.size()};
+
+		for(auto i=0; i<snapshot._entities; i++) {
+			auto target = emplace().handle();
+
+			// JSON first, so a blueprint applied by it doesn't override the binary components
+			auto json_size = uint32_t(0);
+			reader.read(json_size);
+			if(json_size>0) {
+				std::istringstream stream{std::string(reader.position, json_size)};
+				auto deserializer = Deserializer{"$Snapshot", stream, *this, _asset_manager(), {}};
+				deserializer.read(target);
+				reader.position += json_size;
+			}
+
+			auto count = uint16_t(0);
+			reader.read(count);
+			for(auto j=0; j<count; j++) {
+				auto type = Component_type(0);
+				auto size = uint32_t(0);
+				reader.read(type);
+				reader.read(size);
+
+				auto component_reader = Binary_reader{reader.position, reader.position+size};
+				list(type).restore(target, component_reader);
+				INVARIANT(component_reader.position==reader.position+size,
+				          "Size mismatch in binary snapshot of component "<<type);
+				reader.position += size;
+			}
+		}
+	}
+
 	void Entity_manager::write(std::ostream& stream, Component_filter filter) {
 
-		auto serializer = Serializer{stream, *this, _userdata.assets(), filter};
+		auto serializer = Serializer{stream, *this, _asset_manager(), filter};
 		auto entities = Entity_collection_facet{*this};
 		serializer.write_virtual(
 			sf2::vmember("entities", entities)
@@ -129,7 +409,7 @@ namespace ecs {
 	                           const std::vector<Entity_handle>& entities,
 	                           Component_filter filter) {
 
-		auto serializer = Serializer{stream, *this, _userdata.assets(), filter};
+		auto serializer = Serializer{stream, *this, _asset_manager(), filter};
 		serializer.write_virtual(
 			sf2::vmember("entities", entities)
 		);
@@ -142,7 +422,7 @@ namespace ecs {
 			this->clear();
 		}
 
-		auto deserializer = Deserializer{"$EntityDump", stream, *this, _userdata.assets(), filter};
+		auto deserializer = Deserializer{"$EntityDump", stream, *this, _asset_manager(), filter};
 		auto entities = Entity_collection_facet{*this};
 		deserializer.read_virtual(
 			sf2::vmember("entities", entities)
@@ -155,10 +435,10 @@ namespace ecs {
 	}
 	
 	Entity_iterator Entity_collection_facet::begin()const {
-		return Entity_iterator(_manager._handles, _manager._handles.next());
+		return _manager._handles.alive().begin();
 	}
 	Entity_iterator Entity_collection_facet::end()const {
-		return Entity_iterator(_manager._handles, invalid_entity);
+		return _manager._handles.alive().end();
 	}
 	void Entity_collection_facet::clear() {
 		_manager.clear();
@@ -9,23 +9,27 @@
 
 #define ECS_INCLUDED
 
+#include "command_buffer.hpp"
 #include "component.hpp"
 #include "types.hpp"
+#include "view.hpp"
 
 #include "../utils/log.hpp"
 #include "../utils/maybe.hpp"
 #include "../utils/string_utils.hpp"
 #include "../utils/template_utils.hpp"
 
-#include <moodycamel/concurrentqueue.hpp>
-
 #include <unordered_map>
 #include <vector>
 #include <string>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 
 namespace lux {
+	namespace asset {class Asset_manager;}
+
 namespace ecs {
 	struct Serializer;
 
@@ -33,17 +37,43 @@ namespace ecs {
 	// entity transfer object
 	using ETO = std::string;
 
+	/// binary copy of a set of entities, that is only valid for the running process
+	class Snapshot {
+		public:
+			auto entities()const noexcept {return _entities;}
+			auto empty()const noexcept {return _entities==0;}
+			auto bytes()const noexcept {return _data.size();}
+			void clear()noexcept {
+				_data.clear();
+				_entities = 0;
+			}
+
+		private:
+			friend class Entity_manager;
+
+			std::vector<char> _data;
+			int32_t _entities = 0;
+	};
+
 	/**
 	 * The main functionality is thread-safe but the other methods require a lock to prevent
-	 *   concurrent read access during their execution
+	 *   concurrent read access during their execution.
+	 * The deferred operations are recorded into per-thread command buffers, that are merged by
+	 *   process_queued_actions and read by stats and clear. So they must not be recorded while
+	 *   one of these is running (e.g. only from the stages of a System_scheduler).
 	 */
 	class Entity_manager : util::no_copy_move {
 		public:
 			Entity_manager(User_data& userdata);
+			/// without an Engine (e.g. for tests); blueprints and serialization require the assets
+			Entity_manager(util::Thread_pool& thread_pool, asset::Asset_manager* assets=nullptr);
 
-		// user interface; thread-safe
+		// user interface; thread-safe, but not concurrently to process_queued_actions, stats or clear
 			auto emplace()noexcept -> Entity_facet;
 			auto emplace(const std::string& blueprint) -> Entity_facet;
+			/// creates count entities at once, that can be populated through the returned batch
+			auto emplace_bulk(std::size_t count) -> Entity_batch;
+			auto emplace_bulk(std::size_t count, const std::string& blueprint) -> Entity_batch;
 			auto get(Entity_handle entity) -> util::maybe<Entity_facet>;
 			auto validate(Entity_handle entity) -> bool {
 				return _handles.valid(entity);
@@ -58,12 +88,31 @@ namespace ecs {
 			template<typename F>
 			void list_all(F&& handler);
 
-			auto& userdata()noexcept {return _userdata;}
+			/// join over all entities that own all of the given components; see Entity_view
+			template<typename... C>
+			auto view() -> Entity_view<C...>;
+
+			/// NOT thread-safe; creates the group on the first call; see Owning_group
+			template<typename... C>
+			auto group() -> Owning_group<C...>&;
+
+			auto& userdata() {
+				INVARIANT(_userdata, "Entity_manager has been created without an Engine");
+				return *_userdata;
+			}
+			auto& thread_pool()noexcept {return _thread_pool;}
 
 		// serialization interface; not thread-safe (yet?)
 			auto write_one(Entity_handle source) -> ETO;
 			auto read_one(ETO data, Entity_handle target=invalid_entity) -> Entity_facet;
 
+			/// binary copy of the entities; components without binary serialization are stored as JSON
+			auto snapshot(const std::vector<Entity_handle>&) -> Snapshot;
+			/// appends the entity to the snapshot
+			void snapshot(Entity_handle source, Snapshot& target);
+			/// recreates all entities of the snapshot as new entities
+			void restore(const Snapshot&);
+
 			void write(std::ostream&, Component_filter filter={});
 			void write(std::ostream&, const std::vector<Entity_handle>&, Component_filter filter={});
 			void read(std::istream&, bool clear=true, Component_filter filter={});
@@ -71,6 +120,15 @@ namespace ecs {
 
 		// manager/engine interface; not thread-safe
 			void process_queued_actions();
+			/// starts a new frame for the change tracking (see Component_container::for_each_changed)
+			void next_change_frame();
+			auto change_frame()const noexcept {return _change_frame;}
+			/// memory usage and queue depths of the handle generator and all component types
+			auto stats()const -> Ecs_stats;
+			/// max number of components each container relocates per frame to fill the holes left by
+			///   deletions (<=0 to compact everything at once)
+			void compaction_budget(Component_index budget)noexcept {_compaction_budget = budget;}
+			auto compaction_budget()const noexcept {return _compaction_budget;}
 			void clear();
 			template<typename T>
 			void register_component_type();
@@ -79,55 +137,38 @@ namespace ecs {
 		private:
 			friend class Entity_facet;
 			friend class Entity_collection_facet;
+			friend auto get_command_buffer(Entity_manager&) -> Command_buffer&;
+
+			auto _asset_manager() -> asset::Asset_manager&;
 
-			using Erase_queue = moodycamel::ConcurrentQueue<Entity_handle>;
+			using Command_buffer_entry = std::pair<std::thread::id, std::unique_ptr<Command_buffer>>;
 
-			User_data& _userdata;
+			User_data* _userdata = nullptr;
+			util::Thread_pool& _thread_pool;
+			asset::Asset_manager* _assets;
+			const uint64_t _id; //< unique for the lifetime of the process to identify cached buffers
 
 			Entity_handle_generator _handles;
-			Erase_queue _queue_erase;
+			mutable std::mutex _command_buffers_mutex; //< guards the list, not the buffers themselves
+			std::vector<Command_buffer_entry> _command_buffers;
 			std::vector<Entity_handle> _local_queue_erase;
 
 			std::vector<std::unique_ptr<Component_container_base>> _components;
 			std::unordered_map<std::string, Component_type>   _components_by_name;
+			std::vector<std::unique_ptr<Owning_group_base>>     _groups;
+			uint64_t _change_frame = 0;
+			Component_index _compaction_budget = 256;
+
+			auto _command_buffer() -> Command_buffer&;
 	};
 	
 	
-	class Entity_iterator {
-		public:
-			typedef Entity_handle value_type;
-			typedef value_type& reference;
-			typedef value_type* pointer;
-			typedef std::forward_iterator_tag iterator_category;
-			typedef int difference_type;
-			
-			Entity_iterator(const Entity_handle_generator& gen,
-			                Entity_handle handle)noexcept
-			    : _gen(gen), _handle(handle) {}
-			
-			auto operator++(int) {
-				_handle = _gen.next(_handle);
-				return *this;
-			}
-			auto operator++() {
-				auto i = *this;
-				_handle = _gen.next(_handle);
-				return i;
-			}
-			reference operator*()noexcept {return _handle; }
-			pointer operator->()noexcept {return &_handle; }
-			bool operator==(const Entity_iterator& rhs)const noexcept {
-				return _handle == rhs._handle;
-			}
-			bool operator!=(const Entity_iterator& rhs)noexcept {
-				return !(*this==rhs);
-			}
-			
-		private:
-			const Entity_handle_generator& _gen;
-			Entity_handle _handle;
-	};
-	
+	/// writes the statistics as JSON (e.g. to compare memory usage over time with external tools)
+	extern void save_stats(std::ostream&, const Ecs_stats&);
+
+
+	using Entity_iterator = std::vector<Entity_handle>::const_iterator;
+
 	class Entity_collection_facet {
 		public:
 			typedef Entity_handle value_type;
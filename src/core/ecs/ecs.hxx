@@ -9,6 +9,16 @@
 namespace lux {
 namespace ecs {
 	
+	namespace detail {
+		inline bool ppack_and() {
+			return true;
+		}
+
+		template<class FirstArg, class... Args>
+		bool ppack_and(FirstArg&& first, Args&&... args) {
+			return first && ppack_and(std::forward<Args>(args)...);
+		}
+	}
 	
 	template<typename T>
 	void Entity_manager::register_component_type() {
@@ -22,6 +32,7 @@ namespace ecs {
 		
 		if(unlikely(!container_ptr)) {
 			container_ptr = std::make_unique<Component_container<T>>(*this);
+			container_ptr->change_frame(_change_frame);
 			
 			auto it = _components_by_name.emplace(T::name(), type);
 			INVARIANT(it.first->second==type, "Multiple components with same name: "<<T::name());
@@ -58,6 +69,211 @@ namespace ecs {
 	}
 	
 	
+	template<typename... C>
+	auto Entity_manager::view() -> Entity_view<C...> {
+		return Entity_view<C...>{*this};
+	}
+
+	template<typename... C>
+	auto Entity_manager::group() -> Owning_group<C...>& {
+		for(auto& g : _groups) {
+			auto group = dynamic_cast<Owning_group<C...>*>(g.get());
+			if(group) {
+				return *group;
+			}
+		}
+
+		for(auto type : {component_type_id<C>()...}) {
+			for(auto& g : _groups) {
+				INVARIANT(!g->owns(type), "Component type "<<type<<" is already owned by another group");
+			}
+		}
+
+		auto group = std::make_unique<Owning_group<C...>>(*this);
+		auto& group_ref = *group;
+		_groups.emplace_back(std::move(group));
+		return group_ref;
+	}
+
+
+	template<class T, class Index_policy, class Storage_policy>
+	void Component<T, Index_policy, Storage_policy>::mark_changed() {
+		if(_manager && _owner) {
+			_manager->list<T>().mark_changed(static_cast<const T&>(*this));
+		}
+	}
+
+	template<class... C>
+	Entity_view<C...>::Entity_view(Entity_manager& manager)
+	    : _containers(&manager.list<C>()...) {
+	}
+
+	template<class... C>
+	template<class F>
+	void Entity_view<C...>::for_each(F&& f) {
+		_dispatch(f, std::index_sequence_for<C...>{});
+	}
+
+	template<class... C>
+	auto Entity_view<C...>::size_hint()const -> Component_index {
+		auto sizes = {static_cast<Component_index>(std::get<Component_container<C>*>(_containers)->size())...};
+		return std::min(sizes);
+	}
+
+	template<class... C>
+	template<class F, std::size_t... I>
+	void Entity_view<C...>::_dispatch(F& f, std::index_sequence<I...>) {
+		// the smallest container drives the iteration
+		auto sizes = std::array<Component_index, sizeof...(C)> {
+			{static_cast<Component_index>(std::get<I>(_containers)->size())...}};
+		auto driver = static_cast<std::size_t>(std::distance(sizes.begin(),
+		                                       std::min_element(sizes.begin(), sizes.end())));
+
+		if(sizes[driver]==0)
+			return;
+
+		using Impl = void(Entity_view::*)(F&);
+		const Impl impls[] = {&Entity_view::template _for_each<I, F>...};
+		(this->*impls[driver])(f);
+	}
+
+	template<class... C>
+	template<std::size_t Driver, class F>
+	void Entity_view<C...>::_for_each(F& f) {
+		using Driver_t = std::tuple_element_t<Driver, std::tuple<C...>>;
+
+		std::array<Entity_id, block_size> ids;
+		std::array<Row, block_size> rows;
+		auto count = std::size_t(0);
+
+		for(Driver_t& comp : *std::get<Driver>(_containers)) {
+			ids[count] = comp.owner_handle().id();
+			std::get<Driver>(rows[count]) = &comp;
+
+			if(++count == block_size) {
+				_flush_block<Driver>(f, ids, rows, count, std::index_sequence_for<C...>{});
+				count = 0;
+			}
+		}
+
+		if(count>0) {
+			_flush_block<Driver>(f, ids, rows, count, std::index_sequence_for<C...>{});
+		}
+	}
+
+	template<class... C>
+	template<std::size_t Driver, class F, std::size_t... I>
+	void Entity_view<C...>::_flush_block(F& f, const std::array<Entity_id, block_size>& ids,
+	                                     std::array<Row, block_size>& rows, std::size_t count,
+	                                     std::index_sequence<I...>) {
+		// resolve one component type at a time for the whole block
+		auto ignored = {(_resolve<I>(std::integral_constant<bool, I==Driver>{}, ids, rows, count), 0)...};
+		(void)ignored;
+
+		for(auto i=std::size_t(0); i<count; i++) {
+			auto& row = rows[i];
+			if(detail::ppack_and(std::get<I>(row)...)) {
+				f(*std::get<I>(row)...);
+			}
+		}
+	}
+
+	template<class... C>
+	template<std::size_t Target>
+	void Entity_view<C...>::_resolve(std::false_type, const std::array<Entity_id, block_size>& ids,
+	                                 std::array<Row, block_size>& rows, std::size_t count) {
+		auto& container = *std::get<Target>(_containers);
+		for(auto i=std::size_t(0); i<count; i++) {
+			std::get<Target>(rows[i]) = container._find_by_id(ids[i]);
+		}
+	}
+
+
+	template<class... C>
+	Owning_group<C...>::Owning_group(Entity_manager& manager)
+	    : _containers(&manager.list<C>()...) {
+		_revisions.fill(0);
+		update();
+	}
+
+	template<class... C>
+	template<class F>
+	void Owning_group<C...>::for_each(F&& f) {
+		update();
+		_for_each(f, std::index_sequence_for<C...>{});
+	}
+
+	template<class... C>
+	auto Owning_group<C...>::size() -> Component_index {
+		update();
+		return _size;
+	}
+
+	template<class... C>
+	void Owning_group<C...>::update() {
+		if(!_valid || _dirty(std::index_sequence_for<C...>{})) {
+			_regroup(std::index_sequence_for<C...>{});
+			_valid = true;
+		}
+	}
+
+	template<class... C>
+	auto Owning_group<C...>::owns(Component_type type)const noexcept -> bool {
+		for(auto t : {component_type_id<C>()...}) {
+			if(t==type)
+				return true;
+		}
+		return false;
+	}
+
+	template<class... C>
+	template<std::size_t... I>
+	bool Owning_group<C...>::_dirty(std::index_sequence<I...>)const {
+		auto revisions = std::array<uint64_t, sizeof...(C)>{{std::get<I>(_containers)->_revision()...}};
+		return revisions!=_revisions;
+	}
+
+	template<class... C>
+	template<std::size_t... I>
+	void Owning_group<C...>::_regroup(std::index_sequence<I...>) {
+		auto ignored = {(std::get<I>(_containers)->_compact(), 0)...};
+		(void)ignored;
+
+		// move the components of all entities that own all of them to [0, _size) in the
+		//   order of the first container
+		auto& first = *std::get<0>(_containers);
+		auto first_size = static_cast<Component_index>(first.size());
+		auto next = Component_index(0);
+
+		for(auto i=Component_index(0); i<first_size; i++) {
+			auto entity_id = first._get_by_index(i).owner_handle().id();
+			auto indices = std::array<util::maybe<Component_index>, sizeof...(C)> {
+				{std::get<I>(_containers)->_index_of(entity_id)...}};
+
+			auto complete = std::all_of(indices.begin(), indices.end(), [](auto& idx) {
+				return idx.is_some();
+			});
+
+			if(complete) {
+				auto ignored = {(std::get<I>(_containers)->_swap(indices[I].get_or_throw(), next), 0)...};
+				(void)ignored;
+				next++;
+			}
+		}
+
+		_size = next;
+		_revisions = {{std::get<I>(_containers)->_revision()...}};
+	}
+
+	template<class... C>
+	template<class F, std::size_t... I>
+	void Owning_group<C...>::_for_each(F& f, std::index_sequence<I...>) {
+		for(auto i=Component_index(0); i<_size; i++) {
+			f(std::get<I>(_containers)->_get_by_index(i)...);
+		}
+	}
+
+
 	template<typename T>
 	util::maybe<T&> Entity_facet::get() {
 		INVARIANT(_manager && _manager->validate(_owner), "Access to invalid Entity_facet for "<<entity_name(_owner));
@@ -80,22 +296,28 @@ namespace ecs {
 		_manager->list<T>().emplace(std::forward<F>(init), _owner, std::forward<Args>(args)...);
 	}
 
+	template<typename T, typename... Args>
+	void Entity_batch::emplace(const Args&... args) {
+		emplace_init<T>([](const T&, std::size_t){}, args...);
+	}
+
+	template<typename T, typename F, typename... Args>
+	void Entity_batch::emplace_init(F&& init, const Args&... args) {
+		INVARIANT(_manager, "Access to invalid Entity_batch");
+		_manager->list<T>().emplace_bulk(std::forward<F>(init), _handles.data(), _handles.size(), args...);
+	}
+
+	inline auto Entity_batch::operator[](std::size_t i)const -> Entity_facet {
+		INVARIANT(_manager, "Access to invalid Entity_batch");
+		return {*_manager, _handles.at(i)};
+	}
+
 	template<typename T>
 	void Entity_facet::erase() {
 		INVARIANT(_manager && _manager->validate(_owner), "Access to invalid Entity_facet for "<<entity_name(_owner));
 		return _manager->list<T>().erase(_owner);
 	}
 
-	namespace detail {
-		inline bool ppack_and() {
-			return true;
-		}
-
-		template<class FirstArg, class... Args>
-		bool ppack_and(FirstArg&& first, Args&&... args) {
-			return first && ppack_and(std::forward<Args>(args)...);
-		}
-	}
 	template<typename... T>
 	void Entity_facet::erase_other() {
 		INVARIANT(_manager && _manager->validate(_owner), "Access to invalid Entity_facet for "<<entity_name(_owner));
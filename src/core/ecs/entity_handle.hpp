@@ -12,6 +12,7 @@
 
 #include <moodycamel/concurrentqueue.hpp>
 
+#include <algorithm>
 #include <cstdint>
 #include <vector>
 #include <string>
@@ -93,6 +94,13 @@ namespace ecs {
 	extern auto get_entity_id(Entity_handle h, Entity_manager&) -> Entity_id;
 	extern auto entity_name(Entity_handle h) -> std::string;
 
+	/**
+	 * Allocates entity ids and tracks their revisions.
+	 * Additionally a dense list of all live handles is maintained (see alive()), so iterating
+	 *   over all entities doesn't depend on the highest id ever used. To keep get_new() lock-free,
+	 *   reused handles are only queued there and applied to the list by the other (NOT thread-safe)
+	 *   methods, while new ids are always allocated at the end of the slot range.
+	 */
 	class Entity_handle_generator {
 		using Freelist = moodycamel::ConcurrentQueue<Entity_handle>;
 		public:
@@ -111,6 +119,7 @@ namespace ecs {
 					bool success = rev.compare_exchange_strong(expected_rev, h.revision());
 					INVARIANT(success, "My handle got stolen :(");
 
+					_reused.enqueue(h);
 					return h;
 				}
 
@@ -119,6 +128,30 @@ namespace ecs {
 				return {slot+1, 0};
 			}
 
+			// thread-safe; writes count new handles to out
+			void get_new(Entity_handle* out, std::size_t count) {
+				auto reused = _free.try_dequeue_bulk(out, count);
+				for(auto i=0ul; i<reused; i++) {
+					auto& h = out[i];
+					auto& rev = util::at(_slots, static_cast<std::size_t>(h.id()-1));
+					auto expected_rev = static_cast<uint8_t>(h.revision()|Entity_handle::free_rev);
+					h.revision(static_cast<uint8_t>(rev & ~Entity_handle::free_rev)); // mark as used
+
+					bool success = rev.compare_exchange_strong(expected_rev, h.revision());
+					INVARIANT(success, "My handle got stolen :(");
+				}
+				if(reused>0) {
+					_reused.enqueue_bulk(out, reused);
+				}
+
+				// the remaining handles are allocated as one contiguous range of new slots
+				auto remaining = static_cast<Entity_id>(count - reused);
+				auto first_slot = _next_free_slot.fetch_add(remaining);
+				for(auto i=Entity_id(0); i<remaining; i++) {
+					out[reused + static_cast<std::size_t>(i)] = {first_slot+i+1, 0};
+				}
+			}
+
 			// thread-safe
 			auto valid(Entity_handle h)const noexcept -> bool {
 				return h && (static_cast<Entity_id>(_slots.size()) <= h.id()-1
@@ -127,6 +160,8 @@ namespace ecs {
 
 			// NOT thread-safe
 			auto free(Entity_handle h) -> Entity_handle {
+				_remove_alive(h.id());
+
 				if(h.id()-1 >= static_cast<Entity_id>(_slots.size())) {
 					_slots.resize(static_cast<std::size_t>(h.id()-1) *2, 0);
 				}
@@ -144,23 +179,23 @@ namespace ecs {
 				return {handle};
 			}
 
-			// NOT thread-safe
-			auto next(Entity_handle curr=invalid_entity)const -> Entity_handle {
-				// internal_id = external_id - 1, so we don't need to increment it here
-				auto end = _next_free_slot.load();
-
-				for(Entity_id id=curr.id(); id<end; id++) {
-					if(id>=static_cast<Entity_id>(_slots.size())) {
-						return Entity_handle{id+1,0};
-					} else {
-						auto rev = util::at(_slots, static_cast<std::size_t>(id)).load();
-						if((rev & ~Entity_handle::free_rev)==rev) { // is marked used
-							return Entity_handle{id+1,rev};
-						}
-					}
-				}
+			// NOT thread-safe; all live handles in no particular order
+			auto alive() -> const std::vector<Entity_handle>& {
+				_sync_alive();
+				return _alive;
+			}
 
-				return invalid_entity;
+			// thread-safe; number of ids, that have been handed out at least once
+			auto used_slots()const noexcept -> Entity_id {
+				return _next_free_slot.load();
+			}
+			// NOT thread-safe; size of the revision table
+			auto allocated_slots()const noexcept -> Entity_id {
+				return static_cast<Entity_id>(_slots.size());
+			}
+			// thread-safe; approximate number of freed handles, that haven't been reused yet
+			auto free_count()const noexcept -> std::size_t {
+				return _free.size_approx();
 			}
 
 			// NOT thread-safe
@@ -169,12 +204,60 @@ namespace ecs {
 				_slots.resize(_slots.capacity(), 0);
 				_next_free_slot = 0;
 				_free = Freelist{}; // clear by moving a new queue into the old
+
+				_alive.clear();
+				std::fill(_alive_index.begin(), _alive_index.end(), -1);
+				_alive_synced_slot = 0;
+				_reused = Freelist{};
 			}
 
 		private:
 			util::vector_atomic<uint8_t> _slots;
 			std::atomic<Entity_id> _next_free_slot{0};
 			Freelist _free;
+
+			std::vector<Entity_handle> _alive;
+			std::vector<int32_t> _alive_index; //< position in _alive for each slot or -1
+			Entity_id _alive_synced_slot = 0;  //< all slots before have been added to _alive
+			Freelist _reused; //< handles reused by get_new, that are not in _alive yet
+
+			void _add_alive(Entity_handle h) {
+				auto slot = static_cast<std::size_t>(h.id()-1);
+				if(slot >= _alive_index.size()) {
+					_alive_index.resize(std::max(slot+1, _alive_index.size()*2), -1);
+				}
+
+				_alive_index[slot] = static_cast<int32_t>(_alive.size());
+				_alive.push_back(h);
+			}
+			void _remove_alive(Entity_id id) {
+				_sync_alive();
+
+				auto slot = static_cast<std::size_t>(id-1);
+				if(slot >= _alive_index.size() || _alive_index[slot]<0)
+					return;
+
+				auto idx = static_cast<std::size_t>(_alive_index[slot]);
+				_alive_index[slot] = -1;
+				if(idx+1 < _alive.size()) {
+					_alive[idx] = _alive.back();
+					_alive_index[static_cast<std::size_t>(_alive[idx].id()-1)] = static_cast<int32_t>(idx);
+				}
+				_alive.pop_back();
+			}
+			void _sync_alive() {
+				Entity_handle reused[32];
+				while(auto count = _reused.try_dequeue_bulk(reused, 32)) {
+					for(auto i=0ul; i<count; i++) {
+						_add_alive(reused[i]);
+					}
+				}
+
+				auto end = _next_free_slot.load();
+				for(; _alive_synced_slot<end; _alive_synced_slot++) {
+					_add_alive(Entity_handle{_alive_synced_slot+1, 0});
+				}
+			}
 	};
 
 }
@@ -6,6 +6,7 @@
 
 #include <sf2/sf2.hpp>
 
+#include <algorithm>
 #include <unordered_map>
 #include <vector>
 #include <iostream>
@@ -22,6 +23,11 @@ namespace lux {
 
 		const std::string import_key = "$import";
 		void apply(const Blueprint& b, Entity_facet e);
+		void apply(const Blueprint& b, Entity_batch& batch);
+
+		bool contains(const std::vector<Component_type>& types, Component_type type) {
+			return std::find(types.begin(), types.end(), type)!=types.end();
+		}
 
 
 		class Blueprint {
@@ -34,6 +40,20 @@ namespace lux {
 				void detach(Entity_handle target)const;
 				void on_reload();
 
+				/// the components of the blueprint and its imports, parsed once per Entity_manager
+				struct Compiled {
+					struct Prototype {
+						Component_type type;
+						std::shared_ptr<void> value;
+					};
+
+					Entity_manager* manager = nullptr;
+					std::vector<const Blueprint*> chain; //< the root import first
+					std::vector<Prototype> prototypes;
+					std::vector<Component_type> deserialized; //< components that can't be copied
+				};
+				auto compiled(Entity_manager&)const -> const Compiled&;
+
 				mutable std::vector<Entity_handle> users;
 				mutable std::vector<Blueprint*> children;
 				std::string id;
@@ -41,6 +61,9 @@ namespace lux {
 				asset::Ptr<Blueprint> parent;
 				asset::Asset_manager* asset_mgr;
 				mutable Entity_manager* entity_manager;
+
+			private:
+				mutable Compiled _compiled;
 		};
 
 
@@ -89,6 +112,8 @@ namespace lux {
 			return *this;
 		}
 		void Blueprint::on_reload() {
+			_compiled = Compiled{};
+
 			for(auto&& c : children) {
 				c->on_reload();
 			}
@@ -103,6 +128,68 @@ namespace lux {
 		void Blueprint::detach(Entity_handle target)const {
 			util::erase_fast(users, target);
 		}
+
+		auto Blueprint::compiled(Entity_manager& manager)const -> const Compiled& {
+			if(_compiled.manager==&manager)
+				return _compiled;
+
+			_compiled = Compiled{};
+			_compiled.manager = &manager;
+
+			for(auto b=this; b; b=b->parent ? &*b->parent : nullptr) {
+				_compiled.chain.insert(_compiled.chain.begin(), b);
+			}
+
+			auto find_prototype = [&](Component_type type) {
+				return std::find_if(_compiled.prototypes.begin(), _compiled.prototypes.end(),
+				                    [&](auto& p) {return p.type==type;});
+			};
+
+			for(auto b : _compiled.chain) {
+				std::istringstream stream{b->content};
+				auto deserializer = Deserializer{b->id, stream, manager, *asset_mgr};
+
+				deserializer.read_lambda([&](const auto& key) {
+					if(import_key==key) {
+						auto value = std::string{};
+						deserializer.read_value(value);
+						return true;
+					}
+
+					auto comp_type_mb = manager.component_type_by_name(key);
+					if(comp_type_mb.is_nothing()) {
+						deserializer.skip_obj();
+						return true;
+					}
+
+					auto comp_type = comp_type_mb.get_or_throw();
+					auto& container = manager.list(comp_type);
+
+					if(contains(_compiled.deserialized, comp_type)) {
+						deserializer.skip_obj();
+						return true;
+					}
+
+					auto prototype = find_prototype(comp_type);
+					if(prototype==_compiled.prototypes.end()) {
+						auto value = container.create_prototype();
+						if(!value) {
+							_compiled.deserialized.push_back(comp_type);
+							deserializer.skip_obj();
+							return true;
+						}
+
+						_compiled.prototypes.push_back(Compiled::Prototype{comp_type, std::move(value)});
+						prototype = _compiled.prototypes.end()-1;
+					}
+
+					container.load_prototype(prototype->value.get(), deserializer);
+					return true;
+				});
+			}
+
+			return _compiled;
+		}
 	}
 	}
 
@@ -172,16 +259,63 @@ namespace ecs {
 		}
 
 
+		// reads the given components from the JSON of the blueprint chain
+		void deserialize(const Blueprint& b, Entity_manager& manager, Entity_handle handle,
+		                 const std::vector<Component_type>& deserialized) {
+			if(deserialized.empty())
+				return;
+
+			auto filter = [&](Component_type type) {
+				return contains(deserialized, type);
+			};
+
+			for(auto chain_entry : b.compiled(manager).chain) {
+				std::istringstream stream{chain_entry->content};
+				auto deserializer = Deserializer{chain_entry->id, stream, manager, *b.asset_mgr, filter};
+
+				deserializer.read_value(handle);
+			}
+		}
+
 		void apply(const Blueprint& b, Entity_facet e) {
-			if(b.parent) {
-				apply(*b.parent, e);
+			auto& manager = e.manager();
+			auto& compiled = b.compiled(manager);
+			auto handle = e.handle();
+
+			// components, that already exist, are updated from the JSON to keep all fields not
+			//   set by the blueprint
+			auto deserialized = compiled.deserialized;
+			for(auto& p : compiled.prototypes) {
+				if(!manager.list(p.type).clone(handle, p.value.get())) {
+					deserialized.push_back(p.type);
+				}
 			}
 
-			std::istringstream stream{b.content};
-			auto deserializer = Deserializer{b.id, stream, e.manager(), *b.asset_mgr};
+			deserialize(b, manager, handle, deserialized);
+		}
+		void apply(const Blueprint& b, Entity_batch& batch) {
+			auto& manager = batch.manager();
+			auto& compiled = b.compiled(manager);
+			auto& handles = batch.handles();
+
+			// clone one component type at a time into all entities
+			auto existing = std::vector<std::vector<Component_type>>(handles.size());
+			auto cloned = std::vector<bool>();
+			for(auto& p : compiled.prototypes) {
+				manager.list(p.type).clone_bulk(handles.data(), handles.size(), p.value.get(), cloned);
+				for(auto i=0ul; i<handles.size(); i++) {
+					if(!cloned[i]) {
+						existing[i].push_back(p.type);
+					}
+				}
+			}
 
-			auto handle = e.handle();
-			deserializer.read_value(handle);
+			auto deserialized = std::vector<Component_type>();
+			for(auto i=0ul; i<handles.size(); i++) {
+				deserialized = compiled.deserialized;
+				deserialized.insert(deserialized.end(), existing[i].begin(), existing[i].end());
+				deserialize(b, manager, handles[i], deserialized);
+			}
 		}
 
 
@@ -227,6 +361,21 @@ namespace ecs {
 
 		apply(*b, e);
 	}
+	void apply_blueprint(asset::Asset_manager& asset_mgr, Entity_batch& batch,
+	                     const std::string& blueprint) {
+		auto mb = asset_mgr.load_maybe<ecs::Blueprint>(asset::AID{"blueprint"_strid, blueprint});
+		if(mb.is_nothing()) {
+			ERROR("Failed to load blueprint \""<<blueprint<<"\"");
+			return;
+		}
+		auto b = mb.get_or_throw();
+
+		// the entities are new, so none of them has a Blueprint_component, yet
+		batch.emplace<Blueprint_component>(b);
+		b->users.insert(b->users.end(), batch.begin(), batch.end());
+
+		apply(*b, batch);
+	}
 
 
 	void load(sf2::JsonDeserializer& s, Entity_handle& e) {
@@ -9,11 +9,15 @@
 
 #include "types.hpp"
 #include "../asset/asset_manager.hpp"
+#include "../utils/log.hpp"
 
 #include <sf2/sf2.hpp>
 
 #include <string>
 #include <unordered_map>
+#include <vector>
+#include <cstring>
+#include <type_traits>
 
 
 namespace lux {
@@ -47,12 +51,74 @@ namespace ecs {
 		Component_filter filter;
 	};
 
+	/**
+	 * Appends the raw bytes of plain values to a buffer; used for snapshots (see Entity_manager::snapshot).
+	 * The data is only valid for the running process.
+	 */
+	struct Binary_writer {
+		Binary_writer(std::vector<char>& data) : data(data) {}
+
+		template<class T>
+		void write(const T& v) {
+			static_assert(std::is_standard_layout<T>::value && std::is_trivially_destructible<T>::value,
+			              "only plain values can be written");
+			auto begin = reinterpret_cast<const char*>(&v);
+			data.insert(data.end(), begin, begin+sizeof(T));
+		}
+		template<class T>
+		void write(const std::vector<T>& v) {
+			write(static_cast<uint32_t>(v.size()));
+			for(auto& e : v) {
+				write(e);
+			}
+		}
+		void write(const std::string& v) {
+			write(static_cast<uint32_t>(v.size()));
+			data.insert(data.end(), v.begin(), v.end());
+		}
+
+		std::vector<char>& data;
+	};
+	struct Binary_reader {
+		Binary_reader(const char* begin, const char* end) : position(begin), end(begin<end ? end : begin) {}
+
+		template<class T>
+		void read(T& v) {
+			static_assert(std::is_standard_layout<T>::value && std::is_trivially_destructible<T>::value,
+			              "only plain values can be read");
+			INVARIANT(static_cast<std::size_t>(end-position)>=sizeof(T), "Binary_reader: read past the end");
+			std::memcpy(reinterpret_cast<char*>(&v), position, sizeof(T));
+			position += sizeof(T);
+		}
+		template<class T>
+		void read(std::vector<T>& v) {
+			auto size = uint32_t(0);
+			read(size);
+			v.resize(size);
+			for(auto& e : v) {
+				read(e);
+			}
+		}
+		void read(std::string& v) {
+			auto size = uint32_t(0);
+			read(size);
+			INVARIANT(static_cast<std::size_t>(end-position)>=size, "Binary_reader: read past the end");
+			v.assign(position, position+size);
+			position += size;
+		}
+
+		const char* position;
+		const char* end;
+	};
+
 	extern Component_type blueprint_comp_id;
 	
 	extern void init_serializer(Entity_manager&);
 
 	extern void apply_blueprint(asset::Asset_manager&, Entity_facet e,
 	                            const std::string& blueprint);
+	extern void apply_blueprint(asset::Asset_manager&, Entity_batch& batch,
+	                            const std::string& blueprint);
 	
 	extern void load(sf2::JsonDeserializer& s, Entity_handle& e);
 	extern void save(sf2::JsonSerializer& s, const Entity_handle& e);
@@ -0,0 +1,248 @@
+#include "system_scheduler.hpp"
+
+#include "../utils/thread_pool.hpp"
+#include "../utils/log.hpp"
+#include "../utils/maybe.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <condition_variable>
+#include <sstream>
+#include <iomanip>
+
+
+namespace lux {
+namespace ecs {
+
+	void Stage_access::_add(Kind kind, std::intptr_t id, bool write) {
+		auto existing = std::find_if(_resources.begin(), _resources.end(), [&](auto& r) {
+			return r.kind==kind && r.id==id;
+		});
+
+		if(existing!=_resources.end()) {
+			existing->write |= write;
+		} else {
+			_resources.push_back(Resource{kind, id, write});
+		}
+	}
+
+	auto Stage_access::conflicts(const Stage_access& rhs)const -> bool {
+		for(auto& a : _resources) {
+			for(auto& b : rhs._resources) {
+				if(a.kind==b.kind && a.id==b.id && (a.write || b.write))
+					return true;
+			}
+		}
+
+		return false;
+	}
+
+
+	struct System_scheduler::Execution_state {
+		std::unique_ptr<std::atomic<int>[]> remaining;
+		std::size_t capacity = 0;
+
+		std::mutex mutex;
+		std::condition_variable changed;
+		std::deque<std::size_t> main_thread_queue;
+		std::size_t finished = 0;
+		std::exception_ptr error;
+
+		void reset(const Schedule& schedule) {
+			auto count = schedule.stages.size();
+			if(capacity<count) {
+				remaining = std::make_unique<std::atomic<int>[]>(count);
+				capacity = count;
+			}
+
+			for(auto i=0u; i<count; i++) {
+				remaining[i].store(schedule.dependencies[i]);
+			}
+
+			main_thread_queue.clear();
+			finished = 0;
+			error = nullptr;
+		}
+	};
+
+
+	System_scheduler::System_scheduler(util::Thread_pool* pool)
+	    : _pool(pool), _state(std::make_unique<Execution_state>()) {
+	}
+	System_scheduler::~System_scheduler() = default;
+
+	void System_scheduler::add_stage(std::string name, Mask mask, Stage_access access, Stage_func func) {
+		_stages.push_back(Stage{std::move(name), mask, std::move(access), std::move(func)});
+		_schedules.clear();
+	}
+
+	void System_scheduler::execute(Time dt, Mask mask) {
+		auto& schedule = _get_schedule(mask);
+
+		if(single_threaded()) {
+			for(auto stage : schedule.stages) {
+				_stages[stage].func(dt);
+			}
+
+		} else {
+			_execute_parallel(dt, schedule);
+		}
+	}
+
+	void System_scheduler::print_schedule(std::ostream& out, Mask mask) {
+		auto& schedule = _get_schedule(mask);
+
+		// a stage can start in the step after all its dependencies
+		auto steps = std::vector<int>(schedule.stages.size(), 0);
+		for(auto i=0u; i<schedule.stages.size(); i++) {
+			for(auto dependent : schedule.dependents[i]) {
+				steps[dependent] = std::max(steps[dependent], steps[i]+1);
+			}
+		}
+
+		out<<"Schedule for mask 0x"<<std::hex<<mask<<std::dec<<" ("<<schedule.stages.size()<<" stages, "
+		   <<(single_threaded() ? 0 : _workers())<<" workers):";
+
+		for(auto i=0u; i<schedule.stages.size(); i++) {
+			auto& stage = _stages[schedule.stages[i]];
+			out<<"\n  "<<steps[i]<<": "<<std::left<<std::setw(20)<<stage.name
+			   <<(stage.access.main_thread_only() ? " [main thread]" : "")<<" after:";
+
+			auto first = true;
+			for(auto j=0u; j<i; j++) {
+				auto& deps = schedule.dependents[j];
+				if(std::find(deps.begin(), deps.end(), i)!=deps.end()) {
+					out<<(first ? " " : ", ")<<_stages[schedule.stages[j]].name;
+					first = false;
+				}
+			}
+			if(first) {
+				out<<" -";
+			}
+		}
+	}
+
+	auto System_scheduler::_workers()const noexcept -> int {
+		return _pool ? _pool->worker_count() : 0;
+	}
+
+	auto System_scheduler::_get_schedule(Mask mask) -> const Schedule& {
+		auto cached = std::find_if(_schedules.begin(), _schedules.end(), [&](auto& s) {
+			return s.mask==mask;
+		});
+		if(cached!=_schedules.end())
+			return *cached;
+
+		_schedules.emplace_back();
+		auto& s = _schedules.back();
+		s.mask = mask;
+		for(auto i=0u; i<_stages.size(); i++) {
+			if(_stages[i].mask & mask) {
+				s.stages.push_back(i);
+			}
+		}
+
+		// stages depend on all preceding stages they conflict with
+		s.dependents.resize(s.stages.size());
+		s.dependencies.assign(s.stages.size(), 0);
+		for(auto i=0u; i<s.stages.size(); i++) {
+			for(auto j=i+1; j<s.stages.size(); j++) {
+				if(_stages[s.stages[i]].access.conflicts(_stages[s.stages[j]].access)) {
+					s.dependents[i].push_back(j);
+					s.dependencies[j]++;
+				}
+			}
+		}
+
+		auto msg = std::stringstream{};
+		print_schedule(msg, mask);
+		DEBUG(msg.str());
+
+		return s;
+	}
+
+	void System_scheduler::_execute_parallel(Time dt, const Schedule& schedule) {
+		auto& state = *_state;
+		state.reset(schedule);
+
+		auto count = schedule.stages.size();
+
+		std::function<void(std::size_t)> dispatch;
+
+		auto run = [&](std::size_t i) {
+			try {
+				_stages[schedule.stages[i]].func(dt);
+			} catch(...) {
+				std::lock_guard<std::mutex> lock(state.mutex);
+				if(!state.error) {
+					state.error = std::current_exception();
+				}
+			}
+
+			for(auto dependent : schedule.dependents[i]) {
+				if(--state.remaining[dependent]==0) {
+					dispatch(dependent);
+				}
+			}
+
+			// notify while locked, because execute may return (and destroy this closure) as soon
+			//   as the mutex is released
+			std::lock_guard<std::mutex> lock(state.mutex);
+			state.finished++;
+			state.changed.notify_all();
+		};
+
+		dispatch = [&](std::size_t i) {
+			if(_stages[schedule.stages[i]].access.main_thread_only()) {
+				{
+					std::lock_guard<std::mutex> lock(state.mutex);
+					state.main_thread_queue.push_back(i);
+				}
+				state.changed.notify_all();
+
+			} else {
+				_pool->post([&run, i]{run(i);});
+			}
+		};
+
+		for(auto i=0u; i<count; i++) {
+			if(schedule.dependencies[i]==0) {
+				dispatch(i);
+			}
+		}
+
+		// execute main-thread stages and help the workers until all stages are done
+		while(true) {
+			auto main_stage = util::maybe<std::size_t>{};
+			{
+				std::lock_guard<std::mutex> lock(state.mutex);
+				if(state.finished==count)
+					break;
+
+				if(!state.main_thread_queue.empty()) {
+					main_stage = state.main_thread_queue.front();
+					state.main_thread_queue.pop_front();
+				}
+			}
+
+			if(main_stage.is_some()) {
+				run(main_stage.get_or_throw());
+
+			} else if(!_pool->try_execute_one()) {
+				std::unique_lock<std::mutex> lock(state.mutex);
+				state.changed.wait(lock, [&] {
+					return state.finished==count || !state.main_thread_queue.empty();
+				});
+			}
+		}
+
+		if(state.error) {
+			std::rethrow_exception(state.error);
+		}
+	}
+
+}
+}
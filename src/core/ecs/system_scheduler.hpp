@@ -0,0 +1,151 @@
+/** Executes the update stages of multiple systems in parallel ***************
+ *                                                                           *
+ * Copyright (c) 2016 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#pragma once
+
+#include "types.hpp"
+
+#include "../units.hpp"
+#include "../utils/reflection.hpp"
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <memory>
+#include <iosfwd>
+#include <cstdint>
+
+
+namespace lux {
+namespace util {class Thread_pool;}
+
+namespace ecs {
+
+	/**
+	 * The resources (component types, message types and other state) accessed by a stage.
+	 * Two stages conflict if one of them writes a resource the other one reads or writes.
+	 * Sending a message counts as writing it and consuming a message as reading it, so
+	 *   consumers stay ordered relative to the producers of their messages.
+	 */
+	class Stage_access {
+		public:
+			template<class... C>
+			auto reads() -> Stage_access& {
+				auto ignored = {(_add(Kind::component, component_type_id<C>(), false), 0)...};
+				(void)ignored;
+				return *this;
+			}
+			template<class... C>
+			auto writes() -> Stage_access& {
+				auto ignored = {(_add(Kind::component, component_type_id<C>(), true), 0)...};
+				(void)ignored;
+				return *this;
+			}
+			template<class... M>
+			auto consumes() -> Stage_access& {
+				auto ignored = {(_add(Kind::message, util::typeuid_of<M>(), false), 0)...};
+				(void)ignored;
+				return *this;
+			}
+			template<class... M>
+			auto sends() -> Stage_access& {
+				auto ignored = {(_add(Kind::message, util::typeuid_of<M>(), true), 0)...};
+				(void)ignored;
+				return *this;
+			}
+
+			/// state outside of the ECS (e.g. a system), identified by its address
+			auto reads(const void* resource) -> Stage_access& {
+				_add(Kind::other, reinterpret_cast<std::intptr_t>(resource), false);
+				return *this;
+			}
+			auto writes(const void* resource) -> Stage_access& {
+				_add(Kind::other, reinterpret_cast<std::intptr_t>(resource), true);
+				return *this;
+			}
+
+			/// the stage has to be executed by the thread calling System_scheduler::execute
+			auto main_thread() -> Stage_access& {
+				_main_thread = true;
+				return *this;
+			}
+
+			auto main_thread_only()const noexcept {return _main_thread;}
+			auto conflicts(const Stage_access& rhs)const -> bool;
+
+		private:
+			enum class Kind : uint8_t {component, message, other};
+			struct Resource {
+				Kind kind;
+				std::intptr_t id;
+				bool write;
+			};
+
+			std::vector<Resource> _resources;
+			bool _main_thread = false;
+
+			void _add(Kind kind, std::intptr_t id, bool write);
+	};
+
+	/**
+	 * Executes a list of stages (usually the update functions of the systems).
+	 * The stages are ordered by their declaration, but stages that don't conflict (see Stage_access)
+	 *   are executed concurrently on a thread pool. Without a pool (or with single_threaded(true))
+	 *   all stages are executed sequentially in declaration order.
+	 * Stages must only use the deferred (thread-safe) ECS operations (emplace/erase) to
+	 *   modify the entity structure.
+	 */
+	class System_scheduler {
+		public:
+			using Stage_func = std::function<void(Time)>;
+			using Mask = uint32_t;
+
+			System_scheduler(util::Thread_pool* pool=nullptr);
+			~System_scheduler();
+
+			/// stages are only executed if (mask & execute-mask)!=0
+			void add_stage(std::string name, Mask mask, Stage_access access, Stage_func func);
+
+			/// NOT thread-safe; rethrows the first exception thrown by any stage
+			void execute(Time dt, Mask mask);
+
+			void single_threaded(bool s)noexcept {_single_threaded = s;}
+			auto single_threaded()const noexcept {
+				return _single_threaded || _workers()==0;
+			}
+
+			/// writes the stages, that would be executed for the given mask, and their dependencies
+			void print_schedule(std::ostream&, Mask mask);
+
+		private:
+			struct Stage {
+				std::string name;
+				Mask mask;
+				Stage_access access;
+				Stage_func func;
+			};
+			struct Schedule {
+				Mask mask = 0;
+				std::vector<std::size_t> stages;
+				std::vector<std::vector<std::size_t>> dependents; //< indices into stages
+				std::vector<int> dependencies;
+			};
+			struct Execution_state;
+
+			util::Thread_pool* _pool;
+			std::vector<Stage> _stages;
+			bool _single_threaded = false;
+			std::vector<Schedule> _schedules; //< cached per mask
+			std::unique_ptr<Execution_state> _state;
+
+			auto _workers()const noexcept -> int;
+			auto _get_schedule(Mask mask) -> const Schedule&;
+			void _execute_parallel(Time dt, const Schedule&);
+	};
+
+}
+}
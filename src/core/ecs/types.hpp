@@ -36,6 +36,7 @@ namespace ecs {
 
 	class Entity_manager;
 	class Entity_facet;
+	class Entity_batch;
 
 	using Component_index = int32_t;
 	using Component_type = int_fast16_t;
@@ -52,6 +53,37 @@ namespace ecs {
 
 	using Component_filter = std::function<bool(Component_type)>;
 
+	/// memory and queue statistics of a single component type (see Entity_manager::stats)
+	struct Component_stats {
+		std::string     name;
+		Component_type  type = 0;
+		Component_index size = 0;             //< live components
+		Component_index allocated_chunks = 0;
+		std::size_t     storage_bytes = 0;     //< components and their change tracking
+		Component_index free_slots = 0;       //< holes in the storage, reused by the next insertions
+		std::size_t     index_bytes = 0;      //< entity->component index
+		std::size_t     queued_insertions = 0; //< approximate
+		std::size_t     queued_deletions = 0;  //< approximate
+		int             unoptimized_deletes = 0;
+		float           fragmentation = 0.f;   //< free_slots / (size + free_slots)
+		bool            compacting = false;    //< an incremental compaction is in progress
+		float           fragmentation_before_compaction = 0.f; //< of the last compaction
+		float           fragmentation_after_compaction = 0.f;
+	};
+
+	/// see Entity_manager::stats
+	struct Ecs_stats {
+		Entity_id   used_slots = 0;      //< entity ids, that have been handed out at least once
+		Entity_id   allocated_slots = 0; //< size of the revision table of the handle generator
+		std::size_t free_handles = 0;    //< freed ids, waiting to be reused (approximate)
+		std::vector<Component_stats> components;
+		util::Chunk_allocator_stats chunks; //< of all pools (not only those of components)
+
+		auto live_entities()const noexcept {
+			return used_slots - static_cast<Entity_id>(free_handles);
+		}
+	};
+
 
 	/**
 	 * Thread-safe facet to a single entity.
@@ -103,6 +135,41 @@ namespace ecs {
 			Entity_handle _owner;
 	};
 
+	/**
+	 * Thread-safe facet to a set of entities, that have been created together by
+	 *   Entity_manager::emplace_bulk.
+	 * Components are emplaced for all entities at once (deferred, like Entity_facet::emplace)
+	 *   and queued as one contiguous block per component type.
+	 */
+	class Entity_batch {
+		public:
+			using iterator = std::vector<Entity_handle>::const_iterator;
+
+			Entity_batch() : _manager(nullptr) {}
+			Entity_batch(Entity_manager& manager, std::vector<Entity_handle> handles)
+			    : _manager(&manager), _handles(std::move(handles)) {}
+
+			template<typename T, typename... Args>
+			void emplace(const Args&... args);
+
+			/// init = func(T&, index:std::size_t)->void; called for each component before it is queued
+			template<typename T, typename F, typename... Args>
+			void emplace_init(F&& init, const Args&... args);
+
+			auto operator[](std::size_t i)const -> Entity_facet;
+			auto size()const noexcept {return _handles.size();}
+			auto empty()const noexcept {return _handles.empty();}
+			auto begin()const noexcept -> iterator {return _handles.begin();}
+			auto end()const noexcept -> iterator {return _handles.end();}
+			auto handles()const noexcept -> const std::vector<Entity_handle>& {return _handles;}
+
+			auto manager()noexcept -> Entity_manager& {return *_manager;}
+
+		private:
+			Entity_manager* _manager;
+			std::vector<Entity_handle> _handles;
+	};
+
 
 
 } /* namespace ecs */
@@ -0,0 +1,120 @@
+/** Joins over multiple component types (views & owning groups) **************
+ *                                                                           *
+ * Copyright (c) 2016 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#pragma once
+
+#include "component.hpp"
+
+#include <tuple>
+#include <array>
+#include <utility>
+#include <algorithm>
+
+
+namespace lux {
+namespace ecs {
+
+	/**
+	 * Non-owning join over multiple component types.
+	 * Iterates the smallest container and resolves the other components in blocks through
+	 *   their index policies. Entities that don't have all components are skipped.
+	 *
+	 * Same thread-safety as the direct iteration of a Component_container
+	 *   (i.e. must not run concurrently with process_queued_actions).
+	 */
+	template<class... C>
+	class Entity_view {
+		public:
+			Entity_view(Entity_manager& manager);
+
+			/// calls f(C&...) for each entity that owns all components
+			template<class F>
+			void for_each(F&& f);
+
+			/// upper bound of the number of entities in this view
+			auto size_hint()const -> Component_index;
+
+		private:
+			static constexpr std::size_t block_size = 64;
+			using Row = std::tuple<C*...>;
+
+			std::tuple<Component_container<C>*...> _containers;
+
+			template<class F, std::size_t... I>
+			void _dispatch(F& f, std::index_sequence<I...>);
+
+			template<std::size_t Driver, class F>
+			void _for_each(F& f);
+
+			template<std::size_t Driver, class F, std::size_t... I>
+			void _flush_block(F& f, const std::array<Entity_id, block_size>& ids,
+			                  std::array<Row, block_size>& rows, std::size_t count,
+			                  std::index_sequence<I...>);
+
+			template<std::size_t Target>
+			void _resolve(std::true_type /*is_driver*/, const std::array<Entity_id, block_size>&,
+			              std::array<Row, block_size>&, std::size_t) {}
+
+			template<std::size_t Target>
+			void _resolve(std::false_type /*is_driver*/, const std::array<Entity_id, block_size>& ids,
+			              std::array<Row, block_size>& rows, std::size_t count);
+	};
+
+
+	class Owning_group_base {
+		public:
+			virtual ~Owning_group_base() = default;
+
+			/// restores the grouping if any of the containers changed; NOT thread-safe
+			virtual void update() = 0;
+
+			virtual auto owns(Component_type)const noexcept -> bool = 0;
+	};
+
+	/**
+	 * Owning join over multiple component types.
+	 * The group reorders the storage of all its component types, so the components of each entity
+	 *   that owns all of them are stored at the same index in [0, size()) of each container.
+	 *   Iterating the group is therefore a linear scan without any index lookups.
+	 * The order is restored by Entity_manager::process_queued_actions (or lazily by for_each)
+	 *   whenever one of the containers has changed.
+	 * A component type can only be owned by a single group.
+	 *
+	 * NOT thread-safe
+	 */
+	template<class... C>
+	class Owning_group : public Owning_group_base {
+		public:
+			Owning_group(Entity_manager& manager);
+
+			/// calls f(C&...) for each entity that owns all components
+			template<class F>
+			void for_each(F&& f);
+
+			auto size() -> Component_index;
+
+			void update() override;
+			auto owns(Component_type type)const noexcept -> bool override;
+
+		private:
+			std::tuple<Component_container<C>*...> _containers;
+			std::array<uint64_t, sizeof...(C)>     _revisions;
+			Component_index                        _size = 0;
+			bool                                   _valid = false;
+
+			template<std::size_t... I>
+			bool _dirty(std::index_sequence<I...>)const;
+
+			template<std::size_t... I>
+			void _regroup(std::index_sequence<I...>);
+
+			template<class F, std::size_t... I>
+			void _for_each(F& f, std::index_sequence<I...>);
+	};
+
+} /* namespace ecs */
+}
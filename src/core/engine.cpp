@@ -9,6 +9,7 @@
 #include "renderer/graphics_ctx.hpp"
 #include "utils/log.hpp"
 #include "utils/rest.hpp"
+#include "utils/thread_pool.hpp"
 
 #include <stdexcept>
 #include <chrono>
@@ -68,6 +69,7 @@ namespace {
 	    _audio_ctx(std::make_unique<audio::Audio_ctx>(*_asset_manager)),
 	    _input_manager(std::make_unique<input::Input_manager>(_bus, *_asset_manager)),
 	    _gui(std::make_unique<gui::Gui>(*this)),
+	    _thread_pool(std::make_unique<util::Thread_pool>()),
 	    _current_time(SDL_GetTicks() / 1000.0f) {
 
 		_input_manager->viewport(_graphics_ctx->viewport());
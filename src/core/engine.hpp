@@ -24,6 +24,7 @@ namespace lux {
 	namespace renderer {class Graphics_ctx;}
 	namespace audio {class Audio_ctx;}
 	namespace gui {class Translator; class Gui;}
+	namespace util {class Thread_pool;}
 
 	struct Sdl_event_filter {
 		Sdl_event_filter(Engine&);
@@ -63,6 +64,7 @@ namespace lux {
 			auto& screens()noexcept {return _screens;}
 			auto& translator()noexcept {return *_translator;}
 			auto& gui()noexcept {return *_gui;}
+			auto& thread_pool()noexcept {return *_thread_pool;}
 
 		protected:
 			void _poll_events();
@@ -85,6 +87,7 @@ namespace lux {
 			std::unique_ptr<audio::Audio_ctx> _audio_ctx;
 			std::unique_ptr<input::Input_manager> _input_manager;
 			std::unique_ptr<gui::Gui> _gui;
+			std::unique_ptr<util::Thread_pool> _thread_pool;
 
 			double _current_time = 0;
 			double _last_time = 0;
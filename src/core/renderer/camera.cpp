@@ -26,6 +26,33 @@ namespace renderer {
 
 	using namespace unit_literals;
 
+	Frustum::Frustum(const glm::mat4& vp) {
+		// Gribb/Hartmann: the planes are sums/differences of the fourth and the other rows
+		auto row = [&](int i) {
+			return glm::vec4{vp[0][i], vp[1][i], vp[2][i], vp[3][i]};
+		};
+
+		_planes[0] = row(3) + row(0); // left
+		_planes[1] = row(3) - row(0); // right
+		_planes[2] = row(3) + row(1); // bottom
+		_planes[3] = row(3) - row(1); // top
+		_planes[4] = row(3) + row(2); // near
+		_planes[5] = row(3) - row(2); // far
+
+		for(auto& p : _planes) {
+			p /= glm::length(glm::vec3(p));
+		}
+	}
+
+	auto Frustum::intersects(glm::vec3 center, float radius)const noexcept -> bool {
+		for(auto& p : _planes) {
+			if(glm::dot(glm::vec3(p), center) + p.w < -radius)
+				return false;
+		}
+
+		return true;
+	}
+
 	glm::vec2 calculate_vscreen(const Engine& engine, int target_height) {
 		float width = engine.graphics_ctx().viewport().z;
 		float height = engine.graphics_ctx().viewport().w;
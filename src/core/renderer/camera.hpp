@@ -12,6 +12,8 @@
 
 #include "../units.hpp"
 
+#include <array>
+
 namespace lux {
 	class Engine;
 
@@ -20,6 +22,22 @@ namespace renderer {
 	extern glm::vec2 calculate_vscreen(const Engine& engine, int target_height);
 
 
+	/**
+	 * The six clipping planes of a view-projection matrix, used to skip objects that can't
+	 *   be visible before they are transformed and batched.
+	 */
+	class Frustum {
+		public:
+			explicit Frustum(const glm::mat4& vp);
+
+			/// conservative; false only if the sphere is completely outside of the frustum
+			auto intersects(glm::vec3 center, float radius)const noexcept -> bool;
+
+		private:
+			std::array<glm::vec4, 6> _planes; //< normalized; xyz=normal (pointing inwards), w=distance
+	};
+
+
 	class Camera {
 		public:
 			Camera(const glm::vec4& viewport, glm::mat4 proj);
@@ -41,6 +59,9 @@ namespace renderer {
 				view();
 				return _vp;
 			}
+			auto frustum() const -> Frustum {
+				return Frustum{vp()};
+			}
 			virtual auto eye_position() const noexcept -> glm::vec3 {
 				return glm::vec3(_inv_view * glm::vec4(0,0,0,1));
 			}
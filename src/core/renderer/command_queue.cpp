@@ -11,8 +11,13 @@
 #include "vertex_object.hpp"
 #include "shader.hpp"
 
+#include "../utils/radix_sort.hpp"
+
 #include <glm/glm.hpp>
 
+#include <algorithm>
+#include <limits>
+
 namespace lux {
 namespace renderer {
 
@@ -77,9 +82,23 @@ namespace renderer {
 	}
 
 
+	void Command_shard::push_back(const Command& command) {
+		_commands.push_back(command);
+		_commands.back()._update_hashes();
+	}
+
+
 	Command_queue::Command_queue(std::size_t expected) {
-		_commands.reserve(expected*0.9f);
-		_order_dependent_commands.reserve(expected*0.1f);
+		_commands.reserve(expected);
+		_keys.reserve(expected);
+		_sorted.reserve(expected);
+		_order_dependent.reserve(expected*0.1f);
+	}
+
+	template<class T>
+	auto Command_queue::State_ids<T>::get(T state, Sort_key max) -> Sort_key {
+		auto id = _ids.emplace(state, static_cast<Sort_key>(_ids.size())).first->second;
+		return std::min(id, max);
 	}
 
 
@@ -110,11 +129,10 @@ namespace renderer {
 
 	void Command_queue::_execute_commands(const IUniform_map* shared_uniforms,
 	                                      Command& last, bool& is_first,
-	                                      std::vector<Command>& commands) {
-		if(commands.empty())
-			return;
+	                                      const std::vector<Index>& commands) {
+		for(auto idx : commands) {
+			auto& cmd = _commands[idx];
 
-		for(auto& cmd : commands) {
 			// setup GL_options
 			if(is_first || last._gl_options!=cmd._gl_options) {
 				update_gl_options(last._gl_options, cmd._gl_options);
@@ -161,28 +179,109 @@ namespace renderer {
 	}
 
 	void Command_queue::flush() {
-		std::sort(_commands.begin(), _commands.end());
+		merge_shards();
+		_sort();
 
 		Command last;
 		bool is_first = true;
 
-		_execute_commands(_shared_uniforms.get(), last, is_first, _commands);
-		_execute_commands(_shared_uniforms.get(), last, is_first, _order_dependent_commands);
+		_execute_commands(_shared_uniforms.get(), last, is_first, _sorted);
+		_execute_commands(_shared_uniforms.get(), last, is_first, _order_dependent);
 
 		// reset GL_options if required
 		update_gl_options(last._gl_options, default_gl_options);
 
 		// clear our queue
 		_commands.clear();
-		_order_dependent_commands.clear();
+		_keys.clear();
+		_sorted.clear();
+		_order_dependent.clear();
+		_shader_ids.clear();
+		_texture_ids.clear();
+		_ext_uniform_ids.clear();
 	}
 
 	void Command_queue::push_back(const Command& command) {
-		std::vector<Command>& queue = command._order_dependent ?
-		                                  _order_dependent_commands : _commands;
+		_commands.push_back(command);
+		_commands.back()._update_hashes();
+		_index_last();
+	}
+
+	auto Command_queue::shard(std::size_t sequence) -> Command_shard& {
+		std::lock_guard<std::mutex> lock(_shards_mutex);
+
+		auto shard = std::unique_ptr<Command_shard>();
+		if(!_free_shards.empty()) {
+			shard = std::move(_free_shards.back());
+			_free_shards.pop_back();
+		} else {
+			shard = std::make_unique<Command_shard>();
+		}
+
+		_shards.emplace_back(sequence, std::move(shard));
+		return *_shards.back().second;
+	}
+
+	void Command_queue::merge_shards() {
+		if(_shards.empty())
+			return;
+
+		std::sort(_shards.begin(), _shards.end(), [](auto& lhs, auto& rhs) {
+			return lhs.first < rhs.first;
+		});
+
+		auto last_sequence = _shards.front().first;
+		for(auto& s : _shards) {
+			INVARIANT(&s==&_shards.front() || s.first!=last_sequence,
+			          "Duplicate sequence number of a Command_shard: "<<s.first);
+			last_sequence = s.first;
+
+			// the hashes have already been calculated by the recording thread
+			for(auto& cmd : s.second->_commands) {
+				_commands.push_back(cmd);
+				_index_last();
+			}
+
+			s.second->_commands.clear();
+			_free_shards.emplace_back(std::move(s.second));
+		}
+
+		_shards.clear();
+	}
+
+	void Command_queue::_index_last() {
+		INVARIANT(_commands.size() <= std::numeric_limits<Index>::max(), "Too many commands in the queue");
+
+		auto idx = static_cast<Index>(_commands.size() - 1);
+		auto& cmd = _commands.back();
+		if(cmd._order_dependent) {
+			_order_dependent.push_back(idx);
+		} else {
+			_keys.push_back(_sort_key(cmd));
+			_sorted.push_back(idx);
+		}
+	}
+
+	// same order of priorities as Command::operator<, except for _obj (which is usually unique)
+	auto Command_queue::_sort_key(const Command& cmd) -> Sort_key {
+		constexpr auto shader_bits  = 13u;
+		constexpr auto texture_bits = 28u;
+		constexpr auto ext_bits     = 20u;
+		auto max = [](auto bits) {return (Sort_key(1)<<bits) - 1;};
+
+		auto gl_options = static_cast<Sort_key>(cmd._gl_options & 0b111u);
+		auto shader     = _shader_ids.get(cmd._shader, max(shader_bits));
+		auto textures   = _texture_ids.get(cmd._textures_hash, max(texture_bits));
+		auto ext        = _ext_uniform_ids.get(cmd._ext_uniforms, max(ext_bits));
+
+		return gl_options << (shader_bits+texture_bits+ext_bits)
+		       | shader   << (texture_bits+ext_bits)
+		       | textures << ext_bits
+		       | ext;
+	}
 
-		queue.push_back(command);
-		queue.back()._update_hashes();
+	void Command_queue::_sort() {
+		util::radix_sort(_keys, _sorted, _tmp_keys, _tmp_indices);
 	}
 
 }
@@ -17,6 +17,10 @@
 
 #include <vector>
 #include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 
 namespace lux {
@@ -76,12 +80,14 @@ namespace renderer {
 			auto require(Gl_option) -> Command&;
 			auto require_not(Gl_option) -> Command&;
 			auto ext_uniforms(const IUniform_map&) -> Command&;
+			auto ext_uniforms()const noexcept {return _ext_uniforms;}
 			auto uniforms() -> Cmd_uniform_map&;
 
 			bool operator<(const Command& rhs)const noexcept;
 
 		private:
 			friend class Command_queue;
+			friend class Command_shard;
 
 			std::array<const Texture*, texture_units> _textures {};
 			Shader_program* _shader = nullptr;
@@ -100,6 +106,30 @@ namespace renderer {
 	inline auto create_command() -> Command {return Command{};}
 
 
+	/**
+	 * Records commands on a worker thread, that are later merged into its Command_queue.
+	 * Only the constructions of the commands can be moved to other threads this way, so the
+	 *   recorded commands must not require GL calls (e.g. buffer updates) until they are executed.
+	 */
+	class Command_shard {
+		public:
+			void push_back(const Command& command);
+
+			auto size()const noexcept {return _commands.size();}
+
+		private:
+			friend class Command_queue;
+
+			std::vector<Command> _commands;
+	};
+
+	/**
+	 * The commands are stored in a buffer, that keeps its capacity between frames, and are
+	 *   sorted indirectly by radix sorting their indices by a packed 64 bit key:
+	 *   [gl_options:3][shader:13][textures:28][ext_uniforms:20]
+	 * The ids in the key are assigned per flush, in order of their first use.
+	 * Commands with the same state keep their submission order.
+	 */
 	class Command_queue {
 		public:
 			Command_queue(std::size_t expected=64);
@@ -110,17 +140,82 @@ namespace renderer {
 			void flush();
 			void push_back(const Command& command);
 
+			/**
+			 * Returns an empty shard, that the calling thread can record into. Thread-safe.
+			 * The sequence numbers determine the merge order and have to be unique until the
+			 *   next merge, e.g. the first index of the work partition that is recorded.
+			 */
+			auto shard(std::size_t sequence) -> Command_shard&;
+			/**
+			 * Appends the commands of all shards in ascending order of their sequence numbers,
+			 *   as if they had been pushed to this queue directly.
+			 * NOT thread-safe; called after all recording threads are done (and by flush).
+			 */
+			void merge_shards();
+
+			/**
+			 * Calls f(const Command&) for all queued commands in the order, in which the next
+			 *   flush would execute them (e.g. to inspect the queue without a GL context).
+			 * Merges the shards first. NOT thread-safe.
+			 */
+			template<class F>
+			void for_each_ordered(F&& f);
+
 		private:
+			using Sort_key = uint64_t;
+			using Index = uint32_t;
+
+			// dense ids for the state of the pushed commands; saturate at the given maximum
+			template<class T>
+			class State_ids {
+				public:
+					auto get(T state, Sort_key max) -> Sort_key;
+					void clear() {_ids.clear();}
+
+				private:
+					std::unordered_map<T, Sort_key> _ids;
+			};
+
 			std::shared_ptr<IUniform_map> _shared_uniforms;
 
-			std::vector<Command> _commands;
-			std::vector<Command> _order_dependent_commands;
+			std::vector<Command>  _commands; //< arena of all commands pushed since the last flush
+			std::vector<Sort_key> _keys;
+			std::vector<Index>    _sorted;
+			std::vector<Index>    _order_dependent;
 
+			std::vector<Sort_key> _tmp_keys;
+			std::vector<Index>    _tmp_indices;
+
+			State_ids<const Shader_program*> _shader_ids;
+			State_ids<int>                   _texture_ids;
+			State_ids<const IUniform_map*>   _ext_uniform_ids;
+
+			using Shard_entry = std::pair<std::size_t, std::unique_ptr<Command_shard>>;
+			std::mutex                _shards_mutex;
+			std::vector<Shard_entry>  _shards;
+			std::vector<std::unique_ptr<Command_shard>> _free_shards; //< reused to keep their capacity
+
+			void _index_last(); //< adds the last command to _sorted or _order_dependent
+			auto _sort_key(const Command&) -> Sort_key;
+			void _sort();
 			void _execute_commands(const IUniform_map* shared_uniforms,
 			                       Command& last, bool& is_first,
-			                       std::vector<Command>& commands);
+			                       const std::vector<Index>& commands);
 	};
 
+	template<class F>
+	void Command_queue::for_each_ordered(F&& f) {
+		merge_shards();
+		_sort();
+
+		for(auto idx : _sorted) {
+			f(static_cast<const Command&>(_commands[idx]));
+		}
+		for(auto idx : _order_dependent) {
+			f(static_cast<const Command&>(_commands[idx]));
+		}
+	}
+
 
 
 }
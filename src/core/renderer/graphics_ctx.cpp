@@ -134,7 +134,8 @@ namespace renderer {
 		bloom,
 		supersampling,
 		shadow_softness,
-		fast_lighting
+		fast_lighting,
+		instanced_sprites
 	)
 
 	auto default_settings(int display) -> Graphics_settings {
@@ -157,6 +158,7 @@ namespace renderer {
 		s.supersampling = 1.f;
 		s.shadow_softness = 0.5f;
 		s.fast_lighting = false;
+		s.instanced_sprites = true;
 
 		return s;
 
@@ -172,6 +174,7 @@ namespace renderer {
 		s.supersampling = 0.5f;
 		s.shadow_softness = 0.0f;
 		s.fast_lighting = false;
+		s.instanced_sprites = false;
 
 		return s;
 #endif
@@ -33,6 +33,7 @@ namespace renderer {
 		float supersampling = 1.0f;
 		float shadow_softness = 0.5f;
 		bool fast_lighting = false;
+		bool instanced_sprites = false; //< ignored on ANDROID
 	};
 
 	extern auto default_settings(int display=0) -> Graphics_settings;
@@ -8,6 +8,7 @@
 
 #include "../utils/random.hpp"
 #include "../utils/sf2_glm.hpp"
+#include "../utils/thread_pool.hpp"
 
 #include <vector>
 
@@ -389,21 +390,51 @@ namespace renderer {
 
 		_emitters.erase(std::remove_if(_emitters.begin(),_emitters.end(), [](auto& e){return e->dead();}), _emitters.end());
 	}
-	void Particle_renderer::draw(Command_queue& queue)const {
-		for(auto& e : _emitters) {
-			auto cmd = create_command().shader(_simple_shader)
+	namespace {
+		// below that the overhead of the parallel recording outweighs the gains
+		constexpr auto min_parallel_emitters = std::size_t(32);
+
+		// interned once, because it is set for every emitter in every frame
+		const auto hue_change_in_uniform = Uniform_id{"hue_change_in"};
+
+		template<class Queue>
+		void draw_emitter(Queue& queue, Shader_program& shader, const Particle_emitter& e) {
+			auto cmd = create_command().shader(shader)
 					.require_not(Gl_option::depth_write)
 					.require(Gl_option::depth_test)
 					.require(Gl_option::blend)
 					.order_dependent();
 
-			cmd.uniforms().emplace("hue_change_in", e->hue_change_in() / (360_deg).value());
+			cmd.uniforms().emplace(hue_change_in_uniform, e.hue_change_in() / (360_deg).value());
 
-			if(e->draw(cmd))
+			if(e.draw(cmd))
 				queue.push_back(cmd);
 		}
 	}
 
+	void Particle_renderer::draw(Command_queue& queue)const {
+		for(auto& e : _emitters) {
+			draw_emitter(queue, _simple_shader, *e);
+		}
+	}
+	void Particle_renderer::draw(Command_queue& queue, util::Thread_pool& pool)const {
+		if(_emitters.size() < min_parallel_emitters) {
+			draw(queue);
+			return;
+		}
+
+		// emitter draws only read their own state and don't touch GL
+		pool.parallel_for(static_cast<int_fast64_t>(_emitters.size()), [&](auto begin, auto end) {
+			auto& shard = queue.shard(static_cast<std::size_t>(begin));
+			for(auto i=begin; i<end; i++) {
+				draw_emitter(shard, _simple_shader, *_emitters[static_cast<std::size_t>(i)]);
+			}
+		});
+
+		// keeps the submission order of the sequential version
+		queue.merge_shards();
+	}
+
 	void Particle_renderer::clear() {
 		_emitters.clear();
 	}
@@ -15,6 +15,9 @@
 
 namespace lux {
 	class Engine;
+	namespace util {
+		class Thread_pool;
+	}
 
 namespace renderer {
 
@@ -132,6 +135,8 @@ namespace renderer {
 
 			void update(Time dt);
 			void draw(Command_queue&)const;
+			/// records the commands of large numbers of emitters in parallel
+			void draw(Command_queue&, util::Thread_pool&)const;
 
 			void clear();
 
@@ -16,7 +16,11 @@
 
 #include <glm/gtc/type_ptr.hpp>
 
+#include <cstring>
+#include <deque>
+#include <mutex>
 #include <regex>
+#include <unordered_map>
 
 
 namespace lux {
@@ -98,6 +102,49 @@ namespace renderer {
 		}
 	}
 
+	namespace {
+		struct Uniform_names {
+			std::mutex mutex;
+			std::unordered_map<std::string, Uniform_id> ids;
+			std::deque<std::string> names; //< deque, so the c_str()s stay valid
+		};
+		// intentionally leaked, so ids in objects with static storage duration stay valid
+		auto uniform_names() -> Uniform_names& {
+			static auto names = new Uniform_names();
+			return *names;
+		}
+	}
+
+	Uniform_id::Uniform_id(const char* name) {
+		// most names are literals, that are passed again and again from the same call site
+		thread_local std::unordered_map<const char*, Uniform_id> known_addresses;
+
+		auto known = known_addresses.find(name);
+		if(known!=known_addresses.end() && std::strcmp(known->second._name, name)==0) {
+			*this = known->second;
+			return;
+		}
+
+		auto& names = uniform_names();
+		{
+			std::lock_guard<std::mutex> lock(names.mutex);
+
+			auto iter = names.ids.find(name);
+			if(iter==names.ids.end()) {
+				names.names.emplace_back(name);
+
+				auto id = Uniform_id{};
+				id._index = static_cast<uint32_t>(names.names.size()-1);
+				id._name = names.names.back().c_str();
+				iter = names.ids.emplace(names.names.back(), id).first;
+			}
+
+			*this = iter->second;
+		}
+
+		known_addresses[name] = *this;
+	}
+
 	Shader::Shader(Shader_type type, const std::string& source, const std::string& name)
 	    : _name(name) {
 		char const * source_pointer = source.c_str();
@@ -268,99 +315,133 @@ namespace renderer {
 
 
 	namespace {
+		// not yet queried from GL (which uses -1 for unknown uniforms)
+		constexpr auto unresolved_uniform = -2;
+
 		template<class T, class V>
-		auto locate_uniform(const char* name, int shader_handle, T& cache, const V& value) {
-			using ET = typename T::mapped_type;
-
-			auto dirty = false;
-			auto it = cache.find(name);
-			if (it == cache.end()) {
-				it = cache.emplace(name,
-				                   ET{glGetUniformLocation(shader_handle, name), value}).first;
-				dirty = true;
-			} else if(it->second.dirty(value)) {
-				dirty = true;
-				it->second.set(value);
+		auto locate_uniform(Uniform_id id, int shader_handle, T& cache, const V& value) {
+			using ET = typename T::value_type;
+
+			INVARIANT(id, "Uninitialized Uniform_id");
+
+			if(id.index()>=cache.size()) {
+				cache.resize(id.index()+1, ET{unresolved_uniform, value});
 			}
 
-			return std::make_pair(dirty, it->second.handle);
+			auto& entry = cache[id.index()];
+			if(entry.handle==unresolved_uniform) {
+				entry = ET{glGetUniformLocation(shader_handle, id.name()), value};
+				return std::make_pair(true, entry.handle);
+			}
+
+			auto dirty = entry.dirty(value);
+			if(dirty) {
+				entry.set(value);
+			}
+
+			return std::make_pair(dirty, entry.handle);
 		}
 	}
 
 	Shader_program& Shader_program::set_uniform(const char* name, int value) {
+		return set_uniform(Uniform_id{name}, value);
+	}
+	Shader_program& Shader_program::set_uniform(const char* name, float value) {
+		return set_uniform(Uniform_id{name}, value);
+	}
+	Shader_program& Shader_program::set_uniform(const char* name, const glm::vec2& value) {
+		return set_uniform(Uniform_id{name}, value);
+	}
+	Shader_program& Shader_program::set_uniform(const char* name, const glm::vec3& value) {
+		return set_uniform(Uniform_id{name}, value);
+	}
+	Shader_program& Shader_program::set_uniform(const char* name, const glm::vec4& value) {
+		return set_uniform(Uniform_id{name}, value);
+	}
+	Shader_program& Shader_program::set_uniform(const char* name, const glm::mat2& value) {
+		return set_uniform(Uniform_id{name}, value);
+	}
+	Shader_program& Shader_program::set_uniform(const char* name, const glm::mat3& value) {
+		return set_uniform(Uniform_id{name}, value);
+	}
+	Shader_program& Shader_program::set_uniform(const char* name, const glm::mat4& value) {
+		return set_uniform(Uniform_id{name}, value);
+	}
+
+	Shader_program& Shader_program::set_uniform(Uniform_id id, int value) {
 		auto dirty = true;
 		auto handle = 0;
-		std::tie(dirty, handle) = locate_uniform(name, _handle, _uniform_locations_int, value);
+		std::tie(dirty, handle) = locate_uniform(id, _handle, _uniform_locations_int, value);
 
 		if(dirty)
 			glUniform1i(handle, value);
 
 		return *this;
 	}
-	Shader_program& Shader_program::set_uniform(const char* name, float value) {
+	Shader_program& Shader_program::set_uniform(Uniform_id id, float value) {
 		auto dirty = true;
 		auto handle = 0;
-		std::tie(dirty, handle) = locate_uniform(name, _handle, _uniform_locations_float, value);
+		std::tie(dirty, handle) = locate_uniform(id, _handle, _uniform_locations_float, value);
 
 		if(dirty)
 			glUniform1f(handle, value);
 
 		return *this;
 	}
-	Shader_program& Shader_program::set_uniform(const char* name, const glm::vec2& value) {
+	Shader_program& Shader_program::set_uniform(Uniform_id id, const glm::vec2& value) {
 		auto dirty = true;
 		auto handle = 0;
-		std::tie(dirty, handle) = locate_uniform(name, _handle, _uniform_locations_vec2, value);
+		std::tie(dirty, handle) = locate_uniform(id, _handle, _uniform_locations_vec2, value);
 
 		if(dirty)
 			glUniform2fv(handle, 1, glm::value_ptr(value));
 
 		return *this;
 	}
-	Shader_program& Shader_program::set_uniform(const char* name, const glm::vec3& value) {
+	Shader_program& Shader_program::set_uniform(Uniform_id id, const glm::vec3& value) {
 		auto dirty = true;
 		auto handle = 0;
-		std::tie(dirty, handle) = locate_uniform(name, _handle, _uniform_locations_vec3, value);
+		std::tie(dirty, handle) = locate_uniform(id, _handle, _uniform_locations_vec3, value);
 
 		if(dirty)
 			glUniform3fv(handle, 1, glm::value_ptr(value));
 
 		return *this;
 	}
-	Shader_program& Shader_program::set_uniform(const char* name, const glm::vec4& value) {
+	Shader_program& Shader_program::set_uniform(Uniform_id id, const glm::vec4& value) {
 		auto dirty = true;
 		auto handle = 0;
-		std::tie(dirty, handle) = locate_uniform(name, _handle, _uniform_locations_vec4, value);
+		std::tie(dirty, handle) = locate_uniform(id, _handle, _uniform_locations_vec4, value);
 
 		if(dirty)
 			glUniform4fv(handle, 1, glm::value_ptr(value));
 
 		return *this;
 	}
-	Shader_program& Shader_program::set_uniform(const char* name, const glm::mat2& value) {
+	Shader_program& Shader_program::set_uniform(Uniform_id id, const glm::mat2& value) {
 		auto dirty = true;
 		auto handle = 0;
-		std::tie(dirty, handle) = locate_uniform(name, _handle, _uniform_locations_mat2, value);
+		std::tie(dirty, handle) = locate_uniform(id, _handle, _uniform_locations_mat2, value);
 
 		if(dirty)
 			glUniformMatrix2fv(handle, 1, GL_FALSE, glm::value_ptr(value));
 
 		return *this;
 	}
-	Shader_program& Shader_program::set_uniform(const char* name, const glm::mat3& value) {
+	Shader_program& Shader_program::set_uniform(Uniform_id id, const glm::mat3& value) {
 		auto dirty = true;
 		auto handle = 0;
-		std::tie(dirty, handle) = locate_uniform(name, _handle, _uniform_locations_mat3, value);
+		std::tie(dirty, handle) = locate_uniform(id, _handle, _uniform_locations_mat3, value);
 
 		if(dirty)
 			glUniformMatrix3fv(handle, 1, GL_FALSE, glm::value_ptr(value));
 
 		return *this;
 	}
-	Shader_program& Shader_program::set_uniform(const char* name, const glm::mat4& value) {
+	Shader_program& Shader_program::set_uniform(Uniform_id id, const glm::mat4& value) {
 		auto dirty = true;
 		auto handle = 0;
-		std::tie(dirty, handle) = locate_uniform(name, _handle, _uniform_locations_mat4, value);
+		std::tie(dirty, handle) = locate_uniform(id, _handle, _uniform_locations_mat4, value);
 
 		if(dirty)
 			glUniformMatrix4fv(handle, 1, GL_FALSE, glm::value_ptr(value));
@@ -13,9 +13,9 @@
 
 #include <gsl.h>
 
+#include <cstdint>
 #include <string>
 #include <memory>
-#include <unordered_map>
 #include <vector>
 
 namespace lux {
@@ -56,6 +56,34 @@ namespace renderer {
 
 	struct IUniform_map;
 
+	/**
+	 * Interned name of a uniform. The ids are dense, process wide and never released, so
+	 *   programs can resolve them into tables of locations instead of looking up strings.
+	 * Constructing an id from the same string (address) again is cheap, but the ids of
+	 *   uniforms that are set each frame should still be created once up front.
+	 * Thread-safe.
+	 */
+	class Uniform_id {
+		public:
+			Uniform_id() = default;
+			explicit Uniform_id(const char* name);
+
+			auto index()const noexcept {return _index;}
+			auto name()const noexcept {return _name;}
+			explicit operator bool()const noexcept {return _name!=nullptr;}
+
+			friend bool operator==(Uniform_id lhs, Uniform_id rhs)noexcept {
+				return lhs._index==rhs._index;
+			}
+			friend bool operator!=(Uniform_id lhs, Uniform_id rhs)noexcept {
+				return !(lhs==rhs);
+			}
+
+		private:
+			uint32_t    _index = 0;
+			const char* _name = nullptr; //< owned by the intern table
+	};
+
 	class Shader_program {
 		public:
 			Shader_program() = default;
@@ -83,6 +111,15 @@ namespace renderer {
 			Shader_program& set_uniform(const char* name, const glm::mat3& value);
 			Shader_program& set_uniform(const char* name, const glm::mat4& value);
 
+			Shader_program& set_uniform(Uniform_id id, int value);
+			Shader_program& set_uniform(Uniform_id id, float value);
+			Shader_program& set_uniform(Uniform_id id, const glm::vec2& value);
+			Shader_program& set_uniform(Uniform_id id, const glm::vec3& value);
+			Shader_program& set_uniform(Uniform_id id, const glm::vec4& value);
+			Shader_program& set_uniform(Uniform_id id, const glm::mat2& value);
+			Shader_program& set_uniform(Uniform_id id, const glm::mat3& value);
+			Shader_program& set_uniform(Uniform_id id, const glm::mat4& value);
+
 		private:
 			template<class T, class=void>
 			struct Uniform_entry {
@@ -103,8 +140,9 @@ namespace renderer {
 				bool dirty(const T&)const {return true;}
 				void set(const T&) {}
 			};
+			/// indexed by Uniform_id::index; the locations are resolved on first use
 			template<class T>
-			using Uniform_cache = std::unordered_map<std::string, Uniform_entry<T>>;
+			using Uniform_cache = std::vector<Uniform_entry<T>>;
 
 			struct Prog_handle {
 				int v;
@@ -49,6 +49,24 @@ namespace renderer {
 		batch.insert(position, _vertices);
 	}
 
+	auto Smart_texture::bounds() -> glm::vec4 {
+		if(_dirty) {
+			_update_vertices();
+			_dirty = false;
+		}
+
+		return _bounds;
+	}
+
+	auto Smart_texture::geometry() -> const std::vector<Sprite_vertex>& {
+		if(_dirty) {
+			_update_vertices();
+			_dirty = false;
+		}
+
+		return _vertices;
+	}
+
 	namespace {
 		auto cross(glm::vec2 v, glm::vec2 w) {
 			return v.x*w.y - v.y*w.x;
@@ -497,6 +515,19 @@ namespace renderer {
 
 		triangulate_background(_points, _vertices, _shadowcaster, _decals_intensity, *_material);
 		triangulate_border(_points, _vertices, _shadowcaster, _decals_intensity, *_material);
+
+		_bounds = glm::vec4{0,0,0,0};
+		if(!_vertices.empty()) {
+			auto min = _vertices.front().position.xy();
+			auto max = min;
+			for(auto& v : _vertices) {
+				min = glm::min(min, v.position.xy());
+				max = glm::max(max, v.position.xy());
+			}
+			_bounds = glm::vec4{min, max};
+		}
+
+		_revision++;
 	}
 
 	auto Smart_texture::vertices()const -> std::vector<glm::vec2> {
@@ -71,12 +71,22 @@ namespace renderer {
 
 			void draw(glm::vec3 position, Sprite_batch&);
 
+			/// min (xy) and max (zw) of the generated geometry, relative to the position
+			auto bounds() -> glm::vec4;
+
+			/// the generated vertices, relative to the position
+			auto geometry() -> const std::vector<Sprite_vertex>&;
+			/// incremented each time the geometry is regenerated
+			auto revision()const noexcept {return _revision;}
+
 		private:
 			Material_ptr _material;
 			bool _shadowcaster=true;
 			float _decals_intensity=0.f;
 			std::vector<glm::vec2> _points;
 			std::vector<Sprite_vertex> _vertices;
+			glm::vec4 _bounds;
+			uint32_t _revision = 0;
 			bool _dirty;
 
 			void _update_vertices();
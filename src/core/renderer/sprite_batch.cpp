@@ -4,6 +4,8 @@
 
 #include "command_queue.hpp"
 
+#include "../utils/radix_sort.hpp"
+
 namespace lux {
 namespace renderer {
 
@@ -21,6 +23,47 @@ namespace renderer {
 			Sprite_vertex{{-0.5f,-0.5f, 0.f}, {}, {0,1}, def_uv_clip, {1,0}, {0,0}, 0, 0.f, nullptr},
 			Sprite_vertex{{+0.5f,-0.5f, 0.f}, {}, {1,1}, def_uv_clip, {1,0}, {0,0}, 0, 0.f, nullptr}
 		};
+
+		// interned once, because they are set for every draw command
+		const auto alpha_cutoff_uniform = Uniform_id{"alpha_cutoff"};
+		const auto model_uniform = Uniform_id{"model"};
+
+		// order preserving mapping of the quantized z-coordinate (see Sprite_vertex::operator<)
+		auto quantize_z(float z) -> uint32_t {
+			auto zq = static_cast<int32_t>(std::floor(z*1000.f));
+			return static_cast<uint32_t>(zq) ^ 0x80000000u;
+		}
+
+		/*
+		 * Builds a key that orders the same as Sprite_vertex::operator<
+		 *   alpha:     [1:1][z:32][material:31]  ascending z, then material
+		 *   non-alpha: [1:0][material:31][~z:32] material, then descending z
+		 * material_rank has to preserve the order of the material pointers
+		 */
+		auto build_sort_key(bool alpha, float z, uint64_t material_rank) -> uint64_t {
+			INVARIANT(material_rank < (1ull<<31), "Too many materials in one batch");
+
+			auto zq = static_cast<uint64_t>(quantize_z(z));
+
+			if(alpha) {
+				return 1ull<<63 | zq<<31 | material_rank;
+			} else {
+				return material_rank<<32 | (~zq & 0xffffffffull);
+			}
+		}
+
+		// sorts and removes duplicates, so the position of a material is its rank
+		void unique_materials(std::vector<const renderer::Material*>& materials) {
+			std::sort(materials.begin(), materials.end());
+			materials.erase(std::unique(materials.begin(), materials.end()), materials.end());
+		}
+		auto material_rank(const std::vector<const renderer::Material*>& unique_materials,
+		                   const renderer::Material* m) -> uint64_t {
+			auto iter = std::lower_bound(unique_materials.begin(), unique_materials.end(), m);
+			return static_cast<uint64_t>(std::distance(unique_materials.begin(), iter));
+		}
+
+		std::unique_ptr<Shader_program> sprite_instance_shader;
 	}
 
 	Vertex_layout sprite_layout {
@@ -35,6 +78,30 @@ namespace renderer {
 		vertex("decals_intensity",  &Sprite_vertex::decals_intensity)
 	};
 
+	Vertex_layout sprite_instance_layout {
+		Vertex_layout::Mode::triangles,
+		vertex("quad_position",     &Sprite_quad_vertex::position),
+		vertex("quad_uv",           &Sprite_quad_vertex::uv),
+		vertex("position",          &Sprite_instance::position,          1, 1),
+		vertex("rotation",          &Sprite_instance::rotation,          1, 1),
+		vertex("size",              &Sprite_instance::size,              1, 1),
+		vertex("decals_offset",     &Sprite_instance::decals_offset,     1, 1),
+		vertex("uv_clip",           &Sprite_instance::uv_clip,           1, 1),
+		vertex("hue_change",        &Sprite_instance::hue_change,        1, 1),
+		vertex("shadow_resistence", &Sprite_instance::shadow_resistence, 1, 1),
+		vertex("decals_intensity",  &Sprite_instance::decals_intensity,  1, 1)
+	};
+
+	const std::vector<Sprite_quad_vertex> sprite_unit_quad {
+		Sprite_quad_vertex{{-0.5f,-0.5f}, {0,1}},
+		Sprite_quad_vertex{{-0.5f,+0.5f}, {0,0}},
+		Sprite_quad_vertex{{+0.5f,+0.5f}, {1,0}},
+
+		Sprite_quad_vertex{{+0.5f,+0.5f}, {1,0}},
+		Sprite_quad_vertex{{-0.5f,-0.5f}, {0,1}},
+		Sprite_quad_vertex{{+0.5f,-0.5f}, {1,1}}
+	};
+
 	Sprite::Sprite(glm::vec3 position, Angle rotation, glm::vec2 size,
 	               glm::vec4 uv, float shadow_resistence, float decals_intensity,
 	               const renderer::Material& material, glm::vec2 decals_offset)noexcept
@@ -68,6 +135,82 @@ namespace renderer {
 		                  "last_frame_tex", int(Texture_unit::last_frame),
 		                  "decals_tex", int(Texture_unit::decals)
 		              ));
+
+		sprite_instance_shader = std::make_unique<Shader_program>();
+		sprite_instance_shader->attach_shader(asset_manager.load<Shader>("vert_shader:sprite_instanced"_aid))
+		                       .attach_shader(asset_manager.load<Shader>("frag_shader:sprite"_aid))
+		                       .bind_all_attribute_locations(sprite_instance_layout)
+		                       .build()
+		                       .uniforms(make_uniform_map(
+		                           "albedo_tex", int(Texture_unit::color),
+		                           "normal_tex", int(Texture_unit::normal),
+		                           "material_tex", int(Texture_unit::material),
+		                           "height_tex", int(Texture_unit::height),
+		                           "shadowmaps_tex", int(Texture_unit::shadowmaps),
+		                           "environment_tex", int(Texture_unit::environment),
+		                           "last_frame_tex", int(Texture_unit::last_frame),
+		                           "decals_tex", int(Texture_unit::decals)
+		                       ));
+	}
+
+	auto calc_sprite_uv_clip(glm::vec4 uv, glm::vec4 tex_clip, glm::vec2 tex_size)noexcept -> glm::vec4 {
+		auto sprite_clip = uv;
+
+		// rescale uv to texture clip_rect
+		sprite_clip.x *= (tex_clip.z - tex_clip.x);
+		sprite_clip.z *= (tex_clip.z - tex_clip.x);
+		sprite_clip.y *= (tex_clip.w - tex_clip.y);
+		sprite_clip.w *= (tex_clip.w - tex_clip.y);
+		// move uv by clip_rect offset
+		sprite_clip.x += tex_clip.x;
+		sprite_clip.z += tex_clip.x;
+		sprite_clip.y += tex_clip.y;
+		sprite_clip.w += tex_clip.y;
+
+		sprite_clip.x += 0.5f / tex_size.x;
+		sprite_clip.y += 0.5f / tex_size.y;
+		sprite_clip.z -= 0.5f / tex_size.x;
+		sprite_clip.w -= 0.5f / tex_size.y;
+
+		return sprite_clip;
+	}
+
+	auto pack_sprite_instance(const Sprite& sprite, glm::vec4 texture_clip,
+	                          glm::vec2 texture_size)noexcept -> Sprite_instance {
+		return Sprite_instance {
+			sprite.position,
+			sprite.rotation.value(),
+			sprite.size,
+			sprite.decals_offset,
+			calc_sprite_uv_clip(sprite.uv, texture_clip, texture_size),
+			sprite.hue_change,
+			sprite.shadow_resistence,
+			sprite.decals_intensity
+		};
+	}
+
+	void generate_sprite_vertices(const Sprite& sprite, glm::vec4 texture_clip,
+	                              glm::vec2 texture_size, Sprite_vertex* out) {
+		auto scale = vec3 {
+			sprite.size.x,
+			sprite.size.y,
+			1.f
+		};
+
+		auto transform = [&](vec3 p) {
+			return sprite.position + rotate(p*scale, sprite.rotation, vec3{0,0,1});
+		};
+
+		auto tangent = rotate(vec3(1,0,0), sprite.rotation, vec3{0,0,1}).xy();
+
+		auto sprite_clip = calc_sprite_uv_clip(sprite.uv, texture_clip, texture_size);
+
+		for(auto& vert : single_sprite_vert) {
+			*out = Sprite_vertex{transform(vert.position), sprite.decals_offset, vert.uv, sprite_clip,
+			                     tangent, sprite.hue_change, sprite.shadow_resistence,
+			                     sprite.decals_intensity, sprite.material};
+			++out;
+		}
 	}
 
 	Sprite_batch::Sprite_batch(std::size_t expected_size)
@@ -78,10 +221,25 @@ namespace renderer {
 
 		_vertices.reserve(expected_size*4);
 		_objects.reserve(expected_size*0.25f);
+		_records.reserve(expected_size);
+	}
+
+	void Sprite_batch::sort_mode(Sort_mode mode) {
+		INVARIANT(_vertices.empty(), "The sort_mode can only be changed between flushes");
+		_sort_mode = mode;
 	}
 
 	auto Sprite_batch::_reserve_space(float z, const renderer::Material* material,
 	                                  std::size_t count) -> Vertex_iter {
+		if(_sort_mode==Sort_mode::radix) {
+			// append unsorted; the actual order is established in _sort()
+			auto begin = _vertices.size();
+			_vertices.resize(begin + count);
+			_records.push_back(Sort_record{material, z, static_cast<uint32_t>(begin),
+			                               static_cast<uint32_t>(count)});
+			return _vertices.begin() + static_cast<std::ptrdiff_t>(begin);
+		}
+
 		// reserve enough space (first operation because of possible iterator invalidation)
 		auto initial_size = _vertices.size();
 		if(_vertices.capacity() < initial_size+count) {
@@ -115,52 +273,21 @@ namespace renderer {
 		return ip;
 	}
 	void Sprite_batch::insert(const Sprite& sprite) {
-		auto scale = vec3 {
-			sprite.size.x,
-			sprite.size.y,
-			1.f
-		};
-
-		auto transform = [&](vec3 p) {
-			return sprite.position + rotate(p*scale, sprite.rotation, vec3{0,0,1});
-		};
-
-		auto tangent = rotate(vec3(1,0,0), sprite.rotation, vec3{0,0,1}).xy();
-
-		auto tex_clip = sprite.material->albedo().clip_rect();
-		auto sprite_clip = sprite.uv;
-
-		// rescale uv to texture clip_rect
-		sprite_clip.x *= (tex_clip.z - tex_clip.x);
-		sprite_clip.z *= (tex_clip.z - tex_clip.x);
-		sprite_clip.y *= (tex_clip.w - tex_clip.y);
-		sprite_clip.w *= (tex_clip.w - tex_clip.y);
-		// move uv by clip_rect offset
-		sprite_clip.x += tex_clip.x;
-		sprite_clip.z += tex_clip.x;
-		sprite_clip.y += tex_clip.y;
-		sprite_clip.w += tex_clip.y;
-
-		sprite_clip.x += 0.5f / sprite.material->albedo().width();
-		sprite_clip.y += 0.5f / sprite.material->albedo().height();
-		sprite_clip.z -= 0.5f / sprite.material->albedo().width();
-		sprite_clip.w -= 0.5f / sprite.material->albedo().height();
-
 		auto iter = _reserve_space(sprite.position.z, sprite.material, single_sprite_vert.size());
 
-		for(auto& vert : single_sprite_vert) {
-			*iter = Sprite_vertex{transform(vert.position), sprite.decals_offset, vert.uv, sprite_clip,
-			                      tangent, sprite.hue_change, sprite.shadow_resistence,
-			                      sprite.decals_intensity, sprite.material};
-			iter++;
-		}
+		auto& albedo = sprite.material->albedo();
+		generate_sprite_vertices(sprite, albedo.clip_rect(), glm::vec2{albedo.width(), albedo.height()},
+		                         &*iter);
 	}
 	void Sprite_batch::insert(glm::vec3 position,
 	                          const std::vector<Sprite_vertex>& vertices) {
 		if(vertices.empty())
 			return;
 
-		auto begin = _reserve_space(position.z, vertices.front().material, vertices.size());
+		// sorted by the z the first vertex is stored with (as Sprite_vertex::operator< sees it),
+		//   which differs from position.z for blocks with a z-offset (e.g. Smart_texture borders)
+		auto z = position.z + vertices.front().position.z;
+		auto begin = _reserve_space(z, vertices.front().material, vertices.size());
 		auto iter = begin;
 
 		for(auto& v : vertices) {
@@ -176,11 +303,54 @@ namespace renderer {
 	}
 
 	void Sprite_batch::flush(Command_queue& queue) {
+		if(_sort_mode==Sort_mode::radix) {
+			_sort();
+		}
+
 		_draw(queue);
 		_vertices.clear();
+		_records.clear();
 		_free_obj = 0;
 	}
 
+	void Sprite_batch::_sort() {
+		if(_records.empty())
+			return;
+
+		// the order of materials is defined by their address, so we rank them by it
+		_record_materials.clear();
+		for(auto& r : _records) {
+			if(_record_materials.empty() || _record_materials.back()!=r.material) {
+				_record_materials.push_back(r.material);
+			}
+		}
+		unique_materials(_record_materials);
+
+		// the insertion mode places new vertices before existing ones with an equal key.
+		// To reproduce this the records are inserted back-to-front into the (stable) sort
+		_sort_keys.clear();
+		_sort_indices.clear();
+		for(auto i=_records.size(); i>0; i--) {
+			auto& r = _records[i-1];
+			auto alpha = r.material ? r.material->alpha() : false;
+			_sort_keys.push_back(build_sort_key(alpha, r.z, material_rank(_record_materials, r.material)));
+			_sort_indices.push_back(static_cast<uint32_t>(i-1));
+		}
+
+		util::radix_sort(_sort_keys, _sort_indices, _sort_keys_tmp, _sort_indices_tmp);
+
+		// gather the vertices in their final order
+		_sorted_vertices.clear();
+		_sorted_vertices.reserve(_vertices.size());
+		for(auto i : _sort_indices) {
+			auto& r = _records[i];
+			auto begin = _vertices.begin() + static_cast<std::ptrdiff_t>(r.begin);
+			_sorted_vertices.insert(_sorted_vertices.end(), begin, begin + r.count);
+		}
+
+		_vertices.swap(_sorted_vertices);
+	}
+
 	void Sprite_batch::_draw(Command_queue& queue) {
 		_reserve_objects();
 
@@ -233,11 +403,11 @@ namespace renderer {
 		        .shader(_shader)
 		        .object(_objects.at(obj_idx));
 
-		cmd.uniforms().emplace("alpha_cutoff",begin->material->alpha() ? 1.f/255 : 0.9f);
+		cmd.uniforms().emplace(alpha_cutoff_uniform, begin->material->alpha() ? 1.f/255 : 0.9f);
 
 		begin->material->set_textures(cmd);
 
-		cmd.uniforms().emplace("model", glm::mat4());
+		cmd.uniforms().emplace(model_uniform, glm::mat4());
 
 		return cmd;
 	}
@@ -260,5 +430,330 @@ namespace renderer {
 		}
 	}
 
+
+	Sprite_instance_batch::Sprite_instance_batch(std::size_t expected_size)
+	    : Sprite_instance_batch(*sprite_instance_shader, expected_size) {
+	}
+	Sprite_instance_batch::Sprite_instance_batch(Shader_program& shader, std::size_t expected_size)
+	    : _shader(shader) {
+
+		_instances.reserve(expected_size);
+		_materials.reserve(expected_size);
+		_objects.reserve(expected_size*0.25f);
+	}
+
+	void Sprite_instance_batch::insert(const Sprite& sprite) {
+		INVARIANT(sprite.material, "Sprite without material");
+
+		auto& albedo = sprite.material->albedo();
+		_instances.push_back(pack_sprite_instance(sprite, albedo.clip_rect(),
+		                                          glm::vec2{albedo.width(), albedo.height()}));
+		_materials.push_back(sprite.material);
+	}
+
+	void Sprite_instance_batch::flush(Command_queue& queue) {
+		_sort();
+		_draw(queue);
+		_instances.clear();
+		_materials.clear();
+		_free_obj = 0;
+	}
+
+	void Sprite_instance_batch::_sort() {
+		if(_instances.empty())
+			return;
+
+		_unique_materials.clear();
+		for(auto m : _materials) {
+			if(_unique_materials.empty() || _unique_materials.back()!=m) {
+				_unique_materials.push_back(m);
+			}
+		}
+		unique_materials(_unique_materials);
+
+		// back-to-front to match the order of Sprite_batch (see Sprite_batch::_sort)
+		_sort_keys.clear();
+		_sort_indices.clear();
+		for(auto i=_instances.size(); i>0; i--) {
+			auto m = _materials[i-1];
+			_sort_keys.push_back(build_sort_key(m->alpha(), _instances[i-1].position.z,
+			                                    material_rank(_unique_materials, m)));
+			_sort_indices.push_back(static_cast<uint32_t>(i-1));
+		}
+
+		util::radix_sort(_sort_keys, _sort_indices, _sort_keys_tmp, _sort_indices_tmp);
+
+		_sorted_instances.clear();
+		_sorted_materials.clear();
+		for(auto i : _sort_indices) {
+			_sorted_instances.push_back(_instances[i]);
+			_sorted_materials.push_back(_materials[i]);
+		}
+
+		_instances.swap(_sorted_instances);
+		_materials.swap(_sorted_materials);
+	}
+
+	void Sprite_instance_batch::_draw(Command_queue& queue) {
+		_reserve_objects();
+
+		// draw one batch for each material
+		auto last = std::size_t(0);
+		for(auto current=std::size_t(0); current<_instances.size(); ++current) {
+			if(_materials[current] != _materials[last]) {
+				queue.push_back(_draw_part(_instances.begin()+last, _instances.begin()+current,
+				                           *_materials[last]));
+				last = current;
+			}
+		}
+
+		if(last<_instances.size())
+			queue.push_back(_draw_part(_instances.begin()+last, _instances.end(), *_materials[last]));
+	}
+
+	auto Sprite_instance_batch::_draw_part(Instance_citer begin, Instance_citer end,
+	                                       const renderer::Material& material) -> Command {
+		INVARIANT(begin!=end, "Invalid iterators");
+
+		auto obj_idx = _free_obj++;
+
+		INVARIANT(obj_idx<_objects.size(), "Too few objects reserved");
+
+		_objects.at(obj_idx).buffer(1).set(begin, end);
+
+		auto cmd = create_command()
+		        .shader(_shader)
+		        .object(_objects.at(obj_idx));
+
+		cmd.uniforms().emplace(alpha_cutoff_uniform, material.alpha() ? 1.f/255 : 0.9f);
+
+		material.set_textures(cmd);
+
+		cmd.uniforms().emplace(model_uniform, glm::mat4());
+
+		return cmd;
+	}
+	void Sprite_instance_batch::_reserve_objects() {
+		auto req_objs = 0u;
+		auto last_mat = static_cast<const Material*>(nullptr);
+		for(auto m : _materials) {
+			if(m!=last_mat) {
+				last_mat = m;
+				req_objs++;
+			}
+		}
+		if(req_objs>_objects.size()) {
+			_objects.reserve(req_objs);
+			req_objs-=_objects.size();
+			for(auto i=0u; i<req_objs; i++) {
+				_objects.emplace_back(sprite_instance_layout,
+				                      create_buffer(sprite_unit_quad),
+				                      create_dynamic_buffer<Sprite_instance>(32));
+			}
+		}
+	}
+
+
+
+	Static_sprite_batch::Static_sprite_batch(float bucket_depth)
+	    : Static_sprite_batch(*sprite_shader, bucket_depth) {
+	}
+	Static_sprite_batch::Static_sprite_batch(Shader_program& shader, float bucket_depth)
+	    : _shader(shader), _bucket_depth(bucket_depth) {
+		INVARIANT(bucket_depth>0.f, "Invalid bucket depth for the Static_sprite_batch: "<<bucket_depth);
+	}
+
+	auto Static_sprite_batch::update(Handle handle, const Sprite& sprite) -> Handle {
+		INVARIANT(sprite.material, "Sprite without material");
+
+		auto entry = _insert(handle, sprite.material, sprite.position.z);
+		auto& vertices = std::get<1>(entry).vertices;
+		vertices.resize(single_sprite_vert.size());
+		auto& albedo = sprite.material->albedo();
+		generate_sprite_vertices(sprite, albedo.clip_rect(), glm::vec2{albedo.width(), albedo.height()},
+		                         vertices.data());
+
+		return std::get<0>(entry);
+	}
+	auto Static_sprite_batch::update(Handle handle, glm::vec3 position,
+	                                 const std::vector<Sprite_vertex>& vertices) -> Handle {
+		if(vertices.empty()) {
+			erase(handle);
+			return {};
+		}
+
+		auto entry = _insert(handle, vertices.front().material, position.z);
+		auto& entry_vertices = std::get<1>(entry).vertices;
+		entry_vertices.clear();
+		entry_vertices.reserve(vertices.size());
+		for(auto& v : vertices) {
+			entry_vertices.emplace_back(v.position + position, v.decals_offset,
+			                            v.uv, v.uv_clip, v.tangent, v.hue_change,
+			                            v.shadow_resistence, v.decals_intensity, v.material);
+		}
+
+		return std::get<0>(entry);
+	}
+	auto Static_sprite_batch::keep(Handle handle)noexcept -> bool {
+		if(!_valid(handle))
+			return false;
+
+		_entries[static_cast<std::size_t>(handle.index)].frame = _frame;
+		return true;
+	}
+	void Static_sprite_batch::erase(Handle handle) {
+		if(!_valid(handle))
+			return;
+
+		_unlink(handle.index);
+
+		auto& entry = _entries[static_cast<std::size_t>(handle.index)];
+		entry.used = false;
+		entry.generation++;
+		entry.vertices.clear();
+		_free_entries.push_back(handle.index);
+	}
+	void Static_sprite_batch::clear() {
+		for(auto i=0u; i<_entries.size(); i++) {
+			auto& entry = _entries[i];
+			if(entry.used) {
+				entry.used = false;
+				entry.generation++;
+				entry.vertices.clear();
+				_free_entries.push_back(static_cast<int32_t>(i));
+			}
+		}
+
+		_buckets.clear();
+	}
+
+	void Static_sprite_batch::flush(Command_queue& queue, const Frustum& frustum) {
+		// remove entries that haven't been kept alive since the last flush
+		for(auto i=0u; i<_entries.size(); i++) {
+			auto& entry = _entries[i];
+			if(entry.used && entry.frame!=_frame) {
+				erase(Handle{static_cast<int32_t>(i), entry.generation});
+			}
+		}
+
+		_rebuilt_buckets = 0;
+		for(auto iter=_buckets.begin(); iter!=_buckets.end();) {
+			auto& bucket = iter->second;
+			if(bucket.entries.empty()) {
+				iter = _buckets.erase(iter);
+				continue;
+			}
+
+			if(bucket.dirty) {
+				_rebuild(bucket);
+			}
+
+			auto center = (bucket.min + bucket.max) * 0.5f;
+			auto radius = glm::length(bucket.max - bucket.min) * 0.5f;
+			if(frustum.intersects(center, radius)) {
+				auto material = iter->first.first;
+
+				auto cmd = create_command()
+				        .shader(_shader)
+				        .object(*bucket.object);
+
+				cmd.uniforms().emplace(alpha_cutoff_uniform, 0.9f);
+
+				material->set_textures(cmd);
+
+				cmd.uniforms().emplace(model_uniform, glm::mat4());
+
+				queue.push_back(cmd);
+			}
+
+			iter++;
+		}
+
+		_frame++;
+	}
+
+	auto Static_sprite_batch::_valid(Handle handle)const noexcept -> bool {
+		if(handle.index<0 || static_cast<std::size_t>(handle.index)>=_entries.size())
+			return false;
+
+		auto& entry = _entries[static_cast<std::size_t>(handle.index)];
+		return entry.used && entry.generation==handle.generation;
+	}
+
+	auto Static_sprite_batch::_insert(Handle handle, const Material* material,
+	                                  float z) -> std::tuple<Handle, Entry&> {
+		INVARIANT(!material->alpha(), "Alpha blended materials can't be part of a Static_sprite_batch");
+
+		auto key = Bucket_key{material, static_cast<int32_t>(std::floor(z / _bucket_depth))};
+
+		if(_valid(handle)) {
+			auto& entry = _entries[static_cast<std::size_t>(handle.index)];
+			entry.frame = _frame;
+
+			if(entry.bucket==key) {
+				_buckets[key].dirty = true;
+				return std::tuple<Handle, Entry&>{handle, entry};
+			}
+
+			_unlink(handle.index);
+
+		} else if(!_free_entries.empty()) {
+			handle.index = _free_entries.back();
+			_free_entries.pop_back();
+
+		} else {
+			handle.index = static_cast<int32_t>(_entries.size());
+			_entries.emplace_back();
+		}
+
+		auto& entry = _entries[static_cast<std::size_t>(handle.index)];
+		entry.used = true;
+		entry.frame = _frame;
+		entry.bucket = key;
+		handle.generation = entry.generation;
+
+		auto& bucket = _buckets[key];
+		bucket.entries.push_back(handle.index);
+		bucket.dirty = true;
+
+		return std::tuple<Handle, Entry&>{handle, entry};
+	}
+
+	void Static_sprite_batch::_unlink(int32_t entry) {
+		auto bucket = _buckets.find(_entries[static_cast<std::size_t>(entry)].bucket);
+		if(bucket==_buckets.end())
+			return;
+
+		auto& entries = bucket->second.entries;
+		auto iter = std::find(entries.begin(), entries.end(), entry);
+		if(iter!=entries.end()) {
+			*iter = entries.back();
+			entries.pop_back();
+		}
+
+		bucket->second.dirty = true;
+	}
+
+	void Static_sprite_batch::_rebuild(Bucket& bucket) {
+		_upload_buffer.clear();
+		for(auto e : bucket.entries) {
+			auto& vertices = _entries[static_cast<std::size_t>(e)].vertices;
+			_upload_buffer.insert(_upload_buffer.end(), vertices.begin(), vertices.end());
+		}
+
+		INVARIANT(!_upload_buffer.empty(), "Rebuild of an empty bucket");
+
+		bucket.min = _upload_buffer.front().position;
+		bucket.max = bucket.min;
+		for(auto& v : _upload_buffer) {
+			bucket.min = glm::min(bucket.min, v.position);
+			bucket.max = glm::max(bucket.max, v.position);
+		}
+
+		bucket.object = std::make_unique<Object>(sprite_layout, create_buffer(_upload_buffer));
+		bucket.dirty = false;
+		_rebuilt_buckets++;
+	}
+
 }
 }
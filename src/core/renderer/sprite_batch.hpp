@@ -15,6 +15,9 @@
 
 #include "../../core/units.hpp"
 
+#include <map>
+#include <memory>
+#include <tuple>
 #include <vector>
 
 
@@ -82,12 +85,55 @@ namespace renderer {
 		}
 	};
 
+	/// compact per-sprite record of the instanced renderer (see sprite_instanced.vert)
+	struct Sprite_instance {
+		glm::vec3 position;
+		float     rotation;
+		glm::vec2 size;
+		glm::vec2 decals_offset;
+		glm::vec4 uv_clip;
+		glm::vec2 hue_change;
+		float     shadow_resistence;
+		float     decals_intensity;
+	};
+
+	/// vertex of the unit quad that is shared by all instances
+	struct Sprite_quad_vertex {
+		glm::vec2 position;
+		glm::vec2 uv;
+	};
+
 	extern Vertex_layout sprite_layout;
+	extern Vertex_layout sprite_instance_layout;
+	/// the quad drawn for each Sprite_instance (same corners and order as the Sprite_batch vertices)
+	extern const std::vector<Sprite_quad_vertex> sprite_unit_quad;
 
 	extern void init_sprite_renderer(asset::Asset_manager& asset_manager);
 
+	/// rescales the sprite uv-rect to the clip_rect of its texture and insets it by half a texel
+	extern auto calc_sprite_uv_clip(glm::vec4 uv, glm::vec4 texture_clip,
+	                                glm::vec2 texture_size)noexcept -> glm::vec4;
+
+	/// packs a sprite into an instance record; doesn't require a GL context
+	extern auto pack_sprite_instance(const Sprite& sprite, glm::vec4 texture_clip,
+	                                 glm::vec2 texture_size)noexcept -> Sprite_instance;
+
+	/// writes the six vertices the Sprite_batch draws for the sprite; doesn't require a GL context
+	extern void generate_sprite_vertices(const Sprite& sprite, glm::vec4 texture_clip,
+	                                     glm::vec2 texture_size, Sprite_vertex* out);
+
 	class Sprite_batch {
 		public:
+			/**
+			 * insertion: vertices are kept sorted during insert (O(N) per insert)
+			 * radix:     vertices are appended unsorted and sorted once during flush
+			 * Both modes produce the same draw order (see Sprite_vertex::operator<). Vertex blocks
+			 *   are ordered as a whole by the z of their first vertex.
+			 */
+			enum class Sort_mode {
+				insertion, radix
+			};
+
 			Sprite_batch(std::size_t expected_size=64);
 			Sprite_batch(Shader_program& shader, std::size_t expected_size=64);
 
@@ -96,21 +142,155 @@ namespace renderer {
 			            const std::vector<Sprite_vertex>& vertices);
 			void flush(Command_queue&);
 
+			void sort_mode(Sort_mode mode);
+			auto sort_mode()const noexcept {return _sort_mode;}
+
 		private:
 			using Vertex_citer = std::vector<Sprite_vertex>::const_iterator;
 			using Vertex_iter = std::vector<Sprite_vertex>::iterator;
 
+			/// a continuous range of vertices (one sprite or one vertex-block) in radix mode
+			struct Sort_record {
+				const renderer::Material* material;
+				float       z;
+				uint32_t    begin;
+				uint32_t    count;
+			};
+
 			Shader_program& _shader;
+			Sort_mode       _sort_mode = Sort_mode::radix;
 
 			std::vector<Sprite_vertex>    _vertices;
 			std::vector<renderer::Object> _objects;
 			std::size_t                   _free_obj = 0;
 
+			// only used in radix mode
+			std::vector<Sort_record>              _records;
+			std::vector<const renderer::Material*> _record_materials;
+			std::vector<uint64_t>                 _sort_keys;
+			std::vector<uint64_t>                 _sort_keys_tmp;
+			std::vector<uint32_t>                 _sort_indices;
+			std::vector<uint32_t>                 _sort_indices_tmp;
+			std::vector<Sprite_vertex>            _sorted_vertices;
+
+			void _sort();
 			void _draw(Command_queue&);
 			auto _draw_part(Vertex_citer begin, Vertex_citer end) -> Command;
 			auto _reserve_space(float z, const renderer::Material* material, std::size_t count) -> Vertex_iter;
 			void _reserve_objects();
 	};
 
+	/**
+	 * Renders sprites as instances of a shared unit quad, uploading one Sprite_instance
+	 *   per sprite instead of six Sprite_vertex.
+	 * Uses the same draw order as Sprite_batch, but its commands are not ordered relative
+	 *   to other batches. So it should only be used for sprites with opaque materials.
+	 * Not supported on ANDROID (no instanced arrays).
+	 */
+	class Sprite_instance_batch {
+		public:
+			Sprite_instance_batch(std::size_t expected_size=64);
+			Sprite_instance_batch(Shader_program& shader, std::size_t expected_size=64);
+
+			void insert(const Sprite& sprite);
+			void flush(Command_queue&);
+
+			auto size()const noexcept {return _instances.size();}
+
+		private:
+			using Instance_citer = std::vector<Sprite_instance>::const_iterator;
+
+			Shader_program& _shader;
+
+			std::vector<Sprite_instance>           _instances;
+			std::vector<const renderer::Material*> _materials; //< material of each instance
+			std::vector<renderer::Object>          _objects;
+			std::size_t                            _free_obj = 0;
+
+			std::vector<const renderer::Material*> _unique_materials;
+			std::vector<const renderer::Material*> _sorted_materials;
+			std::vector<uint64_t>                  _sort_keys;
+			std::vector<uint64_t>                  _sort_keys_tmp;
+			std::vector<uint32_t>                  _sort_indices;
+			std::vector<uint32_t>                  _sort_indices_tmp;
+			std::vector<Sprite_instance>           _sorted_instances;
+
+			void _sort();
+			void _draw(Command_queue&);
+			auto _draw_part(Instance_citer begin, Instance_citer end,
+			                const renderer::Material& material) -> Command;
+			void _reserve_objects();
+	};
+
+	/**
+	 * Persistent vertex buffers for geometry, that rarely changes (e.g. terrain or sprites that
+	 *   haven't moved for a while), grouped by material and depth bucket.
+	 * Entries have to be kept alive by calling keep (or update) between two flushes, otherwise
+	 *   they are removed by the next flush. Only buckets with changed entries are re-uploaded.
+	 * Only opaque materials are supported, because alpha blended geometry has to be ordered
+	 *   relative to the other sprites (which is done by Sprite_batch).
+	 */
+	class Static_sprite_batch {
+		public:
+			struct Handle {
+				int32_t  index = -1;
+				uint32_t generation = 0;
+
+				explicit operator bool()const noexcept {return index>=0;}
+			};
+
+			Static_sprite_batch(float bucket_depth=1.f);
+			Static_sprite_batch(Shader_program& shader, float bucket_depth=1.f);
+
+			/// creates or replaces the geometry of the entry; returns its (new) handle
+			auto update(Handle, const Sprite& sprite) -> Handle;
+			auto update(Handle, glm::vec3 position, const std::vector<Sprite_vertex>& vertices) -> Handle;
+			/// keeps the entry alive until the next flush; false if the handle is no longer valid
+			auto keep(Handle)noexcept -> bool;
+			void erase(Handle);
+			void clear();
+
+			/// uploads changed buckets and draws all buckets that intersect the frustum
+			void flush(Command_queue&, const Frustum& frustum);
+
+			auto size()const noexcept {return _entries.size() - _free_entries.size();}
+			auto bucket_count()const noexcept {return _buckets.size();}
+			/// buckets that have been re-uploaded by the last flush
+			auto rebuilt_buckets()const noexcept {return _rebuilt_buckets;}
+
+		private:
+			using Bucket_key = std::pair<const Material*, int32_t>; //< material and depth bucket
+
+			struct Entry {
+				uint32_t   generation = 0;
+				bool       used = false;
+				uint64_t   frame = 0; //< last frame the entry was kept alive
+				Bucket_key bucket;
+				std::vector<Sprite_vertex> vertices;
+			};
+			struct Bucket {
+				std::vector<int32_t>    entries;
+				std::unique_ptr<Object> object;
+				glm::vec3               min {0,0,0};
+				glm::vec3               max {0,0,0};
+				bool                    dirty = true;
+			};
+
+			Shader_program& _shader;
+			const float     _bucket_depth;
+			uint64_t        _frame = 1;
+
+			std::vector<Entry>   _entries;
+			std::vector<int32_t> _free_entries;
+			std::map<Bucket_key, Bucket> _buckets;
+			std::vector<Sprite_vertex>   _upload_buffer;
+			std::size_t     _rebuilt_buckets = 0;
+
+			auto _valid(Handle)const noexcept -> bool;
+			auto _insert(Handle, const Material* material, float z) -> std::tuple<Handle, Entry&>;
+			void _unlink(int32_t entry);
+			void _rebuild(Bucket&);
+	};
+
 }
 }
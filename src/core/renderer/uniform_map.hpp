@@ -47,6 +47,15 @@ namespace renderer {
 		virtual auto emplace(const char* name, const glm::mat3& val) -> IUniform_map& = 0;
 		virtual auto emplace(const char* name, const glm::mat4& val) -> IUniform_map& = 0;
 
+		virtual auto emplace(Uniform_id id,       float      val) -> IUniform_map& = 0;
+		virtual auto emplace(Uniform_id id,       int        val) -> IUniform_map& = 0;
+		virtual auto emplace(Uniform_id id,       glm::vec2  val) -> IUniform_map& = 0;
+		virtual auto emplace(Uniform_id id,       glm::vec3  val) -> IUniform_map& = 0;
+		virtual auto emplace(Uniform_id id,       glm::vec4  val) -> IUniform_map& = 0;
+		virtual auto emplace(Uniform_id id, const glm::mat2& val) -> IUniform_map& = 0;
+		virtual auto emplace(Uniform_id id, const glm::mat3& val) -> IUniform_map& = 0;
+		virtual auto emplace(Uniform_id id, const glm::mat4& val) -> IUniform_map& = 0;
+
 		virtual void clear() = 0;
 
 		virtual void bind_all(Shader_program&)const = 0;
@@ -54,6 +63,7 @@ namespace renderer {
 
 	/// provies enough slots for up to 'max_size' uniforms and storage for
 	/// a combined size of 'max_size'*'average_size'
+	/// the names are interned on insertion, so bind_all doesn't have to look up any strings
 	template<std::size_t max_slots, std::size_t average_size=sizeof(float)*4>
 	class Uniform_map : public IUniform_map {
 		public:
@@ -67,13 +77,21 @@ namespace renderer {
 			auto emplace(const char* name, const glm::mat2& val) -> this_t& override final;
 			auto emplace(const char* name, const glm::mat3& val) -> this_t& override final;
 			auto emplace(const char* name, const glm::mat4& val) -> this_t& override final;
+			auto emplace(Uniform_id id,       float      val) -> this_t& override final;
+			auto emplace(Uniform_id id,       int        val) -> this_t& override final;
+			auto emplace(Uniform_id id,       glm::vec2  val) -> this_t& override final;
+			auto emplace(Uniform_id id,       glm::vec3  val) -> this_t& override final;
+			auto emplace(Uniform_id id,       glm::vec4  val) -> this_t& override final;
+			auto emplace(Uniform_id id, const glm::mat2& val) -> this_t& override final;
+			auto emplace(Uniform_id id, const glm::mat3& val) -> this_t& override final;
+			auto emplace(Uniform_id id, const glm::mat4& val) -> this_t& override final;
 			void clear() override final;
 
 			void bind_all(Shader_program&)const override final;
 
 		private:
 			struct Uniform {
-				const char* name;
+				Uniform_id id;
 				Uniform_type type;
 			};
 
@@ -83,13 +101,13 @@ namespace renderer {
 			unsigned int _next_data = 0;
 
 			template<Uniform_type type>
-			int _get_slot(const char* name)noexcept;
+			int _get_slot(Uniform_id id)noexcept;
 
 			template<Uniform_type type>
-			int _reserve(const char* name)noexcept;
+			int _reserve(Uniform_id id)noexcept;
 
 			template<Uniform_type type>
-			int _find_existing(const char* name)noexcept;
+			int _find_existing(Uniform_id id)noexcept;
 	};
 
 
@@ -134,50 +152,83 @@ namespace renderer {
 	// impl
 	template<std::size_t max_slots, std::size_t average_size>
 	auto Uniform_map<max_slots,average_size>::emplace(const char* name, float val) -> this_t& {
-		_data.at(_get_slot<Uniform_type::floating_point>(name)) = val;
+		return emplace(Uniform_id{name}, val);
+	}
+	template<std::size_t max_slots, std::size_t average_size>
+	auto Uniform_map<max_slots,average_size>::emplace(const char* name, int val) -> this_t& {
+		return emplace(Uniform_id{name}, val);
+	}
+	template<std::size_t max_slots, std::size_t average_size>
+	auto Uniform_map<max_slots,average_size>::emplace(const char* name, glm::vec2 val) -> this_t& {
+		return emplace(Uniform_id{name}, val);
+	}
+	template<std::size_t max_slots, std::size_t average_size>
+	auto Uniform_map<max_slots,average_size>::emplace(const char* name, glm::vec3 val) -> this_t& {
+		return emplace(Uniform_id{name}, val);
+	}
+	template<std::size_t max_slots, std::size_t average_size>
+	auto Uniform_map<max_slots,average_size>::emplace(const char* name, glm::vec4 val) -> this_t& {
+		return emplace(Uniform_id{name}, val);
+	}
+	template<std::size_t max_slots, std::size_t average_size>
+	auto Uniform_map<max_slots,average_size>::emplace(const char* name, const glm::mat2& val) -> this_t& {
+		return emplace(Uniform_id{name}, val);
+	}
+	template<std::size_t max_slots, std::size_t average_size>
+	auto Uniform_map<max_slots,average_size>::emplace(const char* name, const glm::mat3& val) -> this_t& {
+		return emplace(Uniform_id{name}, val);
+	}
+	template<std::size_t max_slots, std::size_t average_size>
+	auto Uniform_map<max_slots,average_size>::emplace(const char* name, const glm::mat4& val) -> this_t& {
+		return emplace(Uniform_id{name}, val);
+	}
+
+	template<std::size_t max_slots, std::size_t average_size>
+	auto Uniform_map<max_slots,average_size>::emplace(Uniform_id id, float val) -> this_t& {
+		_data.at(_get_slot<Uniform_type::floating_point>(id)) = val;
 		return *this;
 	}
 
 	template<std::size_t max_slots, std::size_t average_size>
-	auto Uniform_map<max_slots,average_size>::emplace(const char* name, int val) -> this_t& {
-		_data.at(_get_slot<Uniform_type::integer>(name)) = static_cast<float>(val);
+	auto Uniform_map<max_slots,average_size>::emplace(Uniform_id id, int val) -> this_t& {
+		_data.at(_get_slot<Uniform_type::integer>(id)) = static_cast<float>(val);
 		return *this;
 	}
 
 	template<std::size_t max_slots, std::size_t average_size>
-	auto Uniform_map<max_slots,average_size>::emplace(const char* name, glm::vec2 val) -> this_t& {
-		auto index = _get_slot<Uniform_type::fvec2>(name);
+	auto Uniform_map<max_slots,average_size>::emplace(Uniform_id id, glm::vec2 val) -> this_t& {
+		auto index = _get_slot<Uniform_type::fvec2>(id);
 		std::memcpy(&_data.at(index), glm::value_ptr(val), 2*sizeof(float));
 		return *this;
 	}
 
 	template<std::size_t max_slots, std::size_t average_size>
-	auto Uniform_map<max_slots,average_size>::emplace(const char* name, glm::vec3 val) -> this_t& {
-		auto index = _get_slot<Uniform_type::fvec3>(name);
+	auto Uniform_map<max_slots,average_size>::emplace(Uniform_id id, glm::vec3 val) -> this_t& {
+		auto index = _get_slot<Uniform_type::fvec3>(id);
 		std::memcpy(&_data.at(index), glm::value_ptr(val), 3*sizeof(float));
 		return *this;
 	}
 	template<std::size_t max_slots, std::size_t average_size>
-	auto Uniform_map<max_slots,average_size>::emplace(const char* name, glm::vec4 val) -> this_t& {
-		auto index = _get_slot<Uniform_type::fvec4>(name);
+	auto Uniform_map<max_slots,average_size>::emplace(Uniform_id id, glm::vec4 val) -> this_t& {
+		auto index = _get_slot<Uniform_type::fvec4>(id);
 		std::memcpy(&_data.at(index), glm::value_ptr(val), 4*sizeof(float));
 		return *this;
 	}
 	template<std::size_t max_slots, std::size_t average_size>
-	auto Uniform_map<max_slots,average_size>::emplace(const char* name, const glm::mat2& val) -> this_t& {
-		auto index = _get_slot<Uniform_type::fmat2>(name);
+	auto Uniform_map<max_slots,average_size>::emplace(Uniform_id id, const glm::mat2& val) -> this_t& {
+		auto index = _get_slot<Uniform_type::fmat2>(id);
 		std::memcpy(&_data.at(index), glm::value_ptr(val), 2*2*sizeof(float));
 		return *this;
 	}
 	template<std::size_t max_slots, std::size_t average_size>
-	auto Uniform_map<max_slots,average_size>::emplace(const char* name, const glm::mat3& val) -> this_t& {
-		auto index = _get_slot<Uniform_type::fmat3>(name);
+	auto Uniform_map<max_slots,average_size>::emplace(Uniform_id id, const glm::mat3& val) -> this_t& {
+		auto index = _get_slot<Uniform_type::fmat3>(id);
 		std::memcpy(&_data.at(index), glm::value_ptr(val), 3*3*sizeof(float));
 		return *this;
 	}
 	template<std::size_t max_slots, std::size_t average_size>
-	auto Uniform_map<max_slots,average_size>::emplace(const char* name, const glm::mat4& val) -> this_t& {
-		auto index = _get_slot<Uniform_type::fmat4>(name);
+	auto Uniform_map<max_slots,average_size>::emplace(Uniform_id id, const glm::mat4& val) -> this_t& {
+		auto index = _get_slot<Uniform_type::fmat4>(id);
 		std::memcpy(&_data.at(index), glm::value_ptr(val), 4*4*sizeof(float));
 		return *this;
 	}
@@ -185,24 +236,24 @@ namespace renderer {
 
 	template<std::size_t max_slots, std::size_t average_size>
 	template<Uniform_type type>
-	int Uniform_map<max_slots,average_size>::_get_slot(const char* name)noexcept {
-		int slot = _find_existing<type>(name);
+	int Uniform_map<max_slots,average_size>::_get_slot(Uniform_id id)noexcept {
+		int slot = _find_existing<type>(id);
 		if(slot>=0)
 			return slot;
 
-		else return _reserve<type>(name);
+		else return _reserve<type>(id);
 	}
 
 	template<std::size_t max_slots, std::size_t average_size>
 	template<Uniform_type type>
-	int Uniform_map<max_slots,average_size>::_reserve(const char* name)noexcept {
+	int Uniform_map<max_slots,average_size>::_reserve(Uniform_id id)noexcept {
 		constexpr auto size = uniform_size(type) / sizeof(float);
 
 		INVARIANT(_next_data+size<=_data.size(), "Not enough space in uniform map");
 		INVARIANT(_next_metadata<_metadata.size(), "Not enough slots in uniform map");
 
 		auto& metadata = _metadata.at(_next_metadata++);
-		metadata.name = name;
+		metadata.id = id;
 		metadata.type = type;
 
 		auto start_idx = _next_data;
@@ -212,30 +263,19 @@ namespace renderer {
 
 	template<std::size_t max_slots, std::size_t average_size>
 	template<Uniform_type type>
-	int Uniform_map<max_slots,average_size>::_find_existing(const char* name)noexcept {
-		auto search = [&](auto&& comp) {
-			auto data_idx = 0;
+	int Uniform_map<max_slots,average_size>::_find_existing(Uniform_id id)noexcept {
+		auto data_idx = 0;
 
-			for(auto i=0u; i<_next_metadata; ++i) {
-				if(comp(name, _metadata[i].name)) {
-					INVARIANT(_metadata[i].type==type, "Found uniform with same name but different type: "<<((int)_metadata[i].type)<<" vs "<<((int)type));
-					return data_idx;
-				}
-
-				data_idx+=uniform_size(_metadata[i].type) / sizeof(float);
+		for(auto i=0u; i<_next_metadata; ++i) {
+			if(_metadata[i].id==id) {
+				INVARIANT(_metadata[i].type==type, "Found uniform with same name but different type: "<<((int)_metadata[i].type)<<" vs "<<((int)type));
+				return data_idx;
 			}
 
-			return -1;
-		};
-
-		// search by address
-		auto data_idx = search([](auto a, auto b){return a==b;});
-
-		// search by value
-		if(data_idx<0)
-			data_idx = search([](auto a, auto b){return std::strcmp(a,b)==0;});
+			data_idx+=uniform_size(_metadata[i].type) / sizeof(float);
+		}
 
-		return data_idx;
+		return -1;
 	}
 
 	template<std::size_t max_slots, std::size_t average_size>
@@ -254,42 +294,42 @@ namespace renderer {
 
 			switch(metadata.type) {
 				case Uniform_type::integer:
-					prog.set_uniform(metadata.name, static_cast<int>(_data.at(data_idx)));
+					prog.set_uniform(metadata.id, static_cast<int>(_data.at(data_idx)));
 					data_idx += 1;
 					break;
 
 				case Uniform_type::floating_point:
-					prog.set_uniform(metadata.name, static_cast<float>(_data.at(data_idx)));
+					prog.set_uniform(metadata.id, static_cast<float>(_data.at(data_idx)));
 					data_idx += 1;
 					break;
 
 				case Uniform_type::fvec2:
-					prog.set_uniform(metadata.name, glm::make_vec2(&_data.at(data_idx)));
+					prog.set_uniform(metadata.id, glm::make_vec2(&_data.at(data_idx)));
 					data_idx += 2;
 					break;
 
 				case Uniform_type::fvec3:
-					prog.set_uniform(metadata.name, glm::make_vec3(&_data.at(data_idx)));
+					prog.set_uniform(metadata.id, glm::make_vec3(&_data.at(data_idx)));
 					data_idx += 3;
 					break;
 
 				case Uniform_type::fvec4:
-					prog.set_uniform(metadata.name, glm::make_vec4(&_data.at(data_idx)));
+					prog.set_uniform(metadata.id, glm::make_vec4(&_data.at(data_idx)));
 					data_idx += 4;
 					break;
 
 				case Uniform_type::fmat2:
-					prog.set_uniform(metadata.name, glm::make_mat2(&_data.at(data_idx)));
+					prog.set_uniform(metadata.id, glm::make_mat2(&_data.at(data_idx)));
 					data_idx += 2*2;
 					break;
 
 				case Uniform_type::fmat3:
-					prog.set_uniform(metadata.name, glm::make_mat3(&_data.at(data_idx)));
+					prog.set_uniform(metadata.id, glm::make_mat3(&_data.at(data_idx)));
 					data_idx += 3*3;
 					break;
 
 				case Uniform_type::fmat4:
-					prog.set_uniform(metadata.name, glm::make_mat4(&_data.at(data_idx)));
+					prog.set_uniform(metadata.id, glm::make_mat4(&_data.at(data_idx)));
 					data_idx += 4*4;
 					break;
 
@@ -179,7 +179,8 @@ namespace renderer {
 	}
 
 	Object::Object(Object&& o)noexcept
-	    : _layout(o._layout), _mode(o._mode), _data(std::move(o._data)), _vao_id(o._vao_id) {
+	    : _layout(o._layout), _mode(o._mode), _data(std::move(o._data)),
+	      _vao_id(o._vao_id), _instanced(o._instanced) {
 		o._vao_id = 0;
 	}
 
@@ -0,0 +1,202 @@
+#include "chunk_allocator.hpp"
+
+#include "log.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#if defined(__linux__) && !defined(EMSCRIPTEN)
+	#include <sys/mman.h>
+	#define LUX_HUGE_PAGES
+#endif
+
+
+namespace lux {
+namespace util {
+
+	namespace {
+		struct Size_class {
+			std::size_t size;
+			std::size_t alignment;
+			std::size_t stride;          //< distance between chunks carved from a slab
+			std::size_t system_bytes = 0;
+			std::vector<void*> free;
+		};
+
+		struct Chunk_cache {
+			std::mutex mutex;
+			std::vector<Size_class> classes;
+			std::vector<unsigned char*> slabs; //< never released, because they are shared by many pools
+			bool huge_pages = false;
+			Chunk_allocator_stats stats;
+
+			auto get_class(std::size_t size, std::size_t alignment) -> Size_class& {
+				auto iter = std::find_if(classes.begin(), classes.end(), [&](auto& c) {
+					return c.size==size && c.alignment==alignment;
+				});
+				if(iter!=classes.end())
+					return *iter;
+
+				auto stride = (size + alignment - 1) / alignment * alignment;
+				classes.push_back(Size_class{size, alignment, stride, 0, {}});
+				return classes.back();
+			}
+
+			auto in_slab(void* chunk)const -> bool {
+				auto addr = static_cast<unsigned char*>(chunk);
+				return std::any_of(slabs.begin(), slabs.end(), [&](auto slab) {
+					return addr>=slab && addr<slab+huge_page_size;
+				});
+			}
+
+			// the offset to the original allocation is stored in the bytes in front of the chunk
+			static auto alloc_aligned(std::size_t size, std::size_t alignment) -> void* {
+				alignment = std::max(alignment, sizeof(std::size_t));
+				auto raw = static_cast<unsigned char*>(::operator new(size + alignment));
+				auto addr = reinterpret_cast<std::uintptr_t>(raw) + alignment;
+				auto aligned = reinterpret_cast<unsigned char*>(addr - addr % alignment);
+
+				auto offset = static_cast<std::size_t>(aligned - raw);
+				std::memcpy(aligned - sizeof(std::size_t), &offset, sizeof(std::size_t));
+				return aligned;
+			}
+			static void free_aligned(void* chunk)noexcept {
+				auto aligned = static_cast<unsigned char*>(chunk);
+				auto offset = std::size_t(0);
+				std::memcpy(&offset, aligned - sizeof(std::size_t), sizeof(std::size_t));
+				::operator delete(aligned - offset);
+			}
+
+			// carves a new huge page slab into chunks of the given class
+			auto alloc_slab(Size_class& c) -> bool {
+#ifdef LUX_HUGE_PAGES
+				auto memory = mmap(nullptr, huge_page_size, PROT_READ | PROT_WRITE,
+				                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+				if(memory==MAP_FAILED) {
+					// no reserved huge pages => ask for transparent huge pages
+					memory = alloc_aligned(huge_page_size, huge_page_size);
+					madvise(memory, huge_page_size, MADV_HUGEPAGE);
+				}
+
+				auto begin = static_cast<unsigned char*>(memory);
+				slabs.push_back(begin);
+
+				auto count = huge_page_size / c.stride;
+				c.free.reserve(c.free.size() + count);
+				for(auto i=count; i>0; i--) {
+					c.free.push_back(begin + (i-1)*c.stride);
+				}
+
+				c.system_bytes += huge_page_size;
+				stats.system_allocations++;
+				stats.cached_bytes += count * c.size;
+				stats.huge_page_bytes += huge_page_size;
+				return true;
+#else
+				return false;
+#endif
+			}
+
+			// only large pools are backed by huge pages, because each slab commits 2 MiB
+			auto use_huge_pages(const Size_class& c)const -> bool {
+				return huge_pages && c.alignment<=huge_page_size && c.stride*4<=huge_page_size
+				       && c.system_bytes>=huge_page_size;
+			}
+		};
+
+		// intentionally leaked, so pools with static storage duration can still return their chunks
+		auto chunk_cache() -> Chunk_cache& {
+			static auto cache = new Chunk_cache();
+			return *cache;
+		}
+	}
+
+	auto allocate_chunk(std::size_t size, std::size_t alignment) -> void* {
+		auto& cache = chunk_cache();
+		std::lock_guard<std::mutex> lock(cache.mutex);
+
+		auto& c = cache.get_class(size, alignment);
+		cache.stats.allocations++;
+
+		if(c.free.empty() && cache.use_huge_pages(c)) {
+			cache.alloc_slab(c);
+		}
+
+		if(!c.free.empty()) {
+			auto chunk = c.free.back();
+			c.free.pop_back();
+			cache.stats.reused++;
+			cache.stats.cached_bytes -= size;
+			cache.stats.used_bytes += size;
+			return chunk;
+		}
+
+		auto chunk = Chunk_cache::alloc_aligned(size, alignment);
+		c.system_bytes += size;
+		cache.stats.system_allocations++;
+		cache.stats.used_bytes += size;
+		return chunk;
+	}
+
+	void deallocate_chunk(void* chunk, std::size_t size, std::size_t alignment)noexcept {
+		if(!chunk)
+			return;
+
+		auto& cache = chunk_cache();
+		std::lock_guard<std::mutex> lock(cache.mutex);
+
+		auto& c = cache.get_class(size, alignment);
+		c.free.push_back(chunk);
+
+		cache.stats.deallocations++;
+		cache.stats.used_bytes -= size;
+		cache.stats.cached_bytes += size;
+	}
+
+	void trim_chunk_cache() {
+		auto& cache = chunk_cache();
+		std::lock_guard<std::mutex> lock(cache.mutex);
+
+		auto released = std::size_t(0);
+		for(auto& c : cache.classes) {
+			auto slab_chunks = std::partition(c.free.begin(), c.free.end(), [&](auto chunk) {
+				return cache.in_slab(chunk);
+			});
+			for(auto iter=slab_chunks; iter!=c.free.end(); iter++) {
+				Chunk_cache::free_aligned(*iter);
+			}
+
+			auto count = static_cast<std::size_t>(std::distance(slab_chunks, c.free.end()));
+			c.free.erase(slab_chunks, c.free.end());
+			c.system_bytes -= count * c.size;
+			released += count * c.size;
+		}
+
+		cache.stats.cached_bytes -= released;
+		DEBUG("Released "<<released<<" bytes of cached pool chunks");
+	}
+
+	void chunk_allocator_huge_pages(bool enable) {
+		auto& cache = chunk_cache();
+		std::lock_guard<std::mutex> lock(cache.mutex);
+
+#ifndef LUX_HUGE_PAGES
+		if(enable) {
+			WARN("Huge pages are not supported on this platform");
+		}
+		enable = false;
+#endif
+		cache.huge_pages = enable;
+	}
+
+	auto chunk_allocator_stats() -> Chunk_allocator_stats {
+		auto& cache = chunk_cache();
+		std::lock_guard<std::mutex> lock(cache.mutex);
+		return cache.stats;
+	}
+
+}
+}
@@ -0,0 +1,70 @@
+/** aligned allocation of recycled memory chunks for util::pool **************
+ *                                                                           *
+ * Copyright (c) 2016 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace lux {
+namespace util {
+
+	constexpr std::size_t cache_line_size = 64;
+	constexpr std::size_t huge_page_size  = 2 * 1024 * 1024;
+
+	struct Chunk_allocator_stats {
+		std::size_t allocations = 0;        //< chunks handed out to pools
+		std::size_t deallocations = 0;      //< chunks returned by pools
+		std::size_t reused = 0;             //< allocations served from the free-lists (or huge page slabs)
+		std::size_t system_allocations = 0; //< allocations that had to request memory from the system
+		std::size_t used_bytes = 0;         //< bytes of chunks currently owned by pools
+		std::size_t cached_bytes = 0;       //< bytes of chunks waiting in the free-lists
+		std::size_t huge_page_bytes = 0;    //< bytes of huge page slabs (used and cached)
+	};
+
+	/*
+	 * Process wide allocator for the chunks of util::pool.
+	 * Freed chunks are kept in a free-list per (size, alignment) and are reused by the next
+	 *   allocation of the same kind, so clearing and refilling pools (level reloads,
+	 *   editor play/stop) doesn't hit the system allocator.
+	 * If huge pages are enabled, size classes that have grown beyond a huge page are served
+	 *   from huge page slabs, that are only released on exit.
+	 * All functions are thread-safe.
+	 */
+	extern auto allocate_chunk(std::size_t size, std::size_t alignment) -> void*;
+	extern void deallocate_chunk(void* chunk, std::size_t size, std::size_t alignment)noexcept;
+
+	/// releases all cached chunks (except those in huge page slabs) to the system
+	extern void trim_chunk_cache();
+	extern void chunk_allocator_huge_pages(bool enable);
+	extern auto chunk_allocator_stats() -> Chunk_allocator_stats;
+
+
+	/**
+	 * Default chunk allocator of util::pool.
+	 * Custom allocators have to provide the same static interface:
+	 *   alignment (alignment of the returned chunks)
+	 *   allocate(size:std::size_t)->void*  (throws std::bad_alloc on failure)
+	 *   deallocate(chunk:void*, size:std::size_t)noexcept->void
+	 */
+	template<std::size_t Alignment=cache_line_size>
+	struct recycling_chunk_allocator {
+		static_assert((Alignment & (Alignment-1))==0, "Alignment has to be a power of two");
+
+		static constexpr std::size_t alignment = Alignment;
+
+		static void* allocate(std::size_t size) {
+			return allocate_chunk(size, Alignment);
+		}
+		static void deallocate(void* chunk, std::size_t size)noexcept {
+			deallocate_chunk(chunk, size, Alignment);
+		}
+	};
+
+}
+}
@@ -13,6 +13,9 @@
 #include <cstddef>
 #include <cstdint>
 #include <cmath>
+#include <algorithm>
+#include <memory>
+#include "chunk_allocator.hpp"
 #include "log.hpp"
 #include "string_utils.hpp"
 #include "template_utils.hpp"
@@ -33,18 +36,24 @@ namespace util {
 		// static constexpr const Marker_type* marker_addr(const T* inst)
 	};
 
+	/**
+	 * The chunks are allocated by ChunkAllocator (see recycling_chunk_allocator), which
+	 *   determines their alignment and whether freed chunks are reused.
+	 */
 	template<class T, std::size_t ElementsPerChunk, class IndexType=int_fast64_t,
-	         class ValueTraits=pool_value_traits, bool use_empty_values=ValueTraits::supports_empty_values>
+	         class ValueTraits=pool_value_traits, class ChunkAllocator=recycling_chunk_allocator<>,
+	         bool use_empty_values=ValueTraits::supports_empty_values>
 	class pool {
-		static_assert(alignof(T)<=alignof(std::max_align_t), "Alignment not supported");
+		static_assert(alignof(T)<=ChunkAllocator::alignment, "Alignment not supported");
 		public:
 			static constexpr auto element_size = static_cast<IndexType>(sizeof(T));
 			static constexpr auto chunk_len    = static_cast<IndexType>(ElementsPerChunk);
 			static constexpr auto chunk_size   = chunk_len * element_size;
 
 			using value_type = T;
-			using iterator = pool_iterator<pool<T, ElementsPerChunk, IndexType, ValueTraits, use_empty_values>>;
+			using iterator = pool_iterator<pool<T, ElementsPerChunk, IndexType, ValueTraits, ChunkAllocator, use_empty_values>>;
 			using index_t = IndexType;
+			static constexpr bool has_free_slots = false;
 
 			friend iterator;
 
@@ -88,7 +97,7 @@ namespace util {
 			 * O(1)
 			 */
 			void erase(IndexType i) {
-				erase(i, [](auto,auto){});
+				erase(i, [](auto, auto&, auto){});
 			}
 			template<typename F>
 			void erase(IndexType i, F&& relocation) {
@@ -109,7 +118,7 @@ namespace util {
 			 * O(1)
 			 */
 			void shrink_to_fit() {
-				shrink_to_fit([](auto,auto){});
+				shrink_to_fit([](auto, auto&, auto){});
 			}
 			template<typename F>
 			void shrink_to_fit(F&&) {
@@ -117,6 +126,48 @@ namespace util {
 				_chunks.resize(static_cast<std::size_t>(min_chunks));
 			}
 
+			/**
+			 * Allocates the chunks required to store the given number of elements, so a block of
+			 *   elements can be inserted without interleaved allocations.
+			 * O(1) per allocated chunk
+			 */
+			void reserve(IndexType count) {
+				auto chunks = static_cast<std::size_t>((count + chunk_len - 1) / chunk_len);
+				while(_chunks.size() < chunks) {
+					_chunks.push_back(_new_chunk());
+				}
+			}
+
+			/**
+			 * No-op, because pools without empty values never contain holes.
+			 */
+			void compact() {
+			}
+			template<typename F>
+			void compact(F&&) {
+			}
+			/**
+			 * Incremental version of shrink_to_fit, that relocates at most max_moves elements
+			 *   per call (all if max_moves<=0).
+			 * @return true if the pool contains no holes anymore
+			 */
+			template<typename F>
+			bool compact_step(IndexType, F&& relocation) {
+				shrink_to_fit(relocation);
+				return true;
+			}
+
+			/**
+			 * Swaps the values of two (valid) elements.
+			 * O(1)
+			 */
+			void swap(IndexType a, IndexType b) {
+				if(a!=b) {
+					using std::swap;
+					swap(get(a), get(b));
+				}
+			}
+
 			/**
 			 * Creates a new instance of T inside the pool.
 			 * O(1)
@@ -132,7 +183,7 @@ namespace util {
 						return _chunks[chunk].get() + ((i % chunk_len) * element_size);
 
 					} else {
-						auto new_chunk = std::make_unique<unsigned char[]>(chunk_size);
+						auto new_chunk = _new_chunk();
 						auto addr = new_chunk.get();
 						_chunks.push_back(std::move(new_chunk));
 						return addr;
@@ -157,6 +208,26 @@ namespace util {
 				return _used_elements==0;
 			}
 
+			/**
+			 * @return The number of chunks, that are currently allocated (including unused ones)
+			 */
+			IndexType allocated_chunks()const noexcept {
+				return static_cast<IndexType>(_chunks.size());
+			}
+			/**
+			 * @return The number of bytes allocated for elements and bookkeeping
+			 */
+			std::size_t memory_usage()const noexcept {
+				return _chunks.size() * static_cast<std::size_t>(chunk_size)
+				       + _chunks.capacity() * sizeof(chunk_type);
+			}
+			/**
+			 * @return The number of free slots, that will be reused by the next insertions
+			 */
+			IndexType free_count()const noexcept {
+				return 0;
+			}
+
 			/**
 			 * @return The specified element
 			 */
@@ -167,6 +238,43 @@ namespace util {
 				return *reinterpret_cast<const T*>(get_raw(i));
 			}
 
+			/**
+			 * The elements are stored in chunks of chunk_len elements, that can be processed
+			 *   independently of each other (e.g. by different threads).
+			 * @return The number of chunks, that contain elements
+			 */
+			IndexType chunk_count()const noexcept {
+				return (_used_elements + chunk_len - 1) / chunk_len;
+			}
+
+			/**
+			 * Calls f(T&) for all elements in the chunks [first_chunk, last_chunk).
+			 * O(N)
+			 */
+			template<typename F>
+			void for_each_in_chunks(IndexType first_chunk, IndexType last_chunk, F&& f) {
+				_for_each_in_chunks(first_chunk, last_chunk, [](const T*){return true;}, f);
+			}
+
+			/**
+			 * Calls f(T* begin, T* end) for each contiguous range of elements, so loops over the
+			 *   elements don't have to check for chunk boundaries (or free slots).
+			 * O(N/chunk_len)
+			 */
+			template<typename F>
+			void for_each_span(F&& f) {
+				for_each_span_in_chunks(0, chunk_count(), f);
+			}
+			template<typename F>
+			void for_each_span_in_chunks(IndexType first_chunk, IndexType last_chunk, F&& f) {
+				last_chunk = std::min(last_chunk, chunk_count());
+
+				for(auto chunk_idx=first_chunk; chunk_idx<last_chunk; chunk_idx++) {
+					auto begin = _chunk(chunk_idx);
+					f(begin, _chunk_end(begin, chunk_idx));
+				}
+			}
+
 			/**
 			 * @return The last element
 			 */
@@ -175,15 +283,25 @@ namespace util {
 			}
 			const T& back()const {
 				INVARIANT(_used_elements>0, "back on empty pool");
-				auto i = _used_elements-1;
-				return reinterpret_cast<const T&>(_chunks.back()[(i % chunk_len) * element_size]);
+				// _chunks.back() isn't necessarily the last used chunk (pop_back doesn't free chunks)
+				return reinterpret_cast<const T&>(*get_raw(_used_elements-1));
 			}
 
 		protected:
-			using chunk_type = std::unique_ptr<unsigned char[]>;
+			struct chunk_deleter {
+				void operator()(unsigned char* chunk)const noexcept {
+					ChunkAllocator::deallocate(chunk, static_cast<std::size_t>(chunk_size));
+				}
+			};
+			using chunk_type = std::unique_ptr<unsigned char[], chunk_deleter>;
 			std::vector<chunk_type> _chunks;
 			IndexType _used_elements = 0;
 
+			static chunk_type _new_chunk() {
+				return chunk_type(static_cast<unsigned char*>(
+				        ChunkAllocator::allocate(static_cast<std::size_t>(chunk_size))));
+			}
+
 			// get_raw is required to avoid UB if their is no valid object at the index
 			unsigned char* get_raw(IndexType i) {
 				return const_cast<unsigned char*>(static_cast<const pool*>(this)->get_raw(i));
@@ -210,15 +328,32 @@ namespace util {
 			static bool _valid(const T*)noexcept {
 				return true;
 			}
+
+			template<typename P, typename F>
+			void _for_each_in_chunks(IndexType first_chunk, IndexType last_chunk, P&& valid, F& f) {
+				last_chunk = std::min(last_chunk, chunk_count());
+
+				for(auto chunk_idx=first_chunk; chunk_idx<last_chunk; chunk_idx++) {
+					auto begin = _chunk(chunk_idx);
+					auto end = _chunk_end(begin, chunk_idx);
+
+					for(auto iter=begin; iter!=end; iter++) {
+						if(valid(iter)) {
+							f(*iter);
+						}
+					}
+				}
+			}
 	};
 	
-	template<class T, std::size_t ElementsPerChunk, class IndexType, class ValueTraits>
-	class pool<T, ElementsPerChunk, IndexType, ValueTraits, true>
-	        : public pool<T, ElementsPerChunk, IndexType, ValueTraits, false> {
+	template<class T, std::size_t ElementsPerChunk, class IndexType, class ValueTraits, class ChunkAllocator>
+	class pool<T, ElementsPerChunk, IndexType, ValueTraits, ChunkAllocator, true>
+	        : public pool<T, ElementsPerChunk, IndexType, ValueTraits, ChunkAllocator, false> {
 
-		using base_t = pool<T, ElementsPerChunk, IndexType, ValueTraits, false>;
+		using base_t = pool<T, ElementsPerChunk, IndexType, ValueTraits, ChunkAllocator, false>;
 		public:
-			using iterator = pool_iterator<pool<T, ElementsPerChunk, IndexType, ValueTraits, true>>;
+			using iterator = pool_iterator<pool<T, ElementsPerChunk, IndexType, ValueTraits, ChunkAllocator, true>>;
+			static constexpr bool has_free_slots = true;
 
 			friend iterator;
 
@@ -228,6 +363,35 @@ namespace util {
 			IndexType size()const noexcept {
 				return this->_used_elements - _freelist.size();
 			}
+
+			std::size_t memory_usage()const noexcept {
+				return base_t::memory_usage() + _freelist.capacity() * sizeof(IndexType);
+			}
+			IndexType free_count()const noexcept {
+				return static_cast<IndexType>(_freelist.size());
+			}
+
+			/**
+			 * Calls f(T&) for all elements in the chunks [first_chunk, last_chunk).
+			 * The free slots are skipped based on the bitmask of the occupied slots, so they are
+			 *   never loaded.
+			 * O(N/64 + number of elements)
+			 */
+			template<typename F>
+			void for_each_in_chunks(IndexType first_chunk, IndexType last_chunk, F&& f);
+
+			/**
+			 * Calls f(T* begin, T* end) for each contiguous range of valid elements.
+			 * The free slots are skipped based on a bitmask of the occupied slots, so dense ranges
+			 *   are found without touching the elements.
+			 * O(N/64 + number of ranges)
+			 */
+			template<typename F>
+			void for_each_span(F&& f) {
+				for_each_span_in_chunks(0, this->chunk_count(), f);
+			}
+			template<typename F>
+			void for_each_span_in_chunks(IndexType first_chunk, IndexType last_chunk, F&& f);
 			bool empty()const noexcept {
 				return size()==0;
 			}
@@ -241,10 +405,12 @@ namespace util {
 				this->_used_elements = 0;
 
 				_freelist.clear();
+				_freelist_is_heap = false;
+				_occupied.clear();
 			}
 
 			auto erase(IndexType i) {
-				erase(i, [](auto,auto){});
+				erase(i, [](auto, auto&, auto){});
 			}
 			template<typename F>
 			auto erase(IndexType i, F&&) {
@@ -253,13 +419,17 @@ namespace util {
 				INVARIANT(_valid(instance_addr), "double free");
 
 				if(i>=(this->_used_elements-1)) {
-					this->pop_back();
+					pop_back();
 
 				} else {
 					instance.~T();
 					set_free(instance_addr);
+					_unmark_occupied(i);
 
 					_freelist.emplace_back(i);
+					if(_freelist_is_heap) {
+						std::push_heap(_freelist.begin(), _freelist.end());
+					}
 				}
 			}
 			
@@ -272,31 +442,137 @@ namespace util {
 					auto instance_addr = reinterpret_cast<T*>(this->get_raw(i));
 					INVARIANT(!_valid(instance_addr), "Freed object is not marked as free");
 					auto instance = (new(instance_addr) T(std::forward<Args>(args)...));
+					_mark_occupied(i);
 					return {*instance, i};
 				}
 
-				return base_t::emplace_back(std::forward<Args>(args)...);
+				auto r = base_t::emplace_back(std::forward<Args>(args)...);
+				_mark_occupied(std::get<1>(r));
+				return r;
+			}
+
+			void pop_back() {
+				base_t::pop_back();
+				_unmark_occupied(this->_used_elements);
 			}
 
 			void shrink_to_fit() {
-				shrink_to_fit([](auto,auto){});
+				shrink_to_fit([](auto, auto&, auto){});
 			}
 			template<typename F>
 			void shrink_to_fit(F&& relocation) {
 				if(_freelist.size() > ValueTraits::max_free) {
-					std::sort(_freelist.begin(), _freelist.end(), std::greater<>{});
-					for(auto i : _freelist) {
-						base_t::erase(i, relocation);
+					_fill_holes(relocation);
+				}
+
+				base_t::shrink_to_fit(relocation);
+			}
+
+			/**
+			 * Moves elements from the back into all free slots, so [0, size()) contains no holes.
+			 * relocation = func(original:IndexType, T& value, new:IndexType)->void
+			 * Invalidates all iterators and references.
+			 * O(F log F) with F = number of free slots
+			 */
+			void compact() {
+				compact([](auto, auto&, auto){});
+			}
+			template<typename F>
+			void compact(F&& relocation) {
+				if(!_freelist.empty()) {
+					_fill_holes(relocation);
+				}
+			}
+
+			/**
+			 * Moves elements from the back into the max_moves highest free slots (all if max_moves<=0)
+			 *   and frees the chunks that are no longer used.
+			 * The free list is kept as a max-heap until the pool is compact, so only the first call
+			 *   is O(F) and the following ones are O(M log F).
+			 * relocation = func(original:IndexType, T& value, new:IndexType)->void
+			 * Invalidates all iterators and references.
+			 * @return true if the pool contains no holes anymore
+			 */
+			template<typename F>
+			bool compact_step(IndexType max_moves, F&& relocation) {
+				if(max_moves<=0 || static_cast<std::size_t>(max_moves)>=_freelist.size()) {
+					compact(relocation);
+
+				} else {
+					if(!_freelist_is_heap) {
+						std::make_heap(_freelist.begin(), _freelist.end());
+						_freelist_is_heap = true;
+					}
+
+					// the highest holes have to be filled first, because the elements moved into
+					//   them are taken from the back, that may contain holes itself
+					for(auto i=IndexType(0); i<max_moves; i++) {
+						std::pop_heap(_freelist.begin(), _freelist.end());
+						auto hole = _freelist.back();
+						_freelist.pop_back();
+						_move_into_hole(hole, relocation);
 					}
-					_freelist.clear();
 				}
 
 				base_t::shrink_to_fit(relocation);
+				return _freelist.empty();
 			}
 			
 			
 		protected:
+			static constexpr IndexType word_bits = 64;
+
 			std::vector<IndexType> _freelist;
+			bool _freelist_is_heap = false; //< removing from the back doesn't break the heap property
+			std::vector<uint64_t> _occupied; //< one bit per slot in [0, _used_elements), set if valid
+
+			void _mark_occupied(IndexType i) {
+				auto word = static_cast<std::size_t>(i / word_bits);
+				if(word >= _occupied.size()) {
+					_occupied.resize(std::max(word+1, _occupied.size()*2), 0);
+				}
+				_occupied[word] |= uint64_t(1) << (i % word_bits);
+			}
+			void _unmark_occupied(IndexType i) {
+				auto word = static_cast<std::size_t>(i / word_bits);
+				if(word < _occupied.size()) {
+					_occupied[word] &= ~(uint64_t(1) << (i % word_bits));
+				}
+			}
+			/// index of the next occupied (or free) slot in [i, end) or end
+			IndexType _next_slot(IndexType i, IndexType end, bool occupied)const noexcept {
+				while(i<end) {
+					auto word = static_cast<std::size_t>(i / word_bits);
+					auto bits = occupied ? _occupied[word] : ~_occupied[word];
+					bits &= ~uint64_t(0) << (i % word_bits);
+					if(bits!=0) {
+						return std::min(end, static_cast<IndexType>(word)*word_bits
+						                      + static_cast<IndexType>(__builtin_ctzll(bits)));
+					}
+					i = static_cast<IndexType>(word+1) * word_bits;
+				}
+				return end;
+			}
+
+			// moves the last element into the hole (or just removes the hole if it is the last)
+			template<typename F>
+			void _move_into_hole(IndexType hole, F& relocation) {
+				base_t::erase(hole, relocation);
+				_unmark_occupied(this->_used_elements);
+				if(hole < this->_used_elements) {
+					_mark_occupied(hole);
+				}
+			}
+
+			template<typename F>
+			void _fill_holes(F& relocation) {
+				std::sort(_freelist.begin(), _freelist.end(), std::greater<>{});
+				for(auto i : _freelist) {
+					_move_into_hole(i, relocation);
+				}
+				_freelist.clear();
+				_freelist_is_heap = false;
+			}
 
 			static auto& get_marker(const T* obj)noexcept {
 				return *ValueTraits::marker_addr(obj);
@@ -314,6 +590,72 @@ namespace util {
 	};
 	
 	
+	template<class T, std::size_t ElementsPerChunk, class IndexType, class ValueTraits, class ChunkAllocator>
+	template<typename F>
+	void pool<T, ElementsPerChunk, IndexType, ValueTraits, ChunkAllocator, true>::for_each_span_in_chunks(
+	        IndexType first_chunk, IndexType last_chunk, F&& f) {
+		const auto chunk_len = base_t::chunk_len;
+
+		auto first = first_chunk * chunk_len;
+		auto last = std::min(last_chunk * chunk_len, this->_used_elements);
+
+		for(auto begin=_next_slot(first, last, true); begin<last; ) {
+			auto chunk_idx = begin / chunk_len;
+			auto end = _next_slot(begin, std::min(last, (chunk_idx+1) * chunk_len), false);
+
+			auto chunk = reinterpret_cast<T*>(this->_chunks[static_cast<std::size_t>(chunk_idx)].get());
+			f(chunk + (begin % chunk_len), chunk + (end - chunk_idx*chunk_len));
+
+			begin = _next_slot(end, last, true);
+		}
+	}
+
+	template<class T, std::size_t ElementsPerChunk, class IndexType, class ValueTraits, class ChunkAllocator>
+	template<typename F>
+	void pool<T, ElementsPerChunk, IndexType, ValueTraits, ChunkAllocator, true>::for_each_in_chunks(
+	        IndexType first_chunk, IndexType last_chunk, F&& f) {
+		const auto chunk_len = base_t::chunk_len;
+
+		auto first = first_chunk * chunk_len;
+		auto last = std::min(last_chunk * chunk_len, this->_used_elements);
+		if(first>=last)
+			return;
+
+		// visits the set bits of one word at a time
+		for(auto word=static_cast<std::size_t>(first / word_bits); static_cast<IndexType>(word)*word_bits<last; word++) {
+			auto word_begin = static_cast<IndexType>(word) * word_bits;
+			auto bits = _occupied[word];
+			if(word_begin<first)
+				bits &= ~uint64_t(0) << (first - word_begin);
+			if(last-word_begin < word_bits)
+				bits &= ~(~uint64_t(0) << (last - word_begin));
+
+			if(chunk_len % word_bits == 0) {
+				// the word lies within a single chunk
+				auto chunk = reinterpret_cast<T*>(this->_chunks[static_cast<std::size_t>(word_begin / chunk_len)].get());
+				auto base = chunk + (word_begin % chunk_len);
+
+				if(bits==~uint64_t(0)) {
+					for(auto i=0; i<word_bits; i++) {
+						f(base[i]);
+					}
+				} else {
+					for(; bits!=0; bits &= bits-1) {
+						f(base[__builtin_ctzll(bits)]);
+					}
+				}
+
+			} else {
+				for(; bits!=0; bits &= bits-1) {
+					auto i = word_begin + static_cast<IndexType>(__builtin_ctzll(bits));
+					auto chunk = reinterpret_cast<T*>(this->_chunks[static_cast<std::size_t>(i / chunk_len)].get());
+					f(chunk[i % chunk_len]);
+				}
+			}
+		}
+	}
+
+
 	template<class Pool>
 	class pool_iterator : public std::iterator<std::bidirectional_iterator_tag, typename Pool::value_type> {
 		public:
@@ -336,6 +678,8 @@ namespace util {
 				if(_element_iter) {
 					if(!Pool::_valid(_element_iter)) {
 						++*this; // jump to first valid element
+					} else {
+						_load_word(std::integral_constant<bool, Pool::has_free_slots>{});
 					}
 
 					// skip the first 'index' elements
@@ -356,15 +700,7 @@ namespace util {
 
 			pool_iterator& operator++() {
 				INVARIANT(_element_iter!=nullptr, "iterator overflow");
-				do {
-					++_element_iter;
-					if(_element_iter==_element_iter_end) {
-						++_chunk_index;
-						_element_iter_begin = _element_iter = _pool->_chunk(_chunk_index);
-						_element_iter_end = _pool->_chunk_end(_element_iter_begin, _chunk_index);
-					}
-				} while(!Pool::_valid(_element_iter));
-
+				_increment(std::integral_constant<bool, Pool::has_free_slots>{});
 				return *this;
 			}
 
@@ -393,6 +729,7 @@ namespace util {
 					}
 				} while(!Pool::_valid(_element_iter));
 
+				_load_word(std::integral_constant<bool, Pool::has_free_slots>{});
 				return *this;
 			}
 
@@ -416,26 +753,91 @@ namespace util {
 			value_type* _element_iter;
 			value_type* _element_iter_begin;
 			value_type* _element_iter_end;
+			uint64_t _word_bits = 0; //< occupied slots of the current word, starting at _element_iter
+			value_type* _word_base = nullptr; //< element of the first bit of the current word
+
+			void _increment(std::false_type /*has_free_slots*/) {
+				++_element_iter;
+				if(_element_iter==_element_iter_end) {
+					_next_chunk();
+				}
+			}
+			// jumps to the next occupied slot based on the bitmask of the pool, without loading
+			//   the skipped slots. The remaining bits of the current word are cached, so
+			//   consecutive elements only cost a bit scan.
+			void _increment(std::true_type /*has_free_slots*/) {
+				_word_bits &= _word_bits-1; // the current element
+				if(_word_bits!=0) {
+					_element_iter = _word_base + __builtin_ctzll(_word_bits);
+				} else {
+					_next_word();
+				}
+			}
+			// not inlined, so the common case above stays small enough to be inlined
+			__attribute__((noinline)) void _next_word() {
+				using index_t = typename Pool::index_t;
+
+				auto index = _chunk_index*Pool::chunk_len + static_cast<index_t>(_element_iter-_element_iter_begin);
+				auto next = _pool->_next_slot(index+1, _pool->_used_elements, true);
+
+				if(next>=_pool->_used_elements) { // end
+					_chunk_index = _pool->chunk_count();
+					_element_iter = _element_iter_begin = _element_iter_end = nullptr;
+					_word_bits = 0;
+					return;
+				}
+
+				auto chunk_index = next / Pool::chunk_len;
+				if(chunk_index!=_chunk_index) {
+					_chunk_index = chunk_index - 1;
+					_next_chunk();
+				}
+				_element_iter = _element_iter_begin + (next % Pool::chunk_len);
+				_load_word(std::integral_constant<bool, Pool::has_free_slots>{});
+			}
+
+			void _load_word(std::false_type /*has_free_slots*/) {}
+			// only possible if the words don't cross chunk boundaries
+			void _load_word(std::true_type /*has_free_slots*/) {
+				using index_t = typename Pool::index_t;
+				constexpr auto word_bits = Pool::word_bits;
+
+				if(Pool::chunk_len % word_bits != 0 || !_element_iter) {
+					_word_bits = 0;
+					return;
+				}
+
+				auto offset = static_cast<index_t>(_element_iter-_element_iter_begin);
+				auto index = _chunk_index*Pool::chunk_len + offset;
+				_word_bits = _pool->_occupied[static_cast<std::size_t>(index / word_bits)]
+				             & (~uint64_t(0) << (index % word_bits));
+				_word_base = _element_iter - (index % word_bits);
+			}
+			void _next_chunk() {
+				++_chunk_index;
+				_element_iter_begin = _element_iter = _pool->_chunk(_chunk_index);
+				_element_iter_end = _pool->_chunk_end(_element_iter_begin, _chunk_index);
+			}
 	};
 
-	template<class T, std::size_t ElementsPerChunk, class Index_type, class ValueTraits, bool use_empty_values>
-	auto pool<T, ElementsPerChunk, Index_type, ValueTraits, use_empty_values>::begin()noexcept -> iterator {
+	template<class T, std::size_t ElementsPerChunk, class Index_type, class ValueTraits, class ChunkAllocator, bool use_empty_values>
+	auto pool<T, ElementsPerChunk, Index_type, ValueTraits, ChunkAllocator, use_empty_values>::begin()noexcept -> iterator {
 		return iterator{*this, 0};
 	}
 
-	template<class T, std::size_t ElementsPerChunk, class Index_type, class ValueTraits, bool use_empty_values>
-	auto pool<T, ElementsPerChunk, Index_type, ValueTraits, use_empty_values>::end()noexcept -> iterator {
+	template<class T, std::size_t ElementsPerChunk, class Index_type, class ValueTraits, class ChunkAllocator, bool use_empty_values>
+	auto pool<T, ElementsPerChunk, Index_type, ValueTraits, ChunkAllocator, use_empty_values>::end()noexcept -> iterator {
 		return iterator{*this};
 	}
 
 
-	template<class T, std::size_t ElementsPerChunk, class Index_type, class ValueTraits>
-	auto pool<T, ElementsPerChunk, Index_type, ValueTraits, true>::begin()noexcept -> iterator {
+	template<class T, std::size_t ElementsPerChunk, class Index_type, class ValueTraits, class ChunkAllocator>
+	auto pool<T, ElementsPerChunk, Index_type, ValueTraits, ChunkAllocator, true>::begin()noexcept -> iterator {
 		return iterator{*this, 0};
 	}
 
-	template<class T, std::size_t ElementsPerChunk, class Index_type, class ValueTraits>
-	auto pool<T, ElementsPerChunk, Index_type, ValueTraits, true>::end()noexcept -> iterator {
+	template<class T, std::size_t ElementsPerChunk, class Index_type, class ValueTraits, class ChunkAllocator>
+	auto pool<T, ElementsPerChunk, Index_type, ValueTraits, ChunkAllocator, true>::end()noexcept -> iterator {
 		return iterator{*this};
 	}
 
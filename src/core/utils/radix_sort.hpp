@@ -0,0 +1,84 @@
+/** stable LSD radix sort for integer keys with attached values **************
+ *                                                                           *
+ * Copyright (c) 2016 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#pragma once
+
+#include "log.hpp"
+
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+
+namespace lux {
+namespace util {
+
+	/**
+	 * Sorts 'keys' ascending and applies the same permutation to 'values'.
+	 * The sort is stable (elements with equal keys retain their relative order).
+	 * 'tmp_keys' and 'tmp_values' are used as scratch memory and can be reused between
+	 *   calls to avoid reallocations.
+	 * Passes in which all keys share the same digit are skipped.
+	 * O(N * sizeof(Key))
+	 */
+	template<class Key, class Value>
+	void radix_sort(std::vector<Key>& keys, std::vector<Value>& values,
+	                std::vector<Key>& tmp_keys, std::vector<Value>& tmp_values) {
+		static_assert(std::is_unsigned<Key>::value, "radix_sort requires unsigned keys");
+		INVARIANT(keys.size()==values.size(), "Size of keys and values differ: "
+		          <<keys.size()<<"!="<<values.size());
+
+		constexpr auto digit_bits = 8u;
+		constexpr auto buckets    = 1u << digit_bits;
+		constexpr auto passes     = sizeof(Key);
+
+		const auto size = keys.size();
+		if(size<=1)
+			return;
+
+		// build the histograms of all passes at once
+		std::array<std::array<std::size_t, buckets>, passes> histograms{};
+		for(auto key : keys) {
+			for(auto p=0u; p<passes; p++) {
+				histograms[p][(key >> (p*digit_bits)) & (buckets-1)]++;
+			}
+		}
+
+		tmp_keys.resize(size);
+		tmp_values.resize(size);
+
+		for(auto p=0u; p<passes; p++) {
+			auto& histogram = histograms[p];
+			const auto shift = p*digit_bits;
+
+			// all keys share the same digit => nothing to do in this pass
+			if(histogram[(keys.front() >> shift) & (buckets-1)]==size)
+				continue;
+
+			// convert counts into start offsets
+			auto offset = std::size_t(0);
+			for(auto& h : histogram) {
+				auto count = h;
+				h = offset;
+				offset += count;
+			}
+
+			for(auto i=0u; i<size; i++) {
+				auto& target = histogram[(keys[i] >> shift) & (buckets-1)];
+				tmp_keys[target] = keys[i];
+				tmp_values[target] = std::move(values[i]);
+				target++;
+			}
+
+			keys.swap(tmp_keys);
+			values.swap(tmp_values);
+		}
+	}
+
+}
+}
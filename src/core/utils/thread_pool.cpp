@@ -0,0 +1,83 @@
+#include "thread_pool.hpp"
+
+#include "log.hpp"
+
+#include <algorithm>
+
+
+namespace lux {
+namespace util {
+
+	auto Thread_pool::default_worker_count() -> int {
+#ifdef EMSCRIPTEN
+		return 0;
+#else
+		auto hw_threads = static_cast<int>(std::thread::hardware_concurrency());
+		return std::max(0, hw_threads-1);
+#endif
+	}
+
+	Thread_pool::Thread_pool(int worker_count) {
+		_workers.reserve(static_cast<std::size_t>(std::max(0, worker_count)));
+
+		for(auto i=0; i<worker_count; i++) {
+			_workers.emplace_back([this]{_worker_main();});
+		}
+
+		DEBUG("Started thread pool with "<<worker_count<<" workers");
+	}
+	Thread_pool::~Thread_pool() {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_quit = true;
+		}
+		_job_posted.notify_all();
+
+		for(auto& worker : _workers) {
+			worker.join();
+		}
+	}
+
+	void Thread_pool::post(Job job) {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_jobs.emplace_back(std::move(job));
+		}
+		_job_posted.notify_one();
+	}
+
+	auto Thread_pool::try_execute_one() -> bool {
+		auto job = Job{};
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			if(_jobs.empty())
+				return false;
+
+			job = std::move(_jobs.front());
+			_jobs.pop_front();
+		}
+
+		job();
+		return true;
+	}
+
+	void Thread_pool::_worker_main() {
+		while(true) {
+			auto job = Job{};
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_job_posted.wait(lock, [&]{return _quit || !_jobs.empty();});
+
+				if(_quit)
+					return;
+
+				job = std::move(_jobs.front());
+				_jobs.pop_front();
+			}
+
+			job();
+		}
+	}
+
+}
+}
@@ -0,0 +1,118 @@
+/** a fixed set of worker threads executing posted jobs **********************
+ *                                                                           *
+ * Copyright (c) 2016 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+
+namespace lux {
+namespace util {
+
+	/**
+	 * Executes posted jobs in FIFO order on a fixed set of worker threads.
+	 * Threads waiting for the completion of posted jobs should help executing them
+	 *   (try_execute_one), so a pool without workers degrades to sequential execution.
+	 * Jobs must not throw.
+	 */
+	class Thread_pool {
+		public:
+			using Job = std::function<void()>;
+
+			/// one worker per hardware thread (excluding the main thread); 0 if threads are unsupported
+			static auto default_worker_count() -> int;
+
+			explicit Thread_pool(int worker_count=default_worker_count());
+			Thread_pool(const Thread_pool&) = delete;
+			Thread_pool& operator=(const Thread_pool&) = delete;
+			~Thread_pool();
+
+			auto worker_count()const noexcept {return static_cast<int>(_workers.size());}
+
+			/// thread-safe
+			void post(Job job);
+
+			/// executes the next queued job on the calling thread, if there is one; thread-safe
+			auto try_execute_one() -> bool;
+
+			/**
+			 * Splits [0, count) into ranges, that are processed in parallel by the workers and the
+			 *   calling thread, and blocks until all of them are done.
+			 * body = func(begin:int_fast64_t, end:int_fast64_t)->void
+			 * Rethrows the first exception thrown by body.
+			 */
+			template<typename F>
+			void parallel_for(int_fast64_t count, F&& body);
+
+		private:
+			std::vector<std::thread> _workers;
+			std::deque<Job> _jobs;
+			std::mutex _mutex;
+			std::condition_variable _job_posted;
+			bool _quit = false;
+
+			void _worker_main();
+	};
+
+
+	template<typename F>
+	void Thread_pool::parallel_for(int_fast64_t count, F&& body) {
+		// a few ranges per thread, so uneven ranges don't stall the calling thread
+		const auto ranges = std::min<int_fast64_t>(count, (worker_count()+1) * 4);
+
+		if(ranges<=1) {
+			if(count>0) {
+				body(int_fast64_t(0), count);
+			}
+			return;
+		}
+
+		std::atomic<int_fast64_t> remaining{ranges};
+		std::mutex error_mutex;
+		std::exception_ptr error;
+
+		auto run = [&](int_fast64_t range) {
+			try {
+				body(count*range/ranges, count*(range+1)/ranges);
+			} catch(...) {
+				std::lock_guard<std::mutex> lock(error_mutex);
+				if(!error) {
+					error = std::current_exception();
+				}
+			}
+
+			// has to be the last access, because the caller may return as soon as it reaches 0
+			remaining--;
+		};
+
+		for(auto range=int_fast64_t(1); range<ranges; range++) {
+			post([&run, range]{run(range);});
+		}
+		run(0);
+
+		while(remaining.load()>0) {
+			if(!try_execute_one()) {
+				std::this_thread::yield();
+			}
+		}
+
+		if(error) {
+			std::rethrow_exception(error);
+		}
+	}
+
+}
+}
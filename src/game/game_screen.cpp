@@ -36,6 +36,7 @@ namespace lux {
 	      _systems(engine),
 	      _add_to_highscore(add_to_highscore),
 	      _ui_text(engine.assets().load<Font>("font:menu_font"_aid)),
+	      _debug_text(engine.assets().load<Font>("font:menu_font"_aid)),
 	      _hud_background(engine.assets().load<Texture>("tex:hud_background"_aid)),
 	      _hud_timer_background(engine.assets().load<Texture>("tex:hud_timer_background"_aid)),
 	      _hud_light_icon(engine.assets().load<Texture>("tex:hud_light_icon"_aid)),
@@ -61,6 +62,19 @@ namespace lux {
 				case "pause"_strid:
 					_engine.screens().leave();
 					break;
+
+				case "debug_stats"_strid:
+					_show_debug_stats = !_show_debug_stats;
+					_debug_text.set("");
+					break;
+
+				case "dump_stats"_strid: {
+					auto stream = _engine.assets().save_raw("cfg:ecs_stats"_aid);
+					ecs::save_stats(stream, _systems.entity_manager.stats());
+					stream.close();
+					INFO("Written ECS statistics to cfg:ecs_stats");
+					break;
+				}
 			}
 		});
 
@@ -144,6 +158,10 @@ namespace lux {
 		} else
 			_ui_text.set("");
 
+		if(_show_debug_stats) {
+			_update_debug_stats();
+		}
+
 		if(_fadeout) {
 			_fadeout_fadetimer+=dt;
 
@@ -172,6 +190,48 @@ namespace lux {
 	}
 
 
+	void Game_screen::_update_debug_stats() {
+		auto stats = _systems.entity_manager.stats();
+		auto& draw = _systems.renderer.draw_stats();
+
+		auto kib = [](std::size_t bytes) {
+			return static_cast<float>(bytes) / 1024.f;
+		};
+
+		std::stringstream s;
+		s << std::fixed << std::setprecision(1)
+		  << "entities: " << stats.live_entities() << " / " << stats.used_slots
+		  << "  (slots: " << stats.allocated_slots << ", free: " << stats.free_handles << ")\n"
+		  << "chunks: " << kib(stats.chunks.used_bytes) << " KiB used, "
+		  << kib(stats.chunks.cached_bytes) << " KiB cached, "
+		  << kib(stats.chunks.huge_page_bytes) << " KiB huge pages"
+		  << "  (alloc: " << stats.chunks.allocations << ", reused: " << stats.chunks.reused
+		  << ", system: " << stats.chunks.system_allocations << ")\n"
+		  << "drawn/culled: scene " << draw.scene.submitted << "/" << draw.scene.culled
+		  << ", shadowcasters " << draw.shadowcasters.submitted << "/" << draw.shadowcasters.culled
+		  << ", decals " << draw.decals.submitted << "/" << draw.decals.culled << "\n"
+		  << "static geometry: " << draw.static_entries << " entries in " << draw.static_buckets
+		  << " buckets (" << draw.static_rebuilt << " rebuilt)\n"
+		  << std::left << std::setw(16) << "component" << std::right
+		  << std::setw(8) << "size" << std::setw(8) << "chunks" << std::setw(10) << "KiB"
+		  << std::setw(8) << "free" << std::setw(10) << "idx KiB"
+		  << std::setw(8) << "+queue" << std::setw(8) << "-queue" << std::setw(8) << "unopt"
+		  << std::setw(8) << "frag%" << std::setw(16) << "last compaction" << "\n";
+
+		for(auto& c : stats.components) {
+			s << std::left << std::setw(16) << c.name << std::right
+			  << std::setw(8) << c.size << std::setw(8) << c.allocated_chunks
+			  << std::setw(10) << kib(c.storage_bytes) << std::setw(8) << c.free_slots
+			  << std::setw(10) << kib(c.index_bytes) << std::setw(8) << c.queued_insertions
+			  << std::setw(8) << c.queued_deletions << std::setw(8) << c.unoptimized_deletes
+			  << std::setw(8) << c.fragmentation*100.f << (c.compacting ? "*" : " ")
+			  << std::setw(7) << c.fragmentation_before_compaction*100.f << " -> "
+			  << std::setw(4) << c.fragmentation_after_compaction*100.f << "\n";
+		}
+
+		_debug_text.set(s.str(), true);
+	}
+
 	auto Game_screen::_draw_orb(glm::vec2 pos, float scale, ecs::Entity_facet e) -> renderer::Command {
 		auto c = e.get<sys::gameplay::Enlightened_comp>().process(Rgb{1,1,1},
 		                                                          [&](auto& l) {
@@ -319,6 +379,12 @@ namespace lux {
 
 		_render_queue.push_back(draw_texture(*_hud_foreground, bg_pos, 0.5f));
 
+		if(_debug_text) {
+			constexpr auto debug_text_scale = 0.4f;
+			auto debug_pos = hud_pos + glm::vec2{0.f, 300.f} + _debug_text.size()*debug_text_scale/2.f;
+			_debug_text.draw(_render_queue, debug_pos, glm::vec4(1,1,1,1), debug_text_scale);
+		}
+
 		_render_queue.flush();
 	}
 }
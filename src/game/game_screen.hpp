@@ -40,6 +40,8 @@ namespace lux {
 			bool _add_to_highscore;
 
 			renderer::Text_dynamic _ui_text;
+			renderer::Text_dynamic _debug_text;
+			bool _show_debug_stats = false;
 			renderer::Texture_ptr _hud_background;
 			renderer::Texture_ptr _hud_timer_background;
 			renderer::Texture_ptr _hud_light_icon;
@@ -65,6 +67,7 @@ namespace lux {
 			Time _time_acc {0};
 
 			auto _draw_orb(glm::vec2 pos, float scale, ecs::Entity_facet) -> renderer::Command;
+			void _update_debug_stats();
 			void _draw_orbs(sys::gameplay::Player_tag_comp::Pool::iterator selected,
 			                bool left_side, int count, glm::vec2 hud_pos);
 	};
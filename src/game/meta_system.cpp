@@ -1,11 +1,35 @@
 #include "meta_system.hpp"
 
+#include "sys/cam/camera_target_comp.hpp"
+#include "sys/controller/ai_patrolling_comp.hpp"
+#include "sys/controller/input_controller_comp.hpp"
+#include "sys/gameplay/collectable_comp.hpp"
+#include "sys/gameplay/deadly_comp.hpp"
+#include "sys/gameplay/enlightened_comp.hpp"
+#include "sys/gameplay/finish_marker_comp.hpp"
+#include "sys/gameplay/light_tag_comps.hpp"
+#include "sys/gameplay/player_tag_comp.hpp"
+#include "sys/gameplay/reset_comp.hpp"
+#include "sys/graphic/particle_comp.hpp"
+#include "sys/graphic/sprite_comp.hpp"
+#include "sys/graphic/terrain_comp.hpp"
+#include "sys/light/light_comp.hpp"
+#include "sys/physics/physics_comp.hpp"
+#include "sys/physics/transform_comp.hpp"
+#include "sys/sound/sound_comp.hpp"
+
+#include <core/input/events.hpp>
+#include <core/renderer/sprite_animation.hpp>
+
 #include <core/renderer/graphics_ctx.hpp>
 #include <core/renderer/command_queue.hpp>
 #include <core/renderer/uniform_map.hpp>
 #include <core/renderer/texture.hpp>
 #include <core/renderer/texture_batch.hpp>
 #include <core/renderer/primitives.hpp>
+#include <core/utils/chunk_allocator.hpp>
+
+#include <sf2/sf2.hpp>
 
 
 namespace lux {
@@ -22,6 +46,12 @@ namespace lux {
 		using Global_uniform_map = renderer::Uniform_map<global_uniforms,
 		                                                 global_uniforms_avg_size*sizeof(float)>;
 
+		struct Ecs_cfg {
+			ecs::Component_index compaction_budget = 256;
+			bool huge_pages = false;
+		};
+		sf2_structDef(Ecs_cfg, compaction_budget, huge_pages)
+
 		auto shadowbuffer_size(Engine& engine) {
 			return glm::vec2{
 				engine.graphics_ctx().settings().width * engine.graphics_ctx().settings().supersampling,
@@ -193,17 +223,26 @@ namespace lux {
 	      controller(engine, entity_manager, physics),
 	      camera(engine, entity_manager),
 	      lights(engine.bus(), entity_manager, engine.assets(), engine.graphics_ctx()),
-	      renderer(engine.bus(), entity_manager, engine.assets()),
+	      renderer(engine.bus(), entity_manager, engine.assets(), engine.graphics_ctx()),
 	      gameplay(engine, entity_manager, physics, camera, controller),
 	      sound(engine, entity_manager),
 
 	      _engine(engine),
 	      _skybox(engine.assets()),
-	      _post_renderer(std::make_unique<Post_renderer>(engine)) {
+	      _post_renderer(std::make_unique<Post_renderer>(engine)),
+	      _scheduler(&engine.thread_pool()) {
+
+		engine.assets().load_maybe<Ecs_cfg>("cfg:ecs"_aid).process([&](auto& cfg) {
+			entity_manager.compaction_budget(cfg->compaction_budget);
+			util::chunk_allocator_huge_pages(cfg->huge_pages);
+		});
+
+		_init_stages();
 	}
 
 	Meta_system::~Meta_system() {
 		entity_manager.clear();
+		util::trim_chunk_cache();
 	}
 
 
@@ -262,6 +301,7 @@ namespace lux {
 		             level_meta_data.environment_brightness);
 
 		renderer.post_load();
+		_trim_chunk_cache = true;
 
 		return level_meta_data;
 	}
@@ -271,27 +311,104 @@ namespace lux {
 	}
 
 	void Meta_system::update(Time dt, Update_mask mask) {
+		entity_manager.next_change_frame();
 		entity_manager.process_queued_actions();
 
-		if(mask & Update::input) {
-			controller.update(dt);
-			gameplay.update_pre_physic(dt);
+		if(_trim_chunk_cache) {
+			// the new level has reused the cached chunks of the previous one, the rest is released
+			_trim_chunk_cache = false;
+			util::trim_chunk_cache();
 		}
 
-		if(mask & Update::movements) {
-			physics.update(dt);
-		}
-
-		if(mask & Update::input) {
-			gameplay.update_post_physic(dt);
-			scene_graph.update(dt);
-			sound.update(dt);
-		}
+		_scheduler.execute(dt, mask);
+	}
 
-		if(mask & Update::animations) {
-			renderer.update(dt);
-			camera.update(dt);
-		}
+	void Meta_system::_init_stages() {
+		using namespace sys;
+		using physics::Transform_comp;
+		using physics::Dynamic_body_comp;
+		using physics::Static_body_comp;
+		using graphic::Sprite_comp;
+		using graphic::Anim_sprite_comp;
+		using graphic::Particle_comp;
+		using renderer::Animation_event;
+		using ecs::Stage_access;
+
+		constexpr auto input_mask      = static_cast<Update_mask>(Update::input);
+		constexpr auto movements_mask  = static_cast<Update_mask>(Update::movements);
+		constexpr auto animations_mask = static_cast<Update_mask>(Update::animations);
+
+		// the stages are declared in the order of the old sequential update, which is
+		//   preserved for all stages that access the same resources
+		_scheduler.add_stage("controller", input_mask,
+		        Stage_access{}
+		            .reads<Transform_comp, gameplay::Player_tag_comp, gameplay::Enlightened_comp>()
+		            .writes<controller::Input_controller_comp, controller::Ai_patrolling_comp,
+		                    Dynamic_body_comp, Anim_sprite_comp>()
+		            .consumes<input::Once_action, input::Continuous_action, input::Range_action>()
+		            .reads(&physics).writes(&controller),
+		        [&](Time dt) {controller.update(dt);});
+
+		// gameplay touches nearly everything, so it is only parallelized with independent stages.
+		// Every stage that writes the assets may load GL resources (e.g. the textures of spawned
+		//   blueprints) and has to run on the main thread, which owns the GL context.
+		auto gameplay_access = Stage_access{}
+		        .writes<Transform_comp, Dynamic_body_comp, Static_body_comp, Sprite_comp,
+		                Anim_sprite_comp, Particle_comp, light::Light_comp>()
+		        .writes<gameplay::Collectable_comp, gameplay::Deadly_comp, gameplay::Enlightened_comp,
+		                gameplay::Finish_marker_comp, gameplay::Player_tag_comp, gameplay::Reset_comp>()
+		        .writes<gameplay::Reflective_comp, gameplay::Paintable_comp, gameplay::Paint_comp,
+		                gameplay::Light_leech_comp, gameplay::Transparent_comp, gameplay::Lamp_comp,
+		                gameplay::Prism_comp>()
+		        .consumes<physics::Collision, physics::Contact, Animation_event>()
+		        .sends<Animation_event, gameplay::Level_finished>()
+		        .writes(&gameplay).writes(&physics).writes(&camera).writes(&controller)
+		        .writes(&_engine.assets())
+		        .main_thread();
+
+		_scheduler.add_stage("gameplay_pre_physic", input_mask, gameplay_access,
+		                     [&](Time dt) {gameplay.update_pre_physic(dt);});
+
+		_scheduler.add_stage("physics", movements_mask,
+		        Stage_access{}
+		            .writes<Transform_comp, Dynamic_body_comp, Static_body_comp>()
+		            .reads<Sprite_comp, Anim_sprite_comp, graphic::Terrain_comp>()
+		            .sends<physics::Collision, physics::Contact>()
+		            .writes(&physics),
+		        [&](Time dt) {physics.update(dt);});
+
+		_scheduler.add_stage("gameplay_post_physic", input_mask, gameplay_access,
+		                     [&](Time dt) {gameplay.update_post_physic(dt);});
+
+		_scheduler.add_stage("scene_graph", input_mask,
+		        Stage_access{}.writes<Transform_comp>().reads<physics::Parent_comp>().writes(&scene_graph),
+		        [&](Time dt) {scene_graph.update(dt);});
+
+		// the audio context is bound to the main thread
+		_scheduler.add_stage("sound", input_mask,
+		        Stage_access{}
+		            .reads<sound::Sound_comp>()
+		            .consumes<Animation_event>()
+		            .writes(&sound).writes(&_engine.assets())
+		            .main_thread(),
+		        [&](Time dt) {sound.update(dt);});
+
+		// creates emitters (loading their textures) and updates their vertex buffers
+		_scheduler.add_stage("renderer", animations_mask,
+		        Stage_access{}
+		            .writes<Anim_sprite_comp, Sprite_comp, Particle_comp>()
+		            .reads<Transform_comp>()
+		            .sends<Animation_event>()
+		            .writes(&renderer).writes(&_engine.assets())
+		            .main_thread(),
+		        [&](Time dt) {renderer.update(dt);});
+
+		_scheduler.add_stage("camera", animations_mask,
+		        Stage_access{}
+		            .reads<Transform_comp, Dynamic_body_comp>()
+		            .writes<cam::Camera_target_comp>()
+		            .writes(&camera),
+		        [&](Time dt) {camera.update(dt);});
 	}
 
 	void Meta_system::draw(util::maybe<const renderer::Camera&> cam_mb) {
@@ -20,6 +20,7 @@
 
 #include <core/engine.hpp>
 #include <core/ecs/ecs.hpp>
+#include <core/ecs/system_scheduler.hpp>
 #include <core/renderer/camera.hpp>
 #include <core/renderer/command_queue.hpp>
 #include <core/renderer/skybox.hpp>
@@ -78,6 +79,9 @@ namespace lux {
 			sys::gameplay::Gameplay_system gameplay;
 			sys::sound::Sound_sys sound;
 
+			/// executes the update stages of the systems; see update(...)
+			auto& scheduler()noexcept {return _scheduler;}
+
 		private:
 			struct Post_renderer;
 
@@ -87,7 +91,11 @@ namespace lux {
 			std::unique_ptr<Post_renderer> _post_renderer;
 
 			std::string _current_level;
+			bool _trim_chunk_cache = false; //< the new level has been loaded but not processed yet
+
+			ecs::System_scheduler _scheduler;
 
+			void _init_stages();
 	};
 
 }
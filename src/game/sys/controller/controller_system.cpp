@@ -380,7 +380,17 @@ namespace controller {
 		_transform = false;
 
 
+		// changing the friction resets the contacts, that are shared with other bodies,
+		//   so it can't be done in parallel
 		for(auto& c : _ai_controllers) {
+			auto& body = c.owner().get<physics::Dynamic_body_comp>().get_or_throw();
+			if(!body.kinematic()) {
+				body.foot_friction(false);
+			}
+		}
+
+		// each controller only modifies its own entity and the physics world is only queried
+		_ai_controllers.parallel_for_each([&](Ai_patrolling_comp& c) {
 			auto&transform_comp = c.owner().get<physics::Transform_comp>().get_or_throw();
 			auto position = remove_units(transform_comp.position()).xy();
 			auto& body = c.owner().get<physics::Dynamic_body_comp>().get_or_throw();
@@ -421,10 +431,9 @@ namespace controller {
 
 			} else {
 				auto move_force = vel_diff * body.mass() / dt.value();
-				body.foot_friction(false);
 				body.apply_force(move_force);
 			}
-		}
+		});
 	}
 
 }
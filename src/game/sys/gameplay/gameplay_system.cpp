@@ -50,6 +50,15 @@ namespace gameplay {
 	      _players(ecs.list<Player_tag_comp>()),
 	      _lamps(ecs.list<Lamp_comp>()),
 	      _paints(ecs.list<Paint_comp>()),
+	      _lamp_index(ecs, [](const Lamp_comp& lamp, const physics::Transform_comp& transform) {
+	          // see Lamp_comp::in_range
+	          auto range = lamp._max_distance.value() * lamp._max_distance.value();
+	          return physics::Aabb::around(remove_units(transform.position() + lamp._offset).xy(), range);
+	      }),
+	      _paint_index(ecs, [](const Paint_comp& paint, const physics::Transform_comp& transform) {
+	          auto radius = paint._radius * std::sqrt(transform.scale());
+	          return physics::Aabb::around(remove_units(transform.position()).xy(), radius);
+	      }),
 	      _finish_marker(ecs.list<Finish_marker_comp>()),
 	      _reset_comps(ecs.list<Reset_comp>()),
 	      _physics_world(physics_world),
@@ -147,6 +156,7 @@ namespace gameplay {
 	}
 
 	void Gameplay_system::update_pre_physic(Time dt) {
+		_lamp_index.update();
 		_update_light(dt);
 
 		for(auto& lamp : _lamps) {
@@ -159,9 +169,7 @@ namespace gameplay {
 		if(_first_update_after_reset) {
 			_mailbox.enable();
 
-			for(auto& d : _reset_data) {
-				_ecs.read_one(d);
-			}
+			_ecs.restore(_reset_data);
 			_reset_data.clear();
 
 			if(_players.size()==0) {
@@ -170,15 +178,16 @@ namespace gameplay {
 				return;
 			}
 
-			_reset_data.reserve(_reset_comps.size());
 			for(Reset_comp& c : _reset_comps) {
-				_reset_data.push_back(_ecs.write_one(c.owner_handle()));
+				_ecs.snapshot(c.owner_handle(), _reset_data);
 			}
 
 			_first_update_after_reset = false;
 		}
 
+		_paint_index.update();
 		_mailbox.update_subscriptions();
+		_spawn_blood();
 
 		if(_level_finished) {
 			return; //< we are done here
@@ -236,18 +245,16 @@ namespace gameplay {
 		                                                   [&](auto&) {
 			auto reflected = Light_color::black;
 
-			for(auto& p : _paints) {
+			_paint_index.for_each_in_radius(pos, 0.f, [&](Paint_comp& p, physics::Transform_comp& transform) {
 				auto interaction = interactive_color(p._color, light._color);
 
 				if(interaction!=Light_color::black) {
-					ecs::Entity_facet entity = p.owner();
-					auto& transform = entity.get<physics::Transform_comp>().get_or_throw();
 					auto paint_pos = remove_units(transform.position()).xy();
 					if(glm::length2(paint_pos-pos) < p._radius*p._radius*transform.scale()) {
 						reflected = reflected | interaction;
 					}
 				}
-			}
+			});
 
 			return Light_op_res{reflected, not_interactive_color(reflected, light._color)};
 		});
@@ -342,7 +349,8 @@ namespace gameplay {
 			}
 
 			auto res_color = c._color;
-			for(auto& lamp : _lamps) {
+			auto pos = remove_units(transform.position()).xy();
+			_lamp_index.for_each_in_radius(pos, 0.f, [&](Lamp_comp& lamp, auto&) {
 				if(lamp._cooldown_left<=0_s && lamp.in_range(transform.position())) {
 					auto new_res_color = lamp.resulting_color(res_color);
 					if(new_res_color!=res_color) {
@@ -350,7 +358,7 @@ namespace gameplay {
 						lamp._cooldown_left = 1_s;
 					}
 				}
-			}
+			});
 			if(res_color!=c._color) {
 				_mailbox.send<Animation_event>("color_sound"_strid, ecs::to_void_ptr(c.owner_handle()));
 				_color_player(c, res_color);
@@ -468,40 +476,8 @@ namespace gameplay {
 					auto& transform = e.get<physics::Transform_comp>().get_or_throw();
 					auto color = light.get_or_throw()._color;
 
-					ecs::Entity_facet blood;
-
-					switch (color) {
-						case Light_color::blue:
-							blood = _ecs.emplace("blood_blue");
-							break;
-						case Light_color::cyan:
-							blood = _ecs.emplace("blood_cyan");
-							break;
-						case Light_color::green:
-							blood = _ecs.emplace("blood_green");
-							break;
-						case Light_color::magenta:
-							blood = _ecs.emplace("blood_magenta");
-							break;
-						case Light_color::red:
-							blood = _ecs.emplace("blood_red");
-							break;
-						case Light_color::white:
-							blood = _ecs.emplace("blood_white");
-							break;
-						case Light_color::yellow:
-							blood = _ecs.emplace("blood_yellow");
-							break;
-						case Light_color::black:
-							break;
-					}
-
-					if(blood) {
-						auto& t = blood.get<physics::Transform_comp>().get_or_throw();
-						t.position(transform.position());
-						t.scale(util::random_real(_rng, 0.8f, 1.0f));
-						t.rotation(Angle::from_degrees(util::random_real(_rng, 0.f, 360.f)));
-					}
+					// spawned together with all other deaths of this frame by _spawn_blood
+					_blood_spawns[static_cast<std::size_t>(color)].push_back(transform.position());
 				}
 
 				_ecs.erase(e);
@@ -510,6 +486,42 @@ namespace gameplay {
 		}
 	}
 
+	void Gameplay_system::_spawn_blood() {
+		auto blueprint = [](Light_color color) -> const char* {
+			switch(color) {
+				case Light_color::blue:    return "blood_blue";
+				case Light_color::cyan:    return "blood_cyan";
+				case Light_color::green:   return "blood_green";
+				case Light_color::magenta: return "blood_magenta";
+				case Light_color::red:     return "blood_red";
+				case Light_color::white:   return "blood_white";
+				case Light_color::yellow:  return "blood_yellow";
+				case Light_color::black:   return nullptr;
+			}
+			return nullptr;
+		};
+
+		for(auto i=0u; i<_blood_spawns.size(); i++) {
+			auto& positions = _blood_spawns[i];
+			auto name = blueprint(static_cast<Light_color>(i));
+			if(positions.empty() || !name) {
+				positions.clear();
+				continue;
+			}
+
+			auto blood = _ecs.emplace_bulk(positions.size(), name);
+			for(auto j=0u; j<blood.size(); j++) {
+				blood[j].get<physics::Transform_comp>().process([&](auto& t) {
+					t.position(positions[j]);
+					t.scale(util::random_real(_rng, 0.8f, 1.0f));
+					t.rotation(Angle::from_degrees(util::random_real(_rng, 0.f, 360.f)));
+				});
+			}
+
+			positions.clear();
+		}
+	}
+
 	void Gameplay_system::_handle_light_pending(Time, Enlightened_comp& c) {
 		if(!c._was_light) {
 			c._initial_timer = 0_s;
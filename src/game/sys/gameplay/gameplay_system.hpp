@@ -12,6 +12,7 @@
 #include "light_tag_comps.hpp"
 
 #include "../physics/physics_system.hpp"
+#include "../physics/spatial_index.hpp"
 #include "finish_marker_comp.hpp"
 #include "reset_comp.hpp"
 
@@ -23,7 +24,9 @@
 #include <core/ecs/ecs.hpp>
 #include <core/utils/random.hpp>
 
+#include <array>
 #include <functional>
+#include <vector>
 
 
 namespace lux {
@@ -61,13 +64,16 @@ namespace gameplay {
 			Player_tag_comp::Pool& _players;
 			Lamp_comp::Pool& _lamps;
 			Paint_comp::Pool& _paints;
+			physics::Spatial_index<Lamp_comp> _lamp_index;
+			physics::Spatial_index<Paint_comp> _paint_index;
 			Finish_marker_comp::Pool& _finish_marker;
 			Reset_comp::Pool& _reset_comps;
-			std::vector<std::string> _reset_data;
+			ecs::Snapshot _reset_data;
 			physics::Physics_system& _physics_world;
 			cam::Camera_system& _camera_sys;
 			controller::Controller_system& _controller_sys;
 			util::random_generator _rng;
+			std::array<std::vector<Position>, light_color_num> _blood_spawns; //< per Light_color
 
 			Time _light_timer{0};
 			Time _light_effects_timer{0};
@@ -83,6 +89,7 @@ namespace gameplay {
 			auto _is_solid(Enlightened_comp& light, ecs::Entity_facet* hit) -> Light_op_res;
 			void _on_smashed(ecs::Entity_facet e);
 			void _on_animation_event(const renderer::Animation_event& event);
+			void _spawn_blood();
 
 			void _on_collision(sys::physics::Collision&);
 			void _on_contact(sys::physics::Contact&);
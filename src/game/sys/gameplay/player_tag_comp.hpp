@@ -23,6 +23,9 @@ namespace gameplay {
 			Player_tag_comp() = default;
 			Player_tag_comp(ecs::Entity_manager& manager, ecs::Entity_handle owner)
 			    : Component(manager, owner) {}
+
+			friend void load_component(ecs::Binary_reader&, Player_tag_comp&) {}
+			friend void save_component(ecs::Binary_writer&, const Player_tag_comp&) {}
 	};
 
 }
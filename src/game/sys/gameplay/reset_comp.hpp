@@ -23,6 +23,9 @@ namespace gameplay {
 			Reset_comp() = default;
 			Reset_comp(ecs::Entity_manager& manager, ecs::Entity_handle owner)
 			    : Component(manager, owner) {}
+
+			friend void load_component(ecs::Binary_reader&, Reset_comp&) {}
+			friend void save_component(ecs::Binary_writer&, const Reset_comp&) {}
 	};
 
 }
@@ -7,6 +7,8 @@
 #include <core/units.hpp>
 #include <core/renderer/command_queue.hpp>
 
+#include <limits>
+
 
 namespace lux {
 namespace sys {
@@ -34,6 +36,60 @@ namespace graphic {
 			return prog;
 		}
 
+		// the Light_system renders the occlusion map (and the decals) from a camera, that is
+		//   2 units further back and lags up to sqrt(0.5) units behind the camera
+		//   (see Light_system::_setup_uniforms)
+		constexpr auto light_cam_distance = 2.f;
+		constexpr auto light_cam_lag = 0.71f;
+
+		auto light_frustum(const renderer::Camera& camera) {
+			auto view = camera.view();
+			view[3].z -= light_cam_distance;
+			return Frustum{camera.proj() * view};
+		}
+
+		// radius of the bounding circle, that contains the sprite independent of its rotation
+		auto sprite_radius(glm::vec2 size, float scale) {
+			return 0.5f * glm::length(size*scale);
+		}
+
+		class Culler {
+			public:
+				Culler(Frustum frustum, Culling_stats& stats, float margin=0.f)
+				    : _frustum(frustum), _stats(stats), _margin(margin) {
+					_stats = Culling_stats{};
+				}
+
+				auto visible(glm::vec3 center, float radius) -> bool {
+					if(_frustum.intersects(center, radius+_margin)) {
+						_stats.submitted++;
+						return true;
+					}
+
+					_stats.culled++;
+					return false;
+				}
+				auto visible(glm::vec3 position, glm::vec4 bounds) -> bool {
+					auto center = position + glm::vec3((bounds.xy()+bounds.zw())/2.f, 0.f);
+					return visible(center, glm::length(bounds.zw()-bounds.xy()) / 2.f);
+				}
+
+			private:
+				Frustum _frustum;
+				Culling_stats& _stats;
+				float _margin;
+		};
+
+		// frames a sprite has to stay unchanged, before it's baked into the static geometry
+		constexpr auto static_sprite_delay = 8;
+
+		auto same_geometry(const renderer::Sprite& a, const renderer::Sprite& b) {
+			return a.position==b.position && a.decals_offset==b.decals_offset
+			       && a.rotation==b.rotation && a.size==b.size && a.uv==b.uv
+			       && a.hue_change==b.hue_change && a.shadow_resistence==b.shadow_resistence
+			       && a.decals_intensity==b.decals_intensity && a.material==b.material;
+		}
+
 		auto flip(glm::vec4 uv_clip, bool vert, bool horiz) {
 			return glm::vec4 {
 				horiz ? uv_clip.z : uv_clip.x,
@@ -47,17 +103,25 @@ namespace graphic {
 	Graphic_system::Graphic_system(
 	        util::Message_bus& bus,
 	        ecs::Entity_manager& entity_manager,
-	        asset::Asset_manager& asset_manager)
+	        asset::Asset_manager& asset_manager,
+	        const renderer::Graphics_ctx& graphics_ctx)
 	    : _background_shader(build_background_shader(asset_manager)),
 	      _mailbox(bus),
+	      _entity_manager(entity_manager),
 	      _sprites(entity_manager.list<Sprite_comp>()),
 	      _anim_sprites(entity_manager.list<Anim_sprite_comp>()),
-	      _terrains(entity_manager.list<Terrain_comp>()),
 	      _particles(entity_manager.list<Particle_comp>()),
 	      _decals(entity_manager.list<Decal_comp>()),
 	      _particle_renderer(asset_manager),
 	      _sprite_batch(512),
 	      _sprite_batch_bg(_background_shader, 256),
+	      _sprite_instance_batch(512),
+	      _static_batch_bg(_background_shader),
+#ifndef ANDROID
+	      _instanced_sprites(graphics_ctx.settings().instanced_sprites),
+#else
+	      _instanced_sprites(false),
+#endif
 	      _decal_batch(32, false)
 	{
 		entity_manager.register_component_type<Sprite_comp>();
@@ -71,8 +135,12 @@ namespace graphic {
 	}
 
 	void Graphic_system::draw(renderer::Command_queue& queue, const renderer::Camera& camera)const {
-		for(Sprite_comp& sprite : _sprites) {
-			auto& trans = sprite.owner().get<physics::Transform_comp>().get_or_throw();
+		using physics::Transform_comp;
+
+		auto culler = Culler{camera.frustum(), _draw_stats.scene};
+
+		_entity_manager.view<Sprite_comp, Transform_comp>().for_each([&](Sprite_comp& sprite, Transform_comp& trans) {
+			auto position = remove_units(trans.position());
 
 			auto decal_offset = glm::vec2{};
 			if(sprite._decals_sticky) {
@@ -80,7 +148,6 @@ namespace graphic {
 				decal_offset.y = sprite._decals_position.y - trans.position().y.value();
 			}
 
-			auto position = remove_units(trans.position());
 			auto sprite_data = renderer::Sprite{
 			                   position, trans.rotation(),
 			                   sprite._size*trans.scale(),
@@ -93,15 +160,35 @@ namespace graphic {
 			    sprite._hue_change_replacement / 360_deg
 			};
 
-			if(position.z<background_boundary) {
-				_sprite_batch_bg.insert(sprite_data);
-			} else {
-				_sprite_batch.insert(sprite_data);
+			auto unchanged = same_geometry(sprite_data, sprite._last_sprite);
+			if(sprite._static_geometry) {
+				auto& static_batch = _static_batch_for(sprite._last_sprite.position.z);
+				if(unchanged && static_batch.keep(sprite._static_geometry))
+					return;
+
+				static_batch.erase(sprite._static_geometry);
+				sprite._static_geometry = {};
 			}
-		}
 
-		for(Anim_sprite_comp& sprite : _anim_sprites) {
-			auto& trans = sprite.owner().get<physics::Transform_comp>().get_or_throw();
+			sprite._unchanged_frames = unchanged ? sprite._unchanged_frames+1 : 0;
+			sprite._last_sprite = sprite_data;
+
+			// alpha blended sprites have to be ordered relative to the other sprites
+			if(sprite._unchanged_frames>=static_sprite_delay && !sprite_data.material->alpha()) {
+				sprite._static_geometry = _static_batch_for(position.z).update({}, sprite_data);
+				return;
+			}
+
+			if(!culler.visible(position, sprite_radius(sprite._size, trans.scale())))
+				return;
+
+			_draw_sprite(sprite_data);
+		});
+
+		_entity_manager.view<Anim_sprite_comp, Transform_comp>().for_each([&](Anim_sprite_comp& sprite, Transform_comp& trans) {
+			auto position = remove_units(trans.position());
+			if(!culler.visible(position, sprite_radius(sprite._size, trans.scale())))
+				return;
 
 			auto decal_offset = glm::vec2{};
 			if(sprite._decals_sticky) {
@@ -109,7 +196,6 @@ namespace graphic {
 				decal_offset.y = sprite._decals_position.y - trans.position().y.value();
 			}
 
-			auto position = remove_units(trans.position());
 			auto sprite_data = renderer::Sprite{
 			                   position, trans.rotation(),
 			                   sprite._size*trans.scale(),
@@ -122,74 +208,127 @@ namespace graphic {
 			    sprite._hue_change_replacement / 360_deg
 			};
 
-			if(position.z<background_boundary) {
-				_sprite_batch_bg.insert(sprite_data);
-			} else {
-				_sprite_batch.insert(sprite_data);
-			}
-		}
+			_draw_sprite(sprite_data);
+		});
 
-		for(Terrain_comp& terrain : _terrains) {
-			auto& trans = terrain.owner().get<physics::Transform_comp>().get_or_throw();
+		_entity_manager.view<Terrain_comp, Transform_comp>().for_each([&](Terrain_comp& terrain, Transform_comp& trans) {
 			auto position = remove_units(trans.position());
+			auto& texture = terrain._smart_texture;
+
+			if(texture.material() && !texture.material()->alpha()) {
+				auto& geometry = texture.geometry();
+				auto& static_batch = _static_batch_for(position.z);
+
+				if(terrain._static_geometry && terrain._static_revision==texture.revision()
+				   && terrain._static_position==position && static_batch.keep(terrain._static_geometry))
+					return;
+
+				if(terrain._static_geometry) {
+					_static_batch_for(terrain._static_position.z).erase(terrain._static_geometry);
+				}
+				terrain._static_geometry = static_batch.update({}, position, geometry);
+				terrain._static_revision = texture.revision();
+				terrain._static_position = position;
+				return;
+			}
+
+			if(!culler.visible(position, texture.bounds()))
+				return;
 
 			if(position.z<background_boundary) {
-				terrain._smart_texture.draw(position, _sprite_batch_bg);
+				texture.draw(position, _sprite_batch_bg);
 			} else {
-				terrain._smart_texture.draw(position, _sprite_batch);
+				texture.draw(position, _sprite_batch);
 			}
-		}
+		});
+
+		auto frustum = camera.frustum();
+		_static_batch.flush(queue, frustum);
+		_static_batch_bg.flush(queue, frustum);
+		_draw_stats.static_entries = _static_batch.size() + _static_batch_bg.size();
+		_draw_stats.static_buckets = _static_batch.bucket_count() + _static_batch_bg.bucket_count();
+		_draw_stats.static_rebuilt = _static_batch.rebuilt_buckets() + _static_batch_bg.rebuilt_buckets();
 
 		_sprite_batch.flush(queue);
 		_sprite_batch_bg.flush(queue);
+		_sprite_instance_batch.flush(queue);
 
-		_particle_renderer.draw(queue);
+		_particle_renderer.draw(queue, ecs::get_thread_pool(_entity_manager));
+	}
+	void Graphic_system::_draw_sprite(const renderer::Sprite& sprite)const {
+		if(sprite.position.z<background_boundary) {
+			_sprite_batch_bg.insert(sprite);
+
+		} else if(_instanced_sprites && !sprite.material->alpha()) {
+			// only opaque sprites, because the instanced batch isn't ordered relative to _sprite_batch
+			_sprite_instance_batch.insert(sprite);
+
+		} else {
+			_sprite_batch.insert(sprite);
+		}
 	}
+
+	auto Graphic_system::_static_batch_for(float z)const -> renderer::Static_sprite_batch& {
+		return z<background_boundary ? _static_batch_bg : _static_batch;
+	}
+
 	void Graphic_system::draw_shadowcaster(renderer::Sprite_batch& batch,
-	                                       const renderer::Camera&)const {
-		for(Sprite_comp& sprite : _sprites) {
-			auto& trans = sprite.owner().get<physics::Transform_comp>().get_or_throw();
+	                                       const renderer::Camera& camera)const {
+		using physics::Transform_comp;
+
+		auto culler = Culler{light_frustum(camera), _draw_stats.shadowcasters, light_cam_lag};
 
+		_entity_manager.view<Sprite_comp, Transform_comp>().for_each([&](Sprite_comp& sprite, Transform_comp& trans) {
 			auto position = remove_units(trans.position());
 
-			if(sprite._shadowcaster && std::abs(position.z) < 1.0f) {
+			if(sprite._shadowcaster && std::abs(position.z) < 1.0f
+			   && culler.visible(position, sprite_radius(sprite._size, trans.scale()))) {
 				batch.insert(renderer::Sprite{position, trans.rotation(),
 				             sprite._size*trans.scale(),
 				             flip(glm::vec4{0,0,1,1}, trans.flip_vertical(), trans.flip_horizontal()),
 				             sprite._shadowcaster ? 1.0f : 0.0f,
 				             sprite._decals_intensity, *sprite._material});
 			}
-		}
-
-		for(Anim_sprite_comp& sprite : _anim_sprites) {
-			auto& trans = sprite.owner().get<physics::Transform_comp>().get_or_throw();
+		});
 
+		_entity_manager.view<Anim_sprite_comp, Transform_comp>().for_each([&](Anim_sprite_comp& sprite, Transform_comp& trans) {
 			auto position = remove_units(trans.position());
 
-			if(sprite._shadowcaster && std::abs(position.z) < 1.0f) {
+			if(sprite._shadowcaster && std::abs(position.z) < 1.0f
+			   && culler.visible(position, sprite_radius(sprite._size, trans.scale()))) {
 				batch.insert(renderer::Sprite{position, trans.rotation(),
 				             sprite._size*trans.scale(),
 				             flip(sprite.state().uv_rect(), trans.flip_vertical(), trans.flip_horizontal()),
 				             sprite._shadowcaster ? 1.0f : 0.0f,
 				             sprite._decals_intensity, sprite.state().material()});
 			}
-		}
+		});
 
-		for(Terrain_comp& terrain : _terrains) {
-			auto& trans = terrain.owner().get<physics::Transform_comp>().get_or_throw();
+		_entity_manager.view<Terrain_comp, Transform_comp>().for_each([&](Terrain_comp& terrain, Transform_comp& trans) {
 			auto position = remove_units(trans.position());
 
-			if(terrain._smart_texture.shadowcaster() && std::abs(position.z) < 1.0f) {
+			if(terrain._smart_texture.shadowcaster() && std::abs(position.z) < 1.0f
+			   && culler.visible(position, terrain._smart_texture.bounds())) {
 				terrain._smart_texture.draw(position, batch);
 			}
-		}
+		});
 	}
 
 	void Graphic_system::draw_decals(renderer::Command_queue& queue,
-	                                 const renderer::Camera&)const {
+	                                 const renderer::Camera& camera)const {
+		// drawn with the vp of the Light_system (see Meta_system::draw)
+		auto culler = Culler{light_frustum(camera), _draw_stats.decals, light_cam_lag};
+
 		for(Decal_comp& d : _decals) {
 			auto& trans = d.owner().get<physics::Transform_comp>().get_or_throw();
 			auto pos = remove_units(trans.position()).xy();
+
+			// negative sizes are replaced by the size of the texture, so they can't be culled
+			auto radius = d._size.x<0.f || d._size.y<0.f ? std::numeric_limits<float>::infinity()
+			                                             : sprite_radius(d._size, trans.scale());
+			if(!culler.visible(glm::vec3(pos, 0.f), radius))
+				continue;
+
 			_decal_batch.insert(*d._texture,
 			                    pos,
 			                    d._size*trans.scale(),
@@ -210,11 +349,12 @@ namespace graphic {
 			}
 		};
 
-		for(Anim_sprite_comp& sprite : _anim_sprites) {
+		// only touches the sprite itself and sends events through the (thread-safe) bus
+		_anim_sprites.parallel_for_each([&](Anim_sprite_comp& sprite) {
 			sprite.state().update(dt, _mailbox.bus());
 
 			update_decal_pos(sprite);
-		}
+		});
 		for(Sprite_comp& sprite : _sprites) {
 			update_decal_pos(sprite);
 		}
@@ -15,6 +15,7 @@
 #include "../../entity_events.hpp"
 
 #include <core/renderer/camera.hpp>
+#include <core/renderer/graphics_ctx.hpp>
 #include <core/renderer/sprite_batch.hpp>
 #include <core/renderer/particles.hpp>
 #include <core/renderer/texture_batch.hpp>
@@ -25,11 +26,27 @@ namespace lux {
 namespace sys {
 namespace graphic {
 
+	struct Culling_stats {
+		int submitted = 0; //< objects inserted into the batches
+		int culled = 0;    //< objects skipped, because their bounds are outside of the frustum
+	};
+	/// of the last call to each of the draw methods
+	struct Draw_stats {
+		Culling_stats scene;
+		Culling_stats shadowcasters;
+		Culling_stats decals;
+
+		std::size_t static_entries = 0; //< sprites and terrains baked into static geometry
+		std::size_t static_buckets = 0;
+		std::size_t static_rebuilt = 0; //< buckets re-uploaded in the last frame
+	};
+
 	class Graphic_system {
 		public:
 			Graphic_system(util::Message_bus& bus,
 			               ecs::Entity_manager& entity_manager,
-			               asset::Asset_manager& asset_manager);
+			               asset::Asset_manager& asset_manager,
+			               const renderer::Graphics_ctx& graphics_ctx);
 
 			void draw(renderer::Command_queue&, const renderer::Camera& camera)const;
 			void draw_shadowcaster(renderer::Sprite_batch&, const renderer::Camera& camera)const;
@@ -39,24 +56,33 @@ namespace graphic {
 
 			void post_load();
 
+			auto draw_stats()const noexcept -> auto& {return _draw_stats;}
+
 		private:
 			void _on_state_change(const State_change&);
 
 			renderer::Shader_program _background_shader;
 
 			util::Mailbox_collection _mailbox;
+			ecs::Entity_manager& _entity_manager;
 			Sprite_comp::Pool& _sprites;
 			Anim_sprite_comp::Pool& _anim_sprites;
-			Terrain_comp::Pool& _terrains;
 			Particle_comp::Pool& _particles;
 			Decal_comp::Pool& _decals;
 
 			renderer::Particle_renderer _particle_renderer;
 			mutable renderer::Sprite_batch _sprite_batch;
 			mutable renderer::Sprite_batch _sprite_batch_bg;
+			mutable renderer::Sprite_instance_batch _sprite_instance_batch;
+			mutable renderer::Static_sprite_batch _static_batch;
+			mutable renderer::Static_sprite_batch _static_batch_bg;
+			bool _instanced_sprites;
 			mutable renderer::Texture_batch _decal_batch;
+			mutable Draw_stats _draw_stats;
 
 			void _update_particles(Time dt);
+			void _draw_sprite(const renderer::Sprite&)const;
+			auto _static_batch_for(float z)const -> renderer::Static_sprite_batch&;
 	};
 
 }
@@ -11,6 +11,7 @@
 #include <core/ecs/component.hpp>
 #include <core/renderer/material.hpp>
 #include <core/renderer/sprite_animation.hpp>
+#include <core/renderer/sprite_batch.hpp>
 
 
 namespace lux {
@@ -63,6 +64,11 @@ namespace graphic {
 			bool _decals_sticky = false; //< attach decals to intial position
 			Angle _hue_change_target {0};
 			Angle _hue_change_replacement {0};
+
+			// baked into the static geometry after it hasn't changed for a couple of frames
+			renderer::Static_sprite_batch::Handle _static_geometry;
+			renderer::Sprite _last_sprite;
+			int _unchanged_frames = 0;
 	};
 
 	class Anim_sprite_comp : public ecs::Component<Anim_sprite_comp> {
@@ -24,6 +24,9 @@ namespace graphic {
 			Terrain_data_comp() = default;
 			Terrain_data_comp(ecs::Entity_manager& manager, ecs::Entity_handle owner)
 			    : Component(manager, owner){}
+			// not copyable, because loading requires the Terrain_comp of the owner
+			Terrain_data_comp(Terrain_data_comp&&) = default;
+			Terrain_data_comp& operator=(Terrain_data_comp&&) = default;
 	};
 
 
@@ -44,6 +47,10 @@ namespace graphic {
 			friend class Graphic_system;
 
 			renderer::Smart_texture _smart_texture;
+
+			renderer::Static_sprite_batch::Handle _static_geometry;
+			uint32_t _static_revision = 0;
+			glm::vec3 _static_position;
 	};
 
 }
@@ -16,8 +16,7 @@
 #include <core/renderer/texture_batch.hpp>
 #include <core/renderer/graphics_ctx.hpp>
 
-
-#define NUM_LIGHTS_MACRO 8
+#include <string>
 
 namespace lux {
 namespace sys {
@@ -26,11 +25,41 @@ namespace light {
 	using namespace renderer;
 
 	namespace {
-		static_assert(NUM_LIGHTS_MACRO==max_lights, "Update the NUM_LIGHTS_MACRO macro!");
-
 		constexpr auto shadowed_lights = 2;
 		constexpr auto shadowmap_size = 1024.f;
 		constexpr auto shadowmap_rows = shadowed_lights;
+
+		struct Light_uniform_ids {
+			Uniform_id pos;
+			Uniform_id dir;
+			Uniform_id angle;
+			Uniform_id color;
+			Uniform_id factors;
+			Uniform_id flat_position;
+			Uniform_id shadow;
+		};
+
+		// interned once, so the uniforms of the lights can be set without building their names
+		auto light_uniform_ids() -> const std::array<Light_uniform_ids, max_lights>& {
+			static const auto ids = [] {
+				auto ids = std::array<Light_uniform_ids, max_lights>{};
+				for(auto i=0u; i<ids.size(); i++) {
+					auto light = "light[" + std::to_string(i) + "].";
+					auto index = "[" + std::to_string(i) + "]";
+
+					ids[i].pos           = Uniform_id{(light+"pos").c_str()};
+					ids[i].dir           = Uniform_id{(light+"dir").c_str()};
+					ids[i].angle         = Uniform_id{(light+"angle").c_str()};
+					ids[i].color         = Uniform_id{(light+"color").c_str()};
+					ids[i].factors       = Uniform_id{(light+"factors").c_str()};
+					ids[i].flat_position = Uniform_id{("light_positions"+index).c_str()};
+					ids[i].shadow        = Uniform_id{("light_shadow"+index).c_str()};
+				}
+				return ids;
+			}();
+
+			return ids;
+		}
 	}
 
 	Light_system::Light_system(
@@ -44,7 +73,7 @@ namespace light {
 	             Rgba background_tint)
 	    : _mailbox(bus),
 	      _graphics_ctx(graphics_ctx),
-	      _lights(entity_manager.list<Light_comp>()),
+	      _entity_manager(entity_manager),
 	      _shadowcaster_queue(1),
 	      _shadowcaster_batch(_shadowcaster_shader, 64),
 	      _occlusion_map    {Framebuffer(shadowmap_size,shadowmap_size, false, false),
@@ -110,7 +139,7 @@ namespace light {
 
 	namespace {
 		void fill_with_relevant_lights(const renderer::Camera& camera,
-		                               Light_comp::Pool& lights,
+		                               ecs::Entity_manager& entity_manager,
 		                               std::array<Light_info, max_lights>& out) {
 			auto eye_pos = camera.eye_position();
 
@@ -121,9 +150,8 @@ namespace light {
 
 			auto index = 0;
 
-			for(Light_comp& light : lights) {
-				auto& trans = light.owner().get<physics::Transform_comp>().get_or_throw();
-
+			using physics::Transform_comp;
+			entity_manager.view<Light_comp, Transform_comp>().for_each([&](Light_comp& light, Transform_comp& trans) {
 				auto r = light.radius().value();
 				auto dist = glm::distance2(remove_units(trans.position()).xy(), eye_pos.xy());
 
@@ -149,16 +177,17 @@ namespace light {
 						min->shadowcaster = light.shadowcaster();
 					}
 				}
-			}
+			});
 
 			std::sort(out.begin(), out.end());
 		}
 
 		void bind_light_positions(renderer::Shader_program& prog, gsl::span<Light_info> lights) {
-#define SET_LIGHT_UNIFORM(I) prog.set_uniform("light_positions["#I"]", lights[I].flat_pos);\
-			                 prog.set_uniform("light_shadow["#I"]", lights[I].shadowcaster ? 1.f : 0.f);
-			M_REPEAT(NUM_LIGHTS_MACRO, SET_LIGHT_UNIFORM);
-#undef SET_LIGHT_UNIFORM
+			auto& ids = light_uniform_ids();
+			for(auto i=0u; i<ids.size(); i++) {
+				prog.set_uniform(ids[i].flat_position, lights[i].flat_pos);
+				prog.set_uniform(ids[i].shadow, lights[i].shadowcaster ? 1.f : 0.f);
+			}
 		}
 	}
 	void Light_system::prepare_draw(renderer::Command_queue& queue,
@@ -166,7 +195,7 @@ namespace light {
 	                                bool shadows) {
 
 		std::array<Light_info, max_lights> lights{};
-		fill_with_relevant_lights(camera, _lights, lights);
+		fill_with_relevant_lights(camera, _entity_manager, lights);
 
 		auto uniforms = queue.shared_uniforms();
 		_setup_uniforms(*uniforms, camera, lights);
@@ -273,22 +302,22 @@ namespace light {
 		};
 
 		// TODO: fade out light color, when they left the screen
-#define SET_LIGHT_UNIFORMS(N) \
-		if(lights[N].light) {\
-			uniforms.emplace("light["#N"].pos", remove_units(lights[N].transform->position())+lights[N].transform->resolve_relative(lights[N].light->offset()));\
-\
-			uniforms.emplace("light["#N"].dir", -lights[N].transform->rotation().value()\
-			                                               + lights[N].light->_direction.value());\
-\
-			uniforms.emplace("light["#N"].angle", process_angle(lights[N].light->_angle));\
-			uniforms.emplace("light["#N"].color", lights[N].light->color()); \
-			uniforms.emplace("light["#N"].factors", lights[N].light->_factors);\
-		} else {\
-			uniforms.emplace("light["#N"].color", glm::vec3(0,0,0));\
+		auto& ids = light_uniform_ids();
+		for(auto i=0u; i<ids.size(); i++) {
+			auto& l = lights[i];
+			if(l.light) {
+				uniforms.emplace(ids[i].pos, remove_units(l.transform->position())+l.transform->resolve_relative(l.light->offset()));
+
+				uniforms.emplace(ids[i].dir, -l.transform->rotation().value()
+				                             + l.light->_direction.value());
+
+				uniforms.emplace(ids[i].angle, process_angle(l.light->_angle));
+				uniforms.emplace(ids[i].color, l.light->color());
+				uniforms.emplace(ids[i].factors, l.light->_factors);
+			} else {
+				uniforms.emplace(ids[i].color, glm::vec3(0,0,0));
+			}
 		}
-
-		M_REPEAT(NUM_LIGHTS_MACRO, SET_LIGHT_UNIFORMS);
-#undef SET_LIGHT_UNIFORMS
 	}
 
 }
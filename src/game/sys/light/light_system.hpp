@@ -61,7 +61,7 @@ namespace light {
 		private:
 			util::Mailbox_collection _mailbox;
 			renderer::Graphics_ctx&  _graphics_ctx;
-			Light_comp::Pool& _lights;
+			ecs::Entity_manager&     _entity_manager;
 			renderer::Command_queue  _shadowcaster_queue;
 			renderer::Sprite_batch   _shadowcaster_batch;
 			renderer::Framebuffer    _occlusion_map[2];
@@ -0,0 +1,29 @@
+#include "parent_comp.hpp"
+
+#include <core/ecs/ecs.hpp>
+
+
+namespace lux {
+namespace sys {
+namespace physics {
+
+	void Parent_comp::parent(ecs::Entity_handle p) {
+		_parent = p;
+		mark_changed();
+	}
+	void Parent_comp::offset(Position o) {
+		_offset = o;
+		mark_changed();
+	}
+	void Parent_comp::rotation(Angle a) {
+		_rotation = a;
+		mark_changed();
+	}
+	void Parent_comp::scale(float s) {
+		_scale = s;
+		mark_changed();
+	}
+
+}
+}
+}
@@ -0,0 +1,61 @@
+/** Attaches an entity to the transformation of another one ******************
+ *                                                                           *
+ * Copyright (c) 2016 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#pragma once
+
+#include <core/ecs/component.hpp>
+#include <core/units.hpp>
+
+
+namespace lux {
+namespace sys {
+namespace physics {
+
+	class Transform_system;
+
+	/**
+	 * The Transform_comp of the owner follows the Transform_comp of the parent, with the given
+	 *   offset, rotation and scale relative to it (see Transform_system).
+	 * The parent handle is only valid for the running process, so attachments are not
+	 *   serialized and have to be created at runtime.
+	 */
+	class Parent_comp : public ecs::Component<Parent_comp> {
+		public:
+			static constexpr const char* name() {return "Parent";}
+
+			Parent_comp() = default;
+			Parent_comp(ecs::Entity_manager& manager, ecs::Entity_handle owner,
+			            ecs::Entity_handle parent=ecs::invalid_entity, Position offset={},
+			            Angle rotation=Angle{0}, float scale=1.f)noexcept
+			  : Component(manager, owner), _parent(parent), _offset(offset),
+			    _rotation(rotation), _scale(scale) {}
+
+			auto parent()const noexcept {return _parent;}
+			void parent(ecs::Entity_handle p);
+
+			auto offset()const noexcept {return _offset;}
+			void offset(Position o);
+
+			auto rotation()const noexcept {return _rotation;}
+			void rotation(Angle a);
+
+			auto scale()const noexcept {return _scale;}
+			void scale(float s);
+
+		private:
+			friend class Transform_system;
+
+			ecs::Entity_handle _parent;
+			Position _offset;
+			Angle _rotation {0};
+			float _scale = 1.f;
+			int32_t _node = -1; //< index in the node list of the Transform_system
+	};
+
+}
+}
+}
@@ -43,6 +43,43 @@ namespace physics {
 
 	sf2_enumDef(Body_shape, polygon, humanoid, circle)
 
+	namespace {
+		void read_definition(ecs::Binary_reader& state, Body_definition& def) {
+			state.read(def.active);
+			state.read(def.kinematic);
+			state.read(def.shape);
+			state.read(def.linear_damping);
+			state.read(def.angular_damping);
+			state.read(def.fixed_rotation);
+			state.read(def.bullet);
+			state.read(def.friction);
+			state.read(def.resitution);
+			state.read(def.density);
+			state.read(def.size);
+			state.read(def.sensor);
+			state.read(def.velocity);
+			state.read(def.keep_position_force);
+			state.read(def.vertices);
+		}
+		void write_definition(ecs::Binary_writer& state, const Body_definition& def) {
+			state.write(def.active);
+			state.write(def.kinematic);
+			state.write(def.shape);
+			state.write(def.linear_damping);
+			state.write(def.angular_damping);
+			state.write(def.fixed_rotation);
+			state.write(def.bullet);
+			state.write(def.friction);
+			state.write(def.resitution);
+			state.write(def.density);
+			state.write(def.size);
+			state.write(def.sensor);
+			state.write(def.velocity);
+			state.write(def.keep_position_force);
+			state.write(def.vertices);
+		}
+	}
+
 	namespace {
 		using body_ptr = std::unique_ptr<b2Body, void(*)(b2Body*)>;
 
@@ -222,9 +259,24 @@ namespace physics {
 		}
 		state.write(comp._def);
 	}
+	void load_component(ecs::Binary_reader& state, Dynamic_body_comp& comp) {
+		read_definition(state, comp._def);
+		comp._dirty = true;
+	}
+	void save_component(ecs::Binary_writer& state, const Dynamic_body_comp& comp) {
+		if(comp._body) {
+			auto vel = comp._body->GetLinearVelocity();
+			comp._def.velocity = glm::vec2{vel.x, vel.y};
+		}
+		write_definition(state, comp._def);
+	}
 	Dynamic_body_comp::Dynamic_body_comp(ecs::Entity_manager& manager, ecs::Entity_handle owner)
 	    : Component(manager,owner), _body(nullptr, +[](b2Body*){}) {
 	}
+	Dynamic_body_comp::Dynamic_body_comp(const Dynamic_body_comp& rhs)
+	    : Component(rhs), Soa_field(rhs), _def(rhs._def), _body(nullptr, +[](b2Body*){}),
+	      _size(rhs._size), _grounded(rhs._grounded), _ground_normal(rhs._ground_normal) {
+	}
 	void Dynamic_body_comp::_update_body(b2World& world) {
 		auto org_aabb = _body ? util::just(calc_aabb()) : util::nothing();
 
@@ -235,8 +287,9 @@ namespace physics {
 
 		velocity(_def.velocity);
 
-		_last_body_position = glm::vec2{_body->GetPosition().x, _body->GetPosition().y};
-		_initial_position = glm::vec2{_body->GetPosition().x, _body->GetPosition().y};
+		auto& data = soa_fields();
+		data.last_body_position = glm::vec2{_body->GetPosition().x, _body->GetPosition().y};
+		data.initial_position = data.last_body_position;
 
 		_dirty = false;
 
@@ -342,9 +395,19 @@ namespace physics {
 	void save_component(ecs::Serializer& state, const Static_body_comp& comp) {
 		state.write(comp._def);
 	}
+	void load_component(ecs::Binary_reader& state, Static_body_comp& comp) {
+		read_definition(state, comp._def);
+		comp._dirty = true;
+	}
+	void save_component(ecs::Binary_writer& state, const Static_body_comp& comp) {
+		write_definition(state, comp._def);
+	}
 	Static_body_comp::Static_body_comp(ecs::Entity_manager& manager, ecs::Entity_handle owner)
 	    : Component(manager,owner), _body(nullptr, +[](b2Body*b){}) {
 	}
+	Static_body_comp::Static_body_comp(const Static_body_comp& rhs)
+	    : Component(rhs), _def(rhs._def), _body(nullptr, +[](b2Body*){}) {
+	}
 	void Static_body_comp::_update_body(b2World& world) {
 		update_body(world, _body, _def, owner(), b2_staticBody);
 		_dirty = false;
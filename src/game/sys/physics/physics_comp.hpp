@@ -47,15 +47,29 @@ namespace physics {
 		std::vector<glm::vec2> vertices;
 	};
 
-	class Dynamic_body_comp : public ecs::Component<Dynamic_body_comp, ecs::Compact_index_policy,
-	                                                ecs::Pool_storage_policy<64, Dynamic_body_comp>> {
+	/// frequently accessed part of Dynamic_body_comp, stored in a separate array
+	struct Dynamic_body_data {
+		glm::vec2 last_body_position;
+		glm::vec2 initial_position;
+		uint_fast32_t transform_revision = 0;
+	};
+
+	class Dynamic_body_comp : public ecs::Component<Dynamic_body_comp, ecs::Paged_index_policy,
+	                                                ecs::Soa_storage_policy<64, Dynamic_body_comp, Dynamic_body_data>>,
+	                          public ecs::Soa_field<Dynamic_body_data> {
 		public:
 			static constexpr const char* name() {return "Dynamic_body";}
 			friend void load_component(ecs::Deserializer& state, Dynamic_body_comp&);
 			friend void save_component(ecs::Serializer& state, const Dynamic_body_comp&);
+			friend void load_component(ecs::Binary_reader& state, Dynamic_body_comp&);
+			friend void save_component(ecs::Binary_writer& state, const Dynamic_body_comp&);
 
 			Dynamic_body_comp() = default;
 			Dynamic_body_comp(ecs::Entity_manager& manager, ecs::Entity_handle owner);
+			/// copies the definition; the body is created by the next update
+			Dynamic_body_comp(const Dynamic_body_comp&);
+			Dynamic_body_comp(Dynamic_body_comp&&) = default;
+			Dynamic_body_comp& operator=(Dynamic_body_comp&&) = default;
 
 			void apply_force(glm::vec2 f);
 			void foot_friction(bool enable);//< only for humanoids
@@ -85,23 +99,26 @@ namespace physics {
 			glm::vec2 _size;
 			bool _grounded = true;
 			glm::vec2 _ground_normal{0,1};
-			glm::vec2 _last_body_position;
-			uint_fast32_t _transform_revision = 0;
-			glm::vec2 _initial_position;
 
 			void _update_body(b2World& world);
 			void _update_ground_info(Physics_system&);
 	};
 
-	class Static_body_comp : public ecs::Component<Static_body_comp, ecs::Compact_index_policy,
+	class Static_body_comp : public ecs::Component<Static_body_comp, ecs::Paged_index_policy,
 	                                               ecs::Pool_storage_policy<128, Static_body_comp>> {
 		public:
 			static constexpr const char* name() {return "Static_body";}
 			friend void load_component(ecs::Deserializer& state, Static_body_comp&);
 			friend void save_component(ecs::Serializer& state, const Static_body_comp&);
+			friend void load_component(ecs::Binary_reader& state, Static_body_comp&);
+			friend void save_component(ecs::Binary_writer& state, const Static_body_comp&);
 
 			Static_body_comp() = default;
 			Static_body_comp(ecs::Entity_manager& manager, ecs::Entity_handle owner);
+			/// copies the definition; the body is created by the next update
+			Static_body_comp(const Static_body_comp&);
+			Static_body_comp(Static_body_comp&&) = default;
+			Static_body_comp& operator=(Static_body_comp&&) = default;
 
 			void active(bool e) {_def.active = e;}
 
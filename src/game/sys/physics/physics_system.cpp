@@ -7,6 +7,8 @@
 #include <Box2D/Box2D.h>
 #include <glm/gtx/norm.hpp>
 
+#include <algorithm>
+#include <array>
 #include <unordered_set>
 
 
@@ -50,6 +52,59 @@ namespace physics {
 		constexpr auto position_iterations = 6;
 
 		constexpr auto max_depth_offset = 2.f;
+
+		/// calls f(comp, data) for all bodies; data is read sequentially from the Dynamic_body_data array
+		template<class F>
+		void for_each_body(Dynamic_body_comp::Pool& bodies, F&& f) {
+			auto& storage = bodies.storage();
+			auto& body_data = storage.fields<Dynamic_body_data>();
+
+			// the spans are whole chunks, that have the same length in both arrays
+			auto index = ecs::Component_index(0);
+			storage.for_each_span([&](auto begin, auto end) {
+				auto data = &body_data.get(index);
+				for(auto comp=begin; comp!=end; ++comp, ++data) {
+					f(*comp, *data);
+				}
+				index += static_cast<ecs::Component_index>(end-begin);
+			});
+		}
+
+		/// calls f(comp, data, transform) for all bodies whose entity has a transform;
+		///   the transforms are resolved in blocks, like in Entity_view
+		template<class F>
+		void for_each_body(Dynamic_body_comp::Pool& bodies, Transform_comp::Pool& transforms, F&& f) {
+			constexpr auto block_size = std::size_t(64);
+
+			auto& storage = bodies.storage();
+			auto& body_data = storage.fields<Dynamic_body_data>();
+
+			std::array<ecs::Entity_id, block_size> ids;
+			std::array<Transform_comp*, block_size> resolved;
+
+			auto index = ecs::Component_index(0);
+			storage.for_each_span([&](auto begin, auto end) {
+				auto data = &body_data.get(index);
+
+				for(auto block=begin; block!=end; ) {
+					auto count = std::min(block_size, static_cast<std::size_t>(end-block));
+					for(auto i=std::size_t(0); i<count; i++) {
+						ids[i] = block[i].owner_handle().id();
+					}
+					transforms.find_all(ids.data(), count, resolved.data());
+
+					for(auto i=std::size_t(0); i<count; i++) {
+						if(resolved[i]) {
+							f(block[i], data[i], *resolved[i]);
+						}
+					}
+					block += count;
+					data += count;
+				}
+
+				index += static_cast<ecs::Component_index>(end-begin);
+			});
+		}
 	}
 
 	struct Physics_system::Contact_listener : public b2ContactListener {
@@ -57,7 +112,7 @@ namespace physics {
 		util::Message_bus& bus;
 		std::unordered_map<Contact_key, int> _contacts;
 
-		Contact_listener(Engine& e) : bus(e.bus()) {}
+		Contact_listener(util::Message_bus& bus) : bus(bus) {}
 
 		void BeginContact(b2Contact* contact) override {
 			auto a = ecs::to_entity_handle(contact->GetFixtureA()->GetBody()->GetUserData());
@@ -95,9 +150,14 @@ namespace physics {
 	};
 
 	Physics_system::Physics_system(Engine& engine, ecs::Entity_manager& ecs)
-	    : _bodies_dynamic(ecs.list<Dynamic_body_comp>()),
+	    : Physics_system(engine.bus(), ecs) {
+	}
+	Physics_system::Physics_system(util::Message_bus& bus, ecs::Entity_manager& ecs)
+	    : _entity_manager(ecs),
+	      _bodies_dynamic(ecs.list<Dynamic_body_comp>()),
 	      _bodies_static(ecs.list<Static_body_comp>()),
-	      _listener(std::make_unique<Contact_listener>(engine)),
+	      _transforms(ecs.list<Transform_comp>()),
+	      _listener(std::make_unique<Contact_listener>(bus)),
 	      _world(std::make_unique<b2World>(b2Vec2{gravity_x,gravity_y})) {
 
 		_world->SetContactListener(_listener.get());
@@ -126,53 +186,62 @@ namespace physics {
 	}
 
 	void Physics_system::_get_positions() {
-		for(auto& comp : _bodies_dynamic) {
+		for_each_body(_bodies_dynamic, _transforms, [&](auto& comp, auto& data, auto& transform) {
 			if(!comp._body || comp._dirty) {
 				this->update_body_shape(comp);
 			}
 
-			auto& transform = comp.owner().get<Transform_comp>().get_or_throw();
 			auto pos = remove_units(transform.position());
 
 			auto active = comp._def.active && std::abs(pos.z) <= max_depth_offset;
 
-			if(transform.changed_since(comp._transform_revision) || comp._body->IsActive()!=active) {
-				comp._transform_revision = transform.revision();
+			if(transform.changed_since(data.transform_revision) || comp._body->IsActive()!=active) {
+				data.transform_revision = transform.revision();
 
 				auto rot = comp._def.fixed_rotation ? 0.f : transform.rotation().value();
 				comp._body->SetTransform(b2Vec2{pos.x, pos.y}, rot);
 				comp._body->SetActive(active);
-				comp._initial_position = pos.xy();
+				data.initial_position = pos.xy();
 			}
 
 			if(comp._def.keep_position_force>0.f) {
 				comp._body->ApplyForceToCenter(-1 * comp._body->GetMass() * _world->GetGravity(), true);
 			}
+		});
+
+		// static bodies only have to be updated if they or their transform changed
+		_bodies_static.for_each_changed(_static_bodies_synced, [&](auto& comp) {
+			_transforms.find(comp.owner_handle()).process([&](auto& transform) {
+				this->_update_static_body(comp, transform);
+			});
+		});
+		_transforms.for_each_changed(_static_bodies_synced, [&](auto& transform) {
+			_bodies_static.find(transform.owner_handle()).process([&](auto& comp) {
+				this->_update_static_body(comp, transform);
+			});
+		});
+		_static_bodies_synced = _entity_manager.change_frame();
+	}
+	void Physics_system::_update_static_body(Static_body_comp& comp, Transform_comp& transform) {
+		if(!comp._body || comp._dirty) {
+			update_body_shape(comp);
 		}
 
-		for(auto& comp : _bodies_static) {
-			if(!comp._body || comp._dirty) {
-				this->update_body_shape(comp);
-			}
-
-			auto& transform = comp.owner().get<Transform_comp>().get_or_throw();
-			if(transform.changed_since(comp._transform_revision)) {
-				comp._transform_revision = transform.revision();
+		if(transform.changed_since(comp._transform_revision)) {
+			comp._transform_revision = transform.revision();
 
-				auto& transform = comp.owner().get<Transform_comp>().get_or_throw();
-				auto pos = remove_units(transform.position());
-				comp._body->SetTransform(b2Vec2{pos.x, pos.y}, transform.rotation().value());
-				comp._body->SetActive(comp._def.active && std::abs(pos.z) <= max_depth_offset);
-			}
+			auto pos = remove_units(transform.position());
+			comp._body->SetTransform(b2Vec2{pos.x, pos.y}, transform.rotation().value());
+			comp._body->SetActive(comp._def.active && std::abs(pos.z) <= max_depth_offset);
 		}
 	}
 	void Physics_system::_reset_smooth_state() {
-		for(auto& comp : _bodies_dynamic) {
+		for_each_body(_bodies_dynamic, [&](auto& comp, auto& data) {
 			auto b2_pos = comp._body->GetPosition();
-			comp._last_body_position = glm::vec2{b2_pos.x, b2_pos.y};
+			data.last_body_position = glm::vec2{b2_pos.x, b2_pos.y};
 
 			if(comp._def.keep_position_force>0.f) {
-				auto diff = comp._last_body_position - comp._initial_position;
+				auto diff = data.last_body_position - data.initial_position;
 				auto diff_len = glm::length(diff);
 				if(diff_len>0.2f) {
 					diff/=diff_len;
@@ -180,24 +249,22 @@ namespace physics {
 					comp._body->ApplyLinearImpulse(b2Vec2{resp.x, resp.y}, comp._body->GetWorldCenter(), true);
 				}
 			}
-		}
+		});
 	}
 
 	void Physics_system::_smooth_positions(float alpha) {
-		for(Dynamic_body_comp& comp : _bodies_dynamic) {
-			auto& transform = comp.owner().get<Transform_comp>().get_or_throw();
-
+		for_each_body(_bodies_dynamic, _transforms, [&](auto& comp, auto& data, auto& transform) {
 			auto b2_pos = comp._body->GetPosition();
 			auto pos = glm::vec2{b2_pos.x, b2_pos.y};
-			pos = glm::mix(comp._last_body_position, pos, alpha);
+			pos = glm::mix(data.last_body_position, pos, alpha);
 			transform.position({pos.x*1_m, pos.y*1_m, transform.position().z});
 			if(!comp._def.fixed_rotation) {
 				transform.rotation(Angle{comp._body->GetAngle()});
 			}
 
-			comp._transform_revision = transform.revision();
+			data.transform_revision = transform.revision();
 			comp._update_ground_info(*this);
-		}
+		});
 	}
 
 	void Physics_system::update_body_shape(Dynamic_body_comp& comp) {
@@ -8,6 +8,7 @@
 #pragma once
 
 #include "physics_comp.hpp"
+#include "transform_comp.hpp"
 
 #include <core/utils/maybe.hpp>
 #include <core/engine.hpp>
@@ -48,6 +49,8 @@ namespace physics {
 	class Physics_system {
 		public:
 			Physics_system(Engine&, ecs::Entity_manager&);
+			/// without an Engine (e.g. for benchmarks); contacts and collisions are sent to the bus
+			Physics_system(util::Message_bus&, ecs::Entity_manager&);
 			~Physics_system();
 
 			void update(Time);
@@ -64,14 +67,18 @@ namespace physics {
 		private:
 			struct Contact_listener;
 
+			ecs::Entity_manager& _entity_manager;
 			Dynamic_body_comp::Pool& _bodies_dynamic;
 			Static_body_comp::Pool& _bodies_static;
+			Transform_comp::Pool& _transforms;
+			uint64_t _static_bodies_synced = 0; //< change frame of the last static body update
 
 			std::unique_ptr<Contact_listener> _listener;
 			std::unique_ptr<b2World> _world;
 			float _dt_acc = 0.f;
 
 			void _get_positions();
+			void _update_static_body(Static_body_comp&, Transform_comp&);
 			void _reset_smooth_state();
 			void _smooth_positions(float alpha);
 	};
@@ -0,0 +1,187 @@
+#include "spatial_index.hpp"
+
+#include <algorithm>
+
+
+namespace lux {
+namespace sys {
+namespace physics {
+
+	auto Aabb::intersect(glm::vec2 origin, glm::vec2 inv_dir, float max_distance)const noexcept -> float {
+		// slab test; inv_dir may contain infinities for axis aligned rays
+		auto t1 = (min - origin) * inv_dir;
+		auto t2 = (max - origin) * inv_dir;
+		auto t_min = glm::min(t1, t2);
+		auto t_max = glm::max(t1, t2);
+
+		auto enter = std::max(std::max(t_min.x, t_min.y), 0.f);
+		auto exit = std::min(std::min(t_max.x, t_max.y), max_distance);
+
+		return enter<=exit ? enter : -1.f;
+	}
+
+
+	Spatial_grid::Spatial_grid(float cell_size) : _cell_size(cell_size) {
+		INVARIANT(cell_size>0.f, "Invalid cell size for the Spatial_grid: "<<cell_size);
+	}
+
+	void Spatial_grid::update(ecs::Entity_handle entity, Aabb bounds, uint_fast32_t revision) {
+		auto idx = _find(entity);
+		if(idx<0) {
+			auto id = static_cast<std::size_t>(entity.id());
+			if(id >= _entry_by_id.size()) {
+				_entry_by_id.resize(std::max(id+1, _entry_by_id.size()*2), -1);
+			}
+
+			// replaces entries of previous entities with the same id
+			if(_entry_by_id[id]>=0) {
+				erase(_entries[static_cast<std::size_t>(_entry_by_id[id])].entity);
+			}
+
+			idx = static_cast<int32_t>(_entries.size());
+			_entries.emplace_back();
+			_entries.back().entity = entity;
+			_entry_by_id[id] = idx;
+
+		} else {
+			auto& entry = _entries[static_cast<std::size_t>(idx)];
+			entry.revision = revision;
+
+			auto cells = _cells_of(bounds);
+			if(!entry.oversized && cells.min_x==entry.cells.min_x && cells.min_y==entry.cells.min_y
+			   && cells.max_x==entry.cells.max_x && cells.max_y==entry.cells.max_y) {
+				entry.bounds = bounds; // still in the same cells
+				return;
+			}
+
+			_unlink(idx);
+		}
+
+		auto& entry = _entries[static_cast<std::size_t>(idx)];
+		entry.bounds = bounds;
+		entry.revision = revision;
+		_link(idx);
+	}
+
+	void Spatial_grid::erase(ecs::Entity_handle entity) {
+		auto idx = _find(entity);
+		if(idx<0)
+			return;
+
+		_unlink(idx);
+		_entry_by_id[static_cast<std::size_t>(entity.id())] = -1;
+
+		// move the last entry into the hole
+		auto last = static_cast<int32_t>(_entries.size()) - 1;
+		if(idx!=last) {
+			_relink(last, idx);
+			_entries[static_cast<std::size_t>(idx)] = _entries.back();
+			_entry_by_id[static_cast<std::size_t>(_entries[static_cast<std::size_t>(idx)].entity.id())] = idx;
+		}
+		_entries.pop_back();
+	}
+
+	void Spatial_grid::clear() {
+		_entries.clear();
+		_entry_by_id.clear();
+		_cells.clear();
+		_oversized.clear();
+	}
+
+	auto Spatial_grid::contains(ecs::Entity_handle entity)const -> bool {
+		return _find(entity)>=0;
+	}
+	auto Spatial_grid::revision(ecs::Entity_handle entity)const -> uint_fast32_t {
+		auto idx = _find(entity);
+		return idx>=0 ? _entries[static_cast<std::size_t>(idx)].revision : 0;
+	}
+
+	auto Spatial_grid::_cell(float v)const noexcept -> int32_t {
+		constexpr auto limit = float(std::numeric_limits<int32_t>::max() / 2);
+		return static_cast<int32_t>(glm::clamp(std::floor(v / _cell_size), -limit, limit));
+	}
+	auto Spatial_grid::_cells_of(const Aabb& bounds)const noexcept -> Cell_range {
+		return {_cell(bounds.min.x), _cell(bounds.min.y), _cell(bounds.max.x), _cell(bounds.max.y)};
+	}
+
+	auto Spatial_grid::_find(ecs::Entity_handle entity)const -> int32_t {
+		auto id = static_cast<std::size_t>(entity.id());
+		if(id >= _entry_by_id.size())
+			return -1;
+
+		auto idx = _entry_by_id[id];
+		return idx>=0 && _entries[static_cast<std::size_t>(idx)].entity==entity ? idx : -1;
+	}
+
+	void Spatial_grid::_link(int32_t entry_idx) {
+		auto& entry = _entries[static_cast<std::size_t>(entry_idx)];
+		entry.cells = _cells_of(entry.bounds);
+
+		auto cells = (int64_t(entry.cells.max_x)-entry.cells.min_x+1)
+		             * (int64_t(entry.cells.max_y)-entry.cells.min_y+1);
+		entry.oversized = cells > max_cells;
+
+		if(entry.oversized) {
+			_oversized.push_back(entry_idx);
+			return;
+		}
+
+		for(auto x=entry.cells.min_x; x<=entry.cells.max_x; x++) {
+			for(auto y=entry.cells.min_y; y<=entry.cells.max_y; y++) {
+				_cells[_key(x, y)].push_back(entry_idx);
+			}
+		}
+	}
+
+	void Spatial_grid::_unlink(int32_t entry_idx) {
+		auto remove = [&](std::vector<int32_t>& list) {
+			auto iter = std::find(list.begin(), list.end(), entry_idx);
+			if(iter!=list.end()) {
+				*iter = list.back();
+				list.pop_back();
+			}
+		};
+
+		auto& entry = _entries[static_cast<std::size_t>(entry_idx)];
+		if(entry.oversized) {
+			remove(_oversized);
+			return;
+		}
+
+		for(auto x=entry.cells.min_x; x<=entry.cells.max_x; x++) {
+			for(auto y=entry.cells.min_y; y<=entry.cells.max_y; y++) {
+				auto cell = _cells.find(_key(x, y));
+				if(cell!=_cells.end()) {
+					remove(cell->second);
+					if(cell->second.empty()) {
+						_cells.erase(cell);
+					}
+				}
+			}
+		}
+	}
+
+	void Spatial_grid::_relink(int32_t from, int32_t to) {
+		auto replace = [&](std::vector<int32_t>& list) {
+			std::replace(list.begin(), list.end(), from, to);
+		};
+
+		auto& entry = _entries[static_cast<std::size_t>(from)];
+		if(entry.oversized) {
+			replace(_oversized);
+			return;
+		}
+
+		for(auto x=entry.cells.min_x; x<=entry.cells.max_x; x++) {
+			for(auto y=entry.cells.min_y; y<=entry.cells.max_y; y++) {
+				auto cell = _cells.find(_key(x, y));
+				if(cell!=_cells.end()) {
+					replace(cell->second);
+				}
+			}
+		}
+	}
+
+}
+}
+}
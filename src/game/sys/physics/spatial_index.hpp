@@ -0,0 +1,397 @@
+/** Grid based index of the entities in an area *******************************
+ *                                                                           *
+ * Copyright (c) 2016 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#pragma once
+
+#include "transform_comp.hpp"
+
+#include <core/ecs/ecs.hpp>
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+
+namespace lux {
+namespace sys {
+namespace physics {
+
+	/// axis aligned bounding box in world space (in meters)
+	struct Aabb {
+		glm::vec2 min;
+		glm::vec2 max;
+
+		static auto around(glm::vec2 center, float half_extent) {
+			return Aabb{center - half_extent, center + half_extent};
+		}
+
+		auto overlaps(const Aabb& rhs)const noexcept {
+			return min.x<=rhs.max.x && rhs.min.x<=max.x && min.y<=rhs.max.y && rhs.min.y<=max.y;
+		}
+		/// squared distance between p and the closest point inside the box
+		auto distance2(glm::vec2 p)const noexcept {
+			auto d = glm::max(glm::max(min - p, p - max), glm::vec2{0.f, 0.f});
+			return d.x*d.x + d.y*d.y;
+		}
+		/// distance along the ray to the first intersection with the box or a negative value
+		auto intersect(glm::vec2 origin, glm::vec2 inv_dir, float max_distance)const noexcept -> float;
+	};
+
+	/**
+	 * Uniform hash grid of the bounding boxes of entities, that is used to find entities near
+	 *   a point without iterating over all of them.
+	 * Each entity is stored in all cells its box overlaps. Boxes that would cover more than
+	 *   max_cells cells are kept in a separate list, that is checked by every query.
+	 * The queries are broad-phase only, i.e. they report all entities whose box overlaps the
+	 *   queried region and the caller has to check the exact shapes.
+	 */
+	class Spatial_grid {
+		public:
+			static constexpr auto max_cells = 64;
+
+			explicit Spatial_grid(float cell_size=4.f);
+
+			/// inserts or moves the entity; revision is stored for the user (see revision())
+			void update(ecs::Entity_handle entity, Aabb bounds, uint_fast32_t revision=0);
+			void erase(ecs::Entity_handle entity);
+			void clear();
+
+			auto contains(ecs::Entity_handle entity)const -> bool;
+			auto revision(ecs::Entity_handle entity)const -> uint_fast32_t;
+			auto size()const noexcept {return _entries.size();}
+
+			/// calls f(Entity_handle) for every entity whose box overlaps the given one
+			template<class F>
+			void for_each_in_aabb(Aabb area, F&& f);
+
+			/// calls f(Entity_handle) for every entity whose box overlaps the given circle
+			template<class F>
+			void for_each_in_radius(glm::vec2 center, float radius, F&& f);
+
+			/// calls f(Entity_handle, distance:float) for every entity whose box is hit by the ray,
+			///   ordered by the cells along the ray (but not necessarily by distance)
+			template<class F>
+			void for_each_on_ray(glm::vec2 origin, glm::vec2 dir, float max_distance, F&& f);
+
+		private:
+			struct Cell_range {
+				int32_t min_x, min_y, max_x, max_y;
+			};
+			struct Entry {
+				ecs::Entity_handle entity;
+				Aabb bounds;
+				Cell_range cells;
+				bool oversized;
+				uint_fast32_t revision;
+				uint32_t query = 0; //< the last query that reported this entry
+			};
+
+			float _cell_size;
+			std::vector<Entry> _entries;
+			std::vector<int32_t> _entry_by_id; //< index into _entries or -1
+			std::unordered_map<uint64_t, std::vector<int32_t>> _cells; //< entry indices
+			std::vector<int32_t> _oversized;
+			uint32_t _query = 0;
+
+			auto _cell(float v)const noexcept -> int32_t;
+			auto _cells_of(const Aabb&)const noexcept -> Cell_range;
+			static auto _key(int32_t x, int32_t y)noexcept -> uint64_t {
+				return (uint64_t(uint32_t(x)) << 32) | uint64_t(uint32_t(y));
+			}
+			auto _find(ecs::Entity_handle entity)const -> int32_t;
+			void _link(int32_t entry_idx);
+			void _unlink(int32_t entry_idx);
+			void _relink(int32_t from, int32_t to);
+
+			/// calls f(Entry&) once for every entry in the cells of the range
+			template<class F>
+			void _for_each_entry(Cell_range range, F&& f);
+			template<class F>
+			void _visit(int32_t entry_idx, F& f);
+	};
+
+	/**
+	 * Spatial_grid of all entities with a component of type T and a Transform_comp.
+	 * The bounds are calculated by the passed function and updated incrementally for
+	 *   components that have been inserted or whose transformation has been modified since the
+	 *   last update() (see Component_container::for_each_changed and Transform_comp::revision).
+	 * Changes to T, that affect its bounds, have to be reported with Component::mark_changed.
+	 */
+	template<class T>
+	class Spatial_index {
+		public:
+			using Bounds_func = std::function<Aabb(const T&, const Transform_comp&)>;
+
+			Spatial_index(ecs::Entity_manager& manager, Bounds_func bounds, float cell_size=4.f);
+
+			/// NOT thread-safe
+			void update();
+
+			/// calls f(T&, Transform_comp&) for all components whose box overlaps the area
+			template<class F>
+			void for_each_in_aabb(Aabb area, F&& f);
+
+			/// calls f(T&, Transform_comp&) for all components whose box overlaps the circle
+			template<class F>
+			void for_each_in_radius(glm::vec2 center, float radius, F&& f);
+
+			/// calls f(T&, Transform_comp&, distance:float) for all components whose box is hit by the ray
+			template<class F>
+			void for_each_on_ray(glm::vec2 origin, glm::vec2 dir, float max_distance, F&& f);
+
+			auto grid()const noexcept -> const Spatial_grid& {return _grid;}
+
+		private:
+			ecs::Entity_manager& _manager;
+			typename T::Pool& _comps;
+			Transform_comp::Pool& _transforms;
+			Bounds_func _bounds;
+			Spatial_grid _grid;
+			std::vector<ecs::Entity_handle> _without_transform; //< not in the grid, until they get one
+			uint64_t _synced_frame = 0;
+
+			auto _update(T& comp) -> bool;
+			void _rebuild();
+
+			template<class F>
+			auto _resolve(F& f);
+	};
+
+
+	template<class F>
+	void Spatial_grid::_visit(int32_t entry_idx, F& f) {
+		auto& entry = _entries[static_cast<std::size_t>(entry_idx)];
+		if(entry.query!=_query) {
+			entry.query = _query;
+			f(entry);
+		}
+	}
+
+	template<class F>
+	void Spatial_grid::_for_each_entry(Cell_range range, F&& f) {
+		_query++;
+
+		for(auto i : _oversized) {
+			_visit(i, f);
+		}
+
+		// large areas are cheaper to check by iterating over all entries
+		auto cells = (int64_t(range.max_x)-range.min_x+1) * (int64_t(range.max_y)-range.min_y+1);
+		if(cells > int64_t(_cells.size())) {
+			for(auto i=0u; i<_entries.size(); i++) {
+				_visit(static_cast<int32_t>(i), f);
+			}
+			return;
+		}
+
+		for(auto x=range.min_x; x<=range.max_x; x++) {
+			for(auto y=range.min_y; y<=range.max_y; y++) {
+				auto cell = _cells.find(_key(x, y));
+				if(cell!=_cells.end()) {
+					for(auto i : cell->second) {
+						_visit(i, f);
+					}
+				}
+			}
+		}
+	}
+
+	template<class F>
+	void Spatial_grid::for_each_in_aabb(Aabb area, F&& f) {
+		_for_each_entry(_cells_of(area), [&](Entry& entry) {
+			if(entry.bounds.overlaps(area)) {
+				f(entry.entity);
+			}
+		});
+	}
+
+	template<class F>
+	void Spatial_grid::for_each_in_radius(glm::vec2 center, float radius, F&& f) {
+		_for_each_entry(_cells_of(Aabb::around(center, radius)), [&](Entry& entry) {
+			if(entry.bounds.distance2(center) <= radius*radius) {
+				f(entry.entity);
+			}
+		});
+	}
+
+	template<class F>
+	void Spatial_grid::for_each_on_ray(glm::vec2 origin, glm::vec2 dir, float max_distance, F&& f) {
+		auto len = glm::length(dir);
+		if(len<=0.f)
+			return;
+
+		dir /= len;
+		auto inv_dir = 1.f / dir;
+		auto check = [&](Entry& entry) {
+			auto dist = entry.bounds.intersect(origin, inv_dir, max_distance);
+			if(dist>=0.f) {
+				f(entry.entity, dist);
+			}
+		};
+
+		_query++;
+		for(auto i : _oversized) {
+			_visit(i, check);
+		}
+
+		auto x = _cell(origin.x);
+		auto y = _cell(origin.y);
+		auto end_x = _cell(origin.x + dir.x*max_distance);
+		auto end_y = _cell(origin.y + dir.y*max_distance);
+
+		auto steps = std::abs(int64_t(end_x)-x) + std::abs(int64_t(end_y)-y);
+		if(steps > int64_t(_cells.size())) {
+			for(auto i=0u; i<_entries.size(); i++) {
+				_visit(static_cast<int32_t>(i), check);
+			}
+			return;
+		}
+
+		// traverse the cells along the ray (Amanatides & Woo)
+		auto step_x = dir.x>0.f ? 1 : -1;
+		auto step_y = dir.y>0.f ? 1 : -1;
+
+		auto next_boundary = [&](int32_t cell, int32_t step) {
+			return static_cast<float>(step>0 ? cell+1 : cell) * _cell_size;
+		};
+		constexpr auto inf = std::numeric_limits<float>::infinity();
+		auto t_max_x = dir.x!=0.f ? (next_boundary(x, step_x) - origin.x) * inv_dir.x : inf;
+		auto t_max_y = dir.y!=0.f ? (next_boundary(y, step_y) - origin.y) * inv_dir.y : inf;
+		auto t_delta_x = dir.x!=0.f ? _cell_size * std::abs(inv_dir.x) : inf;
+		auto t_delta_y = dir.y!=0.f ? _cell_size * std::abs(inv_dir.y) : inf;
+
+		for(auto i=int64_t(0); i<=steps; i++) {
+			auto cell = _cells.find(_key(x, y));
+			if(cell!=_cells.end()) {
+				for(auto e : cell->second) {
+					_visit(e, check);
+				}
+			}
+
+			if(t_max_x < t_max_y) {
+				x += step_x;
+				t_max_x += t_delta_x;
+			} else {
+				y += step_y;
+				t_max_y += t_delta_y;
+			}
+		}
+	}
+
+
+	template<class T>
+	Spatial_index<T>::Spatial_index(ecs::Entity_manager& manager, Bounds_func bounds, float cell_size)
+	    : _manager(manager), _comps(manager.list<T>()), _transforms(manager.list<Transform_comp>()),
+	      _bounds(std::move(bounds)), _grid(cell_size) {
+	}
+
+	template<class T>
+	void Spatial_index<T>::update() {
+		// components or transforms have been removed
+		auto erase = [&](ecs::Entity_handle entity) {
+			if(_grid.contains(entity) && (!_comps.has(entity) || !_transforms.has(entity))) {
+				_grid.erase(entity);
+			}
+		};
+		if(!_comps.for_each_erased(_synced_frame, erase) || !_transforms.for_each_erased(_synced_frame, erase)) {
+			_rebuild();
+			_synced_frame = _manager.change_frame();
+			return;
+		}
+
+		// added since the last update, that might have got their transformation
+		auto without_transform = std::move(_without_transform);
+		_without_transform.clear();
+		for(auto entity : without_transform) {
+			_comps.find(entity).process([&](T& comp) {
+				_update(comp);
+			});
+		}
+
+		_comps.for_each_changed(_synced_frame, [&](T& comp) {
+			_update(comp);
+		});
+
+		_transforms.for_each_changed(_synced_frame, [&](Transform_comp& transform) {
+			auto entity = transform.owner_handle();
+			if(_grid.contains(entity) && _grid.revision(entity)!=transform.revision()) {
+				_comps.find(entity).process([&](T& comp) {
+					_grid.update(entity, _bounds(comp, transform), transform.revision());
+				});
+			}
+		});
+
+		// might have been added twice (changed while still waiting for a transformation)
+		std::sort(_without_transform.begin(), _without_transform.end());
+		_without_transform.erase(std::unique(_without_transform.begin(), _without_transform.end()),
+		                         _without_transform.end());
+
+		_synced_frame = _manager.change_frame();
+	}
+
+	template<class T>
+	auto Spatial_index<T>::_update(T& comp) -> bool {
+		auto entity = comp.owner_handle();
+		auto transform = _transforms.find(entity);
+		if(transform.is_nothing()) {
+			_grid.erase(entity);
+			_without_transform.push_back(entity);
+			return false;
+		}
+
+		auto& t = transform.get_or_throw();
+		_grid.update(entity, _bounds(comp, t), t.revision());
+		return true;
+	}
+
+	template<class T>
+	void Spatial_index<T>::_rebuild() {
+		_grid.clear();
+		_without_transform.clear();
+		for(auto& comp : _comps) {
+			_update(comp);
+		}
+	}
+
+	template<class T>
+	template<class F>
+	auto Spatial_index<T>::_resolve(F& f) {
+		return [&](ecs::Entity_handle entity, auto&&... args) {
+			auto comp = _comps.find(entity);
+			auto transform = _transforms.find(entity);
+			if(comp.is_some() && transform.is_some()) {
+				f(comp.get_or_throw(), transform.get_or_throw(), args...);
+			}
+		};
+	}
+
+	template<class T>
+	template<class F>
+	void Spatial_index<T>::for_each_in_aabb(Aabb area, F&& f) {
+		_grid.for_each_in_aabb(area, _resolve(f));
+	}
+
+	template<class T>
+	template<class F>
+	void Spatial_index<T>::for_each_in_radius(glm::vec2 center, float radius, F&& f) {
+		_grid.for_each_in_radius(center, radius, _resolve(f));
+	}
+
+	template<class T>
+	template<class F>
+	void Spatial_index<T>::for_each_on_ray(glm::vec2 origin, glm::vec2 dir, float max_distance, F&& f) {
+		_grid.for_each_on_ray(origin, dir, max_distance, _resolve(f));
+	}
+
+}
+}
+}
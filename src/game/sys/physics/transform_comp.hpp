@@ -17,25 +17,36 @@ namespace physics {
 
 	class Transform_system;
 
-	class Transform_comp : public ecs::Component<Transform_comp, ecs::Compact_index_policy,
-	                                             ecs::Pool_storage_policy<256, Transform_comp>> {
+	/// frequently accessed part of Transform_comp, stored in a separate array
+	struct Transform_data {
+		Position position;
+		Angle rotation;
+		float scale = 1.f;
+		uint_fast32_t revision = 1;
+	};
+
+	class Transform_comp : public ecs::Component<Transform_comp, ecs::Paged_index_policy,
+	                                             ecs::Soa_storage_policy<256, Transform_comp, Transform_data>>,
+	                       public ecs::Soa_field<Transform_data> {
 		public:
 			static constexpr auto name() {return "Transform";}
 			friend void load_component(ecs::Deserializer& state, Transform_comp&);
 			friend void save_component(ecs::Serializer& state, const Transform_comp&);
+			friend void load_component(ecs::Binary_reader& state, Transform_comp&);
+			friend void save_component(ecs::Binary_writer& state, const Transform_comp&);
 
 			Transform_comp() = default;
-			Transform_comp(ecs::Entity_manager& manager, ecs::Entity_handle owner)noexcept
+			Transform_comp(ecs::Entity_manager& manager, ecs::Entity_handle owner)
 			  : Component(manager, owner) {}
 
-			auto position()const noexcept {return _position;}
+			auto position()const noexcept {return soa_fields().position;}
 			void position(Position pos)noexcept;
 			void move(Position o)noexcept {position(position() + o);}
 
-			auto scale()const noexcept {return _scale;}
-			void scale(float s)noexcept {_scale = s;}
+			auto scale()const noexcept {return soa_fields().scale;}
+			void scale(float s)noexcept;
 
-			auto rotation()const noexcept {return _rotation;}
+			auto rotation()const noexcept {return soa_fields().rotation;}
 			void rotation(Angle a)noexcept;
 
 			auto flip_horizontal()const noexcept {return _flip_horizontal;}
@@ -43,8 +54,8 @@ namespace physics {
 			void flip_horizontal(bool f)noexcept;
 			void flip_vertical(bool f)noexcept;
 
-			auto changed_since(uint_fast32_t expected)const noexcept {return _revision!=expected;}
-			auto revision()const noexcept {return _revision;}
+			auto changed_since(uint_fast32_t expected)const noexcept {return soa_fields().revision!=expected;}
+			auto revision()const noexcept {return soa_fields().revision;}
 
 			auto resolve_relative(glm::vec3 offset)const -> glm::vec3;
 
@@ -52,13 +63,9 @@ namespace physics {
 			friend struct Persisted_state;
 
 		private:
-			Position _position;
-			float _scale = 1.f;
-			Angle _rotation;
 			bool _rotation_fixed = false;
 			bool _flip_horizontal = false;
 			bool _flip_vertical = false;
-			uint_fast32_t _revision = 1;
 	};
 
 }
@@ -8,10 +8,153 @@ namespace lux {
 namespace sys {
 namespace physics {
 
+	using namespace unit_literals;
+
 	Transform_system::Transform_system(
-			ecs::Entity_manager& entity_manager) {
+			ecs::Entity_manager& entity_manager)
+	    : _entity_manager(entity_manager),
+	      _transforms(entity_manager.list<Transform_comp>()),
+	      _parents(entity_manager.list<Parent_comp>()) {
 
 		entity_manager.register_component_type<physics::Transform_comp>();
+		entity_manager.register_component_type<physics::Parent_comp>();
+	}
+
+	void Transform_system::update(Time) {
+		if(_hierarchy_changed()) {
+			_rebuild();
+		}
+		_synced_frame = _entity_manager.change_frame();
+
+		for(auto& node : _nodes) {
+			auto parent = node.parent>=0 ? &_nodes[static_cast<std::size_t>(node.parent)] : nullptr;
+			if(parent && !parent->valid) {
+				node.valid = false;
+				continue;
+			}
+
+			auto transform_mb = _transforms.find(node.entity);
+			if(transform_mb.is_nothing()) {
+				node.valid = false;
+				continue;
+			}
+			auto& transform = transform_mb.get_or_throw();
+
+			node.changed = !node.valid || node.local_changed || transform.changed_since(node.revision)
+			               || (parent && parent->changed);
+			node.valid = true;
+			if(!node.changed)
+				continue;
+
+			if(parent) {
+				auto offset = node.local_offset * parent->scale;
+				if(parent->flip_horizontal)
+					offset.x *= -1.f;
+				if(parent->flip_vertical)
+					offset.y *= -1.f;
+
+				auto xy = glm::rotate(glm::vec2{offset.x, offset.y}, parent->rotation);
+				auto position = parent->position + glm::vec3{xy.x, xy.y, offset.z};
+
+				transform.position({position.x*1_m, position.y*1_m, position.z*1_m});
+				transform.rotation(Angle{parent->rotation + node.local_rotation});
+				transform.scale(parent->scale * node.local_scale);
+			}
+
+			node.position = remove_units(transform.position());
+			node.rotation = transform.rotation().value();
+			node.scale = transform.scale();
+			node.flip_horizontal = transform.flip_horizontal();
+			node.flip_vertical = transform.flip_vertical();
+			node.revision = transform.revision();
+			node.local_changed = false;
+		}
+	}
+
+	auto Transform_system::_hierarchy_changed() -> bool {
+		auto changed = _parents.structural_revision()!=_parents_revision;
+
+		_parents.for_each_changed(_synced_frame, [&](Parent_comp& comp) {
+			auto idx = static_cast<std::size_t>(comp._node);
+			if(comp._node<0 || idx>=_nodes.size() || _nodes[idx].entity!=comp.owner_handle()
+			   || _nodes[idx].parent_entity!=comp._parent) {
+				changed = true; // new attachment or moved to another parent
+				return;
+			}
+
+			auto& node = _nodes[idx];
+			node.local_offset = remove_units(comp._offset);
+			node.local_rotation = comp._rotation.value();
+			node.local_scale = comp._scale;
+			node.local_changed = true;
+		});
+
+		return changed;
+	}
+
+	void Transform_system::_rebuild() {
+		_nodes.clear();
+		_parents_revision = _parents.structural_revision();
+
+		// sorted by parent, so the children of an entity can be found by a binary search
+		auto attachments = std::vector<Parent_comp*>();
+		attachments.reserve(static_cast<std::size_t>(_parents.size()));
+		for(auto& comp : _parents) {
+			comp._node = -1;
+			if(comp._parent) {
+				attachments.push_back(&comp);
+			}
+		}
+		auto parent_less = [](const Parent_comp* lhs, const Parent_comp* rhs) {
+			return lhs->_parent.id() < rhs->_parent.id();
+		};
+		std::sort(attachments.begin(), attachments.end(), parent_less);
+
+		// roots are parents, that are not attached to another entity themselves
+		auto is_attached = [&](ecs::Entity_handle entity) {
+			return _parents.find(entity).process(false, [](auto& comp) {return bool(comp._parent);});
+		};
+		for(auto comp : attachments) {
+			auto parent = comp->_parent;
+			if((_nodes.empty() || _nodes.back().entity!=parent) && !is_attached(parent)) {
+				_nodes.emplace_back();
+				_nodes.back().entity = parent;
+			}
+		}
+		auto roots = _nodes.size();
+
+		// breadth-first traversal, so parents are updated before their children
+		for(auto i=0u; i<_nodes.size(); i++) {
+			auto entity = _nodes[i].entity;
+
+			auto key = Parent_comp{};
+			key._parent = entity;
+			auto range = std::equal_range(attachments.begin(), attachments.end(), &key, parent_less);
+
+			for(auto iter=range.first; iter!=range.second; iter++) {
+				auto& comp = **iter;
+				if(comp._parent!=entity)
+					continue; // refers to a previous entity with the same id
+
+				comp._node = static_cast<int32_t>(_nodes.size());
+
+				auto node = Node{};
+				node.entity = comp.owner_handle();
+				node.parent_entity = entity;
+				node.parent = static_cast<int32_t>(i);
+				node.local_offset = remove_units(comp._offset);
+				node.local_rotation = comp._rotation.value();
+				node.local_scale = comp._scale;
+				_nodes.push_back(node);
+			}
+		}
+
+		auto unreachable = attachments.size() - (_nodes.size() - roots);
+		if(unreachable>0) {
+			WARN(unreachable<<" entities are not attached to the scene graph, because their parents form a cycle");
+		}
+
+		DEBUG("Rebuilt scene graph with "<<roots<<" roots and "<<(_nodes.size()-roots)<<" children");
 	}
 
 }
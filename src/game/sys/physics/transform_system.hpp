@@ -16,17 +16,61 @@
 
 #include "../../../core/utils/template_utils.hpp"
 #include "transform_comp.hpp"
+#include "parent_comp.hpp"
 
 
 namespace lux {
 namespace sys {
 namespace physics {
 
+	/**
+	 * Propagates the transformations of parents (see Parent_comp) to their children.
+	 * The hierarchy is stored as a flat list of nodes, sorted by depth (parents before their
+	 *   children and siblings next to each other), that is only rebuilt if attachments are
+	 *   added, removed or moved to another parent.
+	 * Each node caches its world transformation, that is only recomputed if it or one of its
+	 *   ancestors has been modified since the last update.
+	 */
 	class Transform_system {
 		public:
 			Transform_system(ecs::Entity_manager& entity_manager);
 
-			void update(Time dt){}
+			void update(Time dt);
+
+		private:
+			struct Node {
+				ecs::Entity_handle entity;
+				ecs::Entity_handle parent_entity;
+				int32_t parent = -1; //< index of the parent node or -1 for roots
+
+				// the transformation relative to the parent
+				glm::vec3 local_offset;
+				float local_rotation = 0.f;
+				float local_scale = 1.f;
+
+				// cached world transformation
+				glm::vec3 position;
+				float rotation = 0.f;
+				float scale = 1.f;
+				bool flip_horizontal = false;
+				bool flip_vertical = false;
+				uint_fast32_t revision = 0; //< of the transform, when the cache has been updated
+
+				bool valid = false;   //< the entity (and all its ancestors) exists
+				bool changed = true;  //< the world transformation has been modified in this update
+				bool local_changed = true;
+			};
+
+			ecs::Entity_manager& _entity_manager;
+			Transform_comp::Pool& _transforms;
+			Parent_comp::Pool& _parents;
+
+			std::vector<Node> _nodes;
+			uint64_t _parents_revision = 0; //< structural revision of the Parent_comps at the last rebuild
+			uint64_t _synced_frame = 0;
+
+			auto _hierarchy_changed() -> bool;
+			void _rebuild();
 	};
 
 	using Scene_graph = Transform_system;
@@ -0,0 +1,82 @@
+/** merging Command_shards recorded by multiple threads **********************
+ *                                                                           *
+ * Copyright (c) 2016 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#include <core/renderer/command_queue.hpp>
+#include <core/utils/thread_pool.hpp>
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace lux;
+using namespace lux::renderer;
+
+namespace {
+	constexpr auto command_count = 20000;
+	constexpr auto rounds = 20;
+
+	// the commands are identified by their ext uniforms, because the queue never executes them
+	auto execution_order(Command_queue& queue) -> std::vector<const IUniform_map*> {
+		auto order = std::vector<const IUniform_map*>();
+		order.reserve(command_count);
+		queue.for_each_ordered([&](const Command& cmd) {
+			order.push_back(cmd.ext_uniforms());
+		});
+		return order;
+	}
+}
+
+int main() {
+	auto ids = std::vector<Cmd_uniform_map>(command_count);
+
+	auto rng = std::mt19937(42);
+	auto commands = std::vector<Command>();
+	commands.reserve(command_count);
+	for(auto i=0; i<command_count; i++) {
+		// shaders and textures would require a GL context, so the sort order is varied by the options
+		auto cmd = create_command().ext_uniforms(ids[i]);
+		if(rng()%2==0)
+			cmd.require_not(Gl_option::depth_write);
+		if(rng()%4==0)
+			cmd.require_not(Gl_option::blend);
+		if(rng()%3==0)
+			cmd.order_dependent();
+
+		commands.push_back(cmd);
+	}
+
+	auto expected = [&] {
+		Command_queue queue(command_count);
+		for(auto& cmd : commands) {
+			queue.push_back(cmd);
+		}
+		return execution_order(queue);
+	}();
+
+	util::Thread_pool thread_pool(4);
+	for(auto round=0; round<rounds; round++) {
+		Command_queue queue(command_count);
+
+		// the first and last commands are pushed directly, to check the ordering around the shards
+		queue.push_back(commands.front());
+		thread_pool.parallel_for(command_count-2, [&](auto begin, auto end) {
+			auto& shard = queue.shard(static_cast<std::size_t>(begin));
+			for(auto i=begin; i<end; i++) {
+				shard.push_back(commands[static_cast<std::size_t>(i+1)]);
+			}
+		});
+		queue.merge_shards();
+		queue.push_back(commands.back());
+
+		if(execution_order(queue)!=expected) {
+			std::cerr<<"Merged order differs from the recording order in round "<<round<<std::endl;
+			return 1;
+		}
+	}
+
+	std::cout<<"Merged order of "<<command_count<<" commands matches in "<<rounds<<" rounds"<<std::endl;
+}
@@ -0,0 +1,172 @@
+/** round trip of Entity_manager::snapshot and restore ***********************
+ *                                                                           *
+ * Copyright (c) 2016 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#include <core/asset/asset_manager.hpp>
+#include <core/ecs/ecs.hpp>
+#include <core/ecs/serializer.hpp>
+#include <core/utils/thread_pool.hpp>
+
+#include <glm/vec3.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace lux;
+
+namespace {
+	// stored as raw records
+	struct Binary_comp : ecs::Component<Binary_comp> {
+		static constexpr const char* name() {return "Test_binary";}
+
+		Binary_comp() = default;
+		Binary_comp(ecs::Entity_manager& manager, ecs::Entity_handle owner,
+		            int32_t value=0, glm::vec3 position={}, std::string tag={})
+		    : Component(manager, owner), value(value), position(position), tag(std::move(tag)) {}
+
+		int32_t value = 0;
+		glm::vec3 position;
+		std::string tag;
+
+		friend void load_component(ecs::Binary_reader& reader, Binary_comp& comp) {
+			reader.read(comp.value);
+			reader.read(comp.position);
+			reader.read(comp.tag);
+		}
+		friend void save_component(ecs::Binary_writer& writer, const Binary_comp& comp) {
+			writer.write(comp.value);
+			writer.write(comp.position);
+			writer.write(comp.tag);
+		}
+	};
+
+	// stored in the JSON fallback
+	struct Json_comp : ecs::Component<Json_comp> {
+		static constexpr const char* name() {return "Test_json";}
+
+		Json_comp() = default;
+		Json_comp(ecs::Entity_manager& manager, ecs::Entity_handle owner,
+		          float value=0.f, std::vector<int> list={})
+		    : Component(manager, owner), value(value), list(std::move(list)) {}
+
+		float value = 0.f;
+		std::vector<int> list;
+
+		friend void load_component(ecs::Deserializer& state, Json_comp& comp) {
+			state.read_virtual(
+				sf2::vmember("value", comp.value),
+				sf2::vmember("list", comp.list)
+			);
+		}
+		friend void save_component(ecs::Serializer& state, const Json_comp& comp) {
+			state.write_virtual(
+				sf2::vmember("value", comp.value),
+				sf2::vmember("list", comp.list)
+			);
+		}
+	};
+
+	using Binary_state = std::tuple<int32_t, float, float, float, std::string>;
+	using Json_state = std::tuple<float, std::vector<int>>;
+	using Entity_state = std::tuple<bool, Binary_state, bool, Json_state>;
+
+	// the state of all entities that own at least one of the components, independent of their handles
+	auto entity_states(ecs::Entity_manager& ecs) -> std::vector<Entity_state> {
+		auto owners = std::vector<ecs::Entity_facet>();
+		for(auto& comp : ecs.list<Binary_comp>())
+			owners.push_back(comp.owner());
+		for(auto& comp : ecs.list<Json_comp>()) {
+			if(!comp.owner().has<Binary_comp>())
+				owners.push_back(comp.owner());
+		}
+
+		auto states = std::vector<Entity_state>();
+		for(auto& entity : owners) {
+			auto state = Entity_state{};
+			entity.get<Binary_comp>().process([&](auto& comp) {
+				std::get<0>(state) = true;
+				std::get<1>(state) = Binary_state{comp.value, comp.position.x, comp.position.y,
+				                                  comp.position.z, comp.tag};
+			});
+			entity.get<Json_comp>().process([&](auto& comp) {
+				std::get<2>(state) = true;
+				std::get<3>(state) = Json_state{comp.value, comp.list};
+			});
+			states.push_back(state);
+		}
+
+		std::sort(states.begin(), states.end());
+		return states;
+	}
+
+	auto check(bool condition, const std::string& message) -> bool {
+		if(!condition) {
+			std::cerr<<"Failed: "<<message<<std::endl;
+		}
+		return condition;
+	}
+}
+
+int main(int argc, char** argv) {
+	asset::Asset_manager assets{argc>0 ? argv[0] : "", "BanishedBlaze_tests"};
+	util::Thread_pool thread_pool{0};
+	ecs::Entity_manager ecs{thread_pool, &assets};
+	ecs.register_component_type<Binary_comp>();
+	ecs.register_component_type<Json_comp>();
+
+	// binary only, JSON only, both and neither
+	auto handles = std::vector<ecs::Entity_handle>();
+	for(auto i=0; i<400; i++) {
+		auto entity = ecs.emplace();
+		if(i%4==0 || i%4==2) {
+			entity.emplace<Binary_comp>(i, glm::vec3{i*0.5f, -i*1.f, 2.f}, "entity "+std::to_string(i));
+		}
+		if(i%4==1 || i%4==2) {
+			entity.emplace<Json_comp>(i*0.25f, std::vector<int>{i, i+1, i*2});
+		}
+		handles.push_back(entity.handle());
+	}
+	ecs.process_queued_actions();
+	auto expected = entity_states(ecs);
+
+	auto snapshot = ecs.snapshot(handles);
+	auto ok = check(expected.size()==300, "entities with components before the snapshot");
+	ok &= check(snapshot.entities()==static_cast<int32_t>(handles.size()), "entity count of the snapshot");
+
+	// restored twice, to check that the snapshot isn't consumed
+	for(auto round=0; round<2; round++) {
+		ecs.clear();
+		ecs.restore(snapshot);
+		ecs.process_queued_actions();
+
+		ok &= check(entity_states(ecs)==expected, "restored entities differ (round "+std::to_string(round)+")");
+	}
+
+	// a single entity appended to an existing snapshot
+	auto single = ecs::Snapshot{};
+	auto source = ecs.emplace();
+	source.emplace<Binary_comp>(-7, glm::vec3{1.f, 2.f, 3.f}, "single");
+	source.emplace<Json_comp>(1.5f, std::vector<int>{3, 2, 1});
+	ecs.process_queued_actions();
+	ecs.snapshot(source.handle(), single);
+
+	ecs.clear();
+	ecs.restore(single);
+	ecs.process_queued_actions();
+	auto restored = entity_states(ecs);
+	ok &= check(restored.size()==1, "restored single entity");
+	ok &= check(!restored.empty() && restored[0]==Entity_state{true, Binary_state{-7, 1.f, 2.f, 3.f, "single"},
+	                                                            true, Json_state{1.5f, {3, 2, 1}}},
+	            "single entity state");
+
+	if(!ok)
+		return 1;
+
+	std::cout<<"Restored "<<handles.size()<<" entities from a snapshot of "<<snapshot.bytes()<<" bytes"<<std::endl;
+}
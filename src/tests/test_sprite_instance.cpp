@@ -0,0 +1,124 @@
+/** Sprite_instance records against the vertices of the Sprite_batch *********
+ *                                                                           *
+ * Copyright (c) 2016 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#include <core/renderer/sprite_batch.hpp>
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <iostream>
+#include <string>
+
+using namespace lux;
+using namespace lux::renderer;
+using namespace lux::unit_literals;
+
+namespace {
+	constexpr auto epsilon = 0.0001f;
+
+	struct Test_case {
+		std::string name;
+		Sprite sprite;
+		glm::vec4 texture_clip;
+		glm::vec2 texture_size;
+	};
+
+	auto create_sprite(Angle rotation, glm::vec4 uv) {
+		auto sprite = Sprite{};
+		sprite.position = {10.f, -4.f, 0.25f};
+		sprite.decals_offset = {0.5f, 0.25f};
+		sprite.rotation = rotation;
+		sprite.size = {3.f, 1.5f};
+		sprite.uv = uv;
+		sprite.hue_change = {0.1f, 0.7f};
+		sprite.shadow_resistence = 0.3f;
+		sprite.decals_intensity = 0.8f;
+		return sprite;
+	}
+
+	// the uv-rect as flipped by the Graphic_system
+	auto flip(glm::vec4 uv, bool vert, bool horiz) {
+		return glm::vec4 {
+			horiz ? uv.z : uv.x,
+			vert  ? uv.w : uv.y,
+			horiz ? uv.x : uv.z,
+			vert  ? uv.y : uv.w
+		};
+	}
+
+	auto check(bool condition, const std::string& message) -> bool {
+		if(!condition) {
+			std::cerr<<"Failed: "<<message<<std::endl;
+		}
+		return condition;
+	}
+	template<class T>
+	auto equal(T a, T b) {
+		return glm::all(glm::lessThanEqual(glm::abs(a-b), T(epsilon)));
+	}
+	auto equal(float a, float b) {
+		return std::abs(a-b) <= epsilon;
+	}
+
+	// rebuilds the vertex like sprite_instanced.vert and compares it with the Sprite_batch vertex
+	auto check_vertex(const std::string& name, const Sprite_instance& instance,
+	                  const Sprite_quad_vertex& quad, const Sprite_vertex& expected) -> bool {
+		auto tangent = glm::vec2{std::cos(instance.rotation), std::sin(instance.rotation)};
+		auto bitangent = glm::vec2{-tangent.y, tangent.x};
+		auto offset = quad.position * instance.size;
+		auto position = instance.position + glm::vec3{tangent*offset.x + bitangent*offset.y, 0.f};
+
+		auto ok = check(equal(position, expected.position), name+": position");
+		ok &= check(equal(tangent, expected.tangent), name+": tangent");
+		ok &= check(quad.uv==expected.uv, name+": uv");
+		ok &= check(equal(instance.uv_clip, expected.uv_clip), name+": uv_clip");
+		ok &= check(instance.decals_offset==expected.decals_offset, name+": decals_offset");
+		ok &= check(instance.hue_change==expected.hue_change, name+": hue_change");
+		ok &= check(instance.shadow_resistence==expected.shadow_resistence, name+": shadow_resistence");
+		ok &= check(instance.decals_intensity==expected.decals_intensity, name+": decals_intensity");
+		return ok;
+	}
+}
+
+int main() {
+	// a sub-rect of an atlas page
+	auto clip = glm::vec4{0.25f, 0.5f, 0.75f, 1.f};
+	auto size = glm::vec2{256.f, 128.f};
+	auto uv = glm::vec4{0.f, 0.25f, 0.5f, 0.75f};
+
+	auto cases = std::array<Test_case, 5> {{
+		{"unrotated",                  create_sprite(0_deg,    uv),                     {0,0,1,1}, size},
+		{"rotated",                    create_sprite(30_deg,   uv),                     {0,0,1,1}, size},
+		{"rotated+clipped",            create_sprite(-135_deg, uv),                     clip,      size},
+		{"flipped horizontal+clipped", create_sprite(0_deg,    flip(uv, false, true)), clip,      size},
+		{"rotated+flipped+clipped",    create_sprite(200_deg,  flip(uv, true, true)),  clip,      size}
+	}};
+
+	auto ok = true;
+	for(auto& c : cases) {
+		auto instance = pack_sprite_instance(c.sprite, c.texture_clip, c.texture_size);
+		auto vertices = std::array<Sprite_vertex, 6>{};
+		generate_sprite_vertices(c.sprite, c.texture_clip, c.texture_size, vertices.data());
+
+		ok &= check(sprite_unit_quad.size()==vertices.size(), c.name+": vertex count");
+		for(auto i=0u; i<vertices.size() && i<sprite_unit_quad.size(); i++) {
+			ok &= check_vertex(c.name+" vertex "+std::to_string(i), instance, sprite_unit_quad[i], vertices[i]);
+		}
+	}
+
+	// rescaled into the clip-rect and inset by half a texel, keeping the flip
+	auto flipped = calc_sprite_uv_clip(flip(uv, false, true), clip, size);
+	ok &= check(equal(flipped, glm::vec4{0.5f+0.5f/256.f, 0.625f+0.5f/128.f,
+	                                     0.25f-0.5f/256.f, 0.875f-0.5f/128.f}),
+	            "uv clip of a flipped sprite");
+
+	if(!ok) {
+		return 1;
+	}
+
+	std::cout<<"Sprite_instances of "<<cases.size()<<" sprites match the Sprite_batch vertices"<<std::endl;
+}